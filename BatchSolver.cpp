@@ -0,0 +1,444 @@
+#include"BatchSolver.h"
+
+#include<atomic>
+#include<chrono>
+#include<condition_variable>
+#include<memory>
+#include<mutex>
+#include<sstream>
+
+#include"WorkStealingPool.h"
+
+
+BatchSolver::BatchSolver()
+    : f_num_threads(1), f_output_order(OutputOrder::Input), f_output_format(BoardWriter::Format::Compact),
+      f_is_counting(false), f_max_solutions(2), f_stats_output(nullptr), f_cache(nullptr)
+{
+}
+
+SudokuBoard& BatchSolver::GetBoard()
+{
+    return f_board;
+}
+
+void BatchSolver::SetNumThreads(unsigned int p_num_threads)
+{
+    f_num_threads = p_num_threads;
+}
+
+void BatchSolver::SetOutputOrder(OutputOrder p_output_order)
+{
+    f_output_order = p_output_order;
+}
+
+void BatchSolver::SetOutputFormat(BoardWriter::Format p_output_format)
+{
+    f_output_format = p_output_format;
+}
+
+void BatchSolver::SetCounting(bool p_is_counting, unsigned long long p_max_solutions /*= 2*/)
+{
+    f_is_counting = p_is_counting;
+    f_max_solutions = p_max_solutions;
+}
+
+void BatchSolver::SetStatsOutput(std::ostream* p_stats_output)
+{
+    f_stats_output = p_stats_output;
+}
+
+void BatchSolver::SetCache(SolutionCache* p_cache)
+{
+    f_cache = p_cache;
+}
+
+bool BatchSolver::Run(std::istream& p_input, std::ostream& p_output, Summary& p_summary, std::string& p_error)
+{
+    PuzzleReader l_reader(p_input);
+
+    return Run(l_reader, p_output, p_summary, p_error);
+}
+
+/*
+* Notes:
+    (a). The boards only time their phases if the statistics are written; the workers' boards copy the setting.
+*/
+bool BatchSolver::Run(PuzzleReader& p_reader, std::ostream& p_output, Summary& p_summary, std::string& p_error)
+{
+    std::chrono::steady_clock::time_point l_start = std::chrono::steady_clock::now();
+
+    p_summary = Summary{ 0, 0, 0, 0, 0, 0, 0.0 };
+
+    // (a).
+    f_board.SetTiming(f_stats_output != nullptr);
+
+    if (f_num_threads == 1 && f_output_order == OutputOrder::Input)
+    { RunSequential(p_reader, p_output, p_summary); }
+    else
+    { RunParallel(p_reader, p_output, p_summary); }
+
+    p_output.flush();
+
+    if (f_stats_output != nullptr)
+    { f_stats_output->flush(); }
+
+    p_summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - l_start).count();
+
+    p_error = p_reader.GetError();
+
+    return p_error.empty();
+}
+
+/*
+* Notes:
+    (a). Solve fails for both invalid and unsolvable puzzles; IsValid is only called to tell them apart once the
+         (comparatively rare) failure has happened.
+*/
+BatchSolver::Outcome BatchSolver::WriteResult(std::string& p_text, SudokuBoard& p_board, SudokuBoard::Result p_result,
+                                              unsigned long long p_num_solutions /*= 0*/) const
+{
+    if (p_result == SudokuBoard::Result::OutOfBudget)
+    {
+        p_text += "budget exceeded\n";
+
+        return Outcome::OutOfBudget;
+    }
+
+    // (a).
+    if (p_result == SudokuBoard::Result::Unsolvable)
+    {
+        bool l_is_valid = p_board.IsValid();
+
+        p_text += l_is_valid ? "no solution\n" : "invalid\n";
+
+        return l_is_valid ? Outcome::Unsolvable : Outcome::Invalid;
+    }
+
+    if (p_num_solutions != 0)
+    {
+        p_text += std::to_string(p_num_solutions);
+        p_text += ' ';
+    }
+
+    BoardWriter::Render(p_text, p_board, f_output_format);
+
+    return Outcome::Solved;
+}
+
+
+/* Auxiliary of RunSequential, RunParallel
+
+* Notes:
+    (a). A count that was stopped by the budget is incomplete, even if it found solutions.
+*/
+SudokuBoard::Result BatchSolver::SolveBoard(SudokuBoard& p_board, CanonicalForm& p_form,
+                                            unsigned long long& p_num_solutions) const
+{
+    if (!f_is_counting)
+    {
+        p_num_solutions = 0;
+        return f_cache != nullptr ? f_cache->Solve(p_board, p_form) : p_board.TrySolve();
+    }
+
+    p_num_solutions = p_board.CountSolutions(f_max_solutions);
+
+    // (a).
+    if (p_board.GetBudget().GetLimitReached() != SearchBudget::Limit::None)
+    { return SudokuBoard::Result::OutOfBudget; }
+
+    return p_num_solutions != 0 ? SudokuBoard::Result::Solved : SudokuBoard::Result::Unsolvable;
+}
+
+/* Auxiliary of RunSequential, RunParallel
+*/
+void BatchSolver::WriteStats(std::ostream& p_output, unsigned long long p_id, Outcome p_outcome,
+                             unsigned long long p_num_solutions, const SolverStats& p_stats) const
+{
+    static const char* const s_names_outcomes[] = { "solved", "unsolvable", "invalid", "out_of_budget" };
+
+    p_output << "{ \"puzzle\": " << p_id << ", \"outcome\": \""
+             << s_names_outcomes[static_cast<unsigned int>(p_outcome)] << "\", ";
+
+    if (f_is_counting)
+    { p_output << "\"solutions\": " << p_num_solutions << ", "; }
+
+    p_stats.WriteJson(p_output);
+
+    p_output << " }\n";
+}
+
+/* Auxiliary of Run
+
+* Notes:
+    (a). The phases are timed one after the other: reading the puzzle, solving it (which the board times as its
+         validate and solve phases) and rendering its result. Writing the statistics isn't part of any phase.
+    (b). The results are gathered in l_text, which is written whenever it reaches S_SIZE_OUTPUT.
+*/
+void BatchSolver::RunSequential(PuzzleReader& p_reader, std::ostream& p_output, Summary& p_summary)
+{
+    // (a).
+    PhaseTimer l_timer(f_stats_output != nullptr);
+
+    // (b).
+    std::string l_text;
+    l_text.reserve(S_SIZE_OUTPUT + 4096);
+
+    CanonicalForm l_form;
+
+    while (p_reader.Read(f_board))
+    {
+        double l_seconds_parse = l_timer.Lap();
+
+        unsigned long long l_num_solutions;
+        SudokuBoard::Result l_result = SolveBoard(f_board, l_form, l_num_solutions);
+
+        l_timer.Lap();
+
+        Outcome l_outcome = WriteResult(l_text, f_board, l_result, l_num_solutions);
+
+        if (l_text.size() >= S_SIZE_OUTPUT)
+        {
+            p_output.write(l_text.data(), l_text.size());
+            l_text.clear();
+        }
+
+        switch (l_outcome)
+        {
+            case Outcome::Solved: ++p_summary.num_solved; break;
+            case Outcome::Unsolvable: ++p_summary.num_unsolvable; break;
+            case Outcome::Invalid: ++p_summary.num_invalid; break;
+            case Outcome::OutOfBudget: ++p_summary.num_out_of_budget; break;
+        }
+
+        if (l_num_solutions > 1)
+        { ++p_summary.num_multiple; }
+
+        ++p_summary.num_puzzles;
+
+        if (f_stats_output != nullptr)
+        {
+            SolverStats& l_stats = f_board.GetStats();
+
+            l_stats.seconds_parse = l_seconds_parse;
+            l_stats.seconds_print = l_timer.Lap();
+
+            WriteStats(*f_stats_output, p_summary.num_puzzles, l_outcome, l_num_solutions, l_stats);
+
+            l_timer.Lap();
+        }
+    }
+
+    p_output.write(l_text.data(), l_text.size());
+}
+
+/* Auxiliary of Run
+
+* Notes:
+    (a). The puzzles are read in blocks. Two blocks are in use at once, so that the next block is read (and its tasks
+         submitted) while the workers are solving the current one; the results of the current block are then written
+         once all of its tasks have finished.
+    (b). Each block is divided into small tasks, which the pool distributes among its workers. A worker that finishes
+         its own tasks steals those of the others, so a few slow puzzles don't leave the other workers idle.
+    (c). In completion order, each result is written as soon as it's known, under a mutex; otherwise the result is
+         stored in the block until the whole block can be written in order, in one call. The same goes for the
+         statistics.
+    (d). The puzzles are read, and so timed, on this thread; the rest of the phases are timed by the worker, as in
+         RunSequential.
+*/
+void BatchSolver::RunParallel(PuzzleReader& p_reader, std::ostream& p_output, Summary& p_summary)
+{
+    WorkStealingPool l_pool(f_num_threads);
+
+    // The board, canonical form (for the cache) and output buffers (for the results and the statistics) of each
+    // worker.
+    std::vector<std::unique_ptr<SudokuBoard>> l_boards;
+    std::vector<CanonicalForm> l_forms(l_pool.GetNumThreads());
+    std::vector<std::string> l_buffers(l_pool.GetNumThreads());
+    std::vector<std::unique_ptr<std::ostringstream>> l_buffers_stats;
+
+    for (unsigned int i = 0; i < l_pool.GetNumThreads(); ++i)
+    {
+        l_boards.emplace_back(new SudokuBoard());
+        l_boards.back()->CopySettings(f_board);
+        l_buffers_stats.emplace_back(new std::ostringstream());
+    }
+
+    // The results of a block in input order, gathered to be written in one call.
+    std::string l_text_block;
+
+    // The number of puzzles with each outcome (indexed by Outcome).
+    std::atomic<unsigned long long> l_num_outcomes[4] = { { 0 }, { 0 }, { 0 }, { 0 } };
+
+    // The number of puzzles with more than one solution (when counting).
+    std::atomic<unsigned long long> l_num_multiple(0);
+
+    // Guards p_output in completion order.
+    std::mutex l_mutex_output;
+
+    // (a).
+    struct Block
+    {
+        std::vector<Puzzle> puzzles;
+        std::vector<std::string> results;
+        std::vector<std::string> stats;
+        unsigned int size;
+        unsigned long long first_id;
+
+        std::atomic<unsigned int> num_unfinished;
+        std::mutex mutex;
+        std::condition_variable cv_finished;
+    };
+
+    Block l_blocks[2];
+
+    // Reads the next block of puzzles into p_block and submits its tasks; returns false if there were none.
+    auto l_read_and_submit = [&](Block& p_block) -> bool
+    {
+        p_block.puzzles.resize(S_SIZE_BLOCK);
+        p_block.results.resize(S_SIZE_BLOCK);
+        p_block.stats.resize(f_stats_output != nullptr ? S_SIZE_BLOCK : 0);
+        p_block.first_id = p_summary.num_puzzles + 1;
+        p_block.size = 0;
+
+        // (d).
+        PhaseTimer l_timer(f_stats_output != nullptr);
+
+        while (p_block.size < S_SIZE_BLOCK && p_reader.Read(f_board))
+        {
+            Puzzle& l_puzzle = p_block.puzzles[p_block.size++];
+
+            l_puzzle.seconds_parse = l_timer.Lap();
+
+            f_board.TakeSnapshot(l_puzzle.snapshot);
+
+            l_timer.Lap();
+        }
+
+        p_summary.num_puzzles += p_block.size;
+
+        if (p_block.size == 0)
+        { return false; }
+
+        p_block.num_unfinished = (p_block.size + S_SIZE_TASK - 1) / S_SIZE_TASK;
+
+        // (b).
+        for (unsigned int l_begin = 0; l_begin < p_block.size; l_begin += S_SIZE_TASK)
+        {
+            unsigned int l_end = std::min(l_begin + S_SIZE_TASK, p_block.size);
+
+            l_pool.Submit([&, l_begin, l_end](unsigned int p_worker)
+            {
+                SudokuBoard& l_board = *l_boards[p_worker];
+                std::string& l_buffer = l_buffers[p_worker];
+                std::ostringstream& l_buffer_stats = *l_buffers_stats[p_worker];
+
+                for (unsigned int i = l_begin; i < l_end; ++i)
+                {
+                    const Puzzle& l_puzzle = p_block.puzzles[i];
+
+                    l_board.RestoreSnapshot(l_puzzle.snapshot);
+
+                    l_buffer.clear();
+
+                    if (f_output_order == OutputOrder::Completion)
+                    {
+                        l_buffer += std::to_string(p_block.first_id + i);
+                        l_buffer += ' ';
+                    }
+
+                    unsigned long long l_num_solutions;
+                    SudokuBoard::Result l_result = SolveBoard(l_board, l_forms[p_worker], l_num_solutions);
+
+                    // (d).
+                    PhaseTimer l_timer_print(f_stats_output != nullptr);
+
+                    Outcome l_outcome = WriteResult(l_buffer, l_board, l_result, l_num_solutions);
+                    ++l_num_outcomes[static_cast<unsigned int>(l_outcome)];
+
+                    if (l_num_solutions > 1)
+                    { ++l_num_multiple; }
+
+                    if (f_stats_output != nullptr)
+                    {
+                        SolverStats& l_stats = l_board.GetStats();
+
+                        l_stats.seconds_parse = l_puzzle.seconds_parse;
+                        l_stats.seconds_print = l_timer_print.Lap();
+
+                        l_buffer_stats.str(std::string());
+                        WriteStats(l_buffer_stats, p_block.first_id + i, l_outcome, l_num_solutions, l_stats);
+                    }
+
+                    // (c).
+                    if (f_output_order == OutputOrder::Completion)
+                    {
+                        std::lock_guard<std::mutex> l_lock(l_mutex_output);
+                        p_output.write(l_buffer.data(), l_buffer.size());
+
+                        if (f_stats_output != nullptr)
+                        { *f_stats_output << l_buffer_stats.str(); }
+                    }
+                    else
+                    {
+                        p_block.results[i] = l_buffer;
+
+                        if (f_stats_output != nullptr)
+                        { p_block.stats[i] = l_buffer_stats.str(); }
+                    }
+
+                }
+
+                if (--p_block.num_unfinished == 0)
+                {
+                    std::lock_guard<std::mutex> l_lock(p_block.mutex);
+                    p_block.cv_finished.notify_all();
+                }
+            });
+        }
+
+        return true;
+    };
+
+    unsigned int l_current = 0;
+    bool l_has_current = l_read_and_submit(l_blocks[l_current]);
+
+    while (l_has_current)
+    {
+        bool l_has_next = l_read_and_submit(l_blocks[1 - l_current]);
+
+        Block& l_block = l_blocks[l_current];
+
+        {
+            std::unique_lock<std::mutex> l_lock(l_block.mutex);
+            l_block.cv_finished.wait(l_lock, [&]() { return l_block.num_unfinished == 0; });
+        }
+
+        if (f_output_order == OutputOrder::Input)
+        {
+            l_text_block.clear();
+
+            for (unsigned int i = 0; i < l_block.size; ++i)
+            {
+                l_text_block += l_block.results[i];
+            }
+
+            p_output.write(l_text_block.data(), l_text_block.size());
+
+            for (unsigned int i = 0; i < l_block.stats.size() && i < l_block.size; ++i)
+            {
+                *f_stats_output << l_block.stats[i];
+            }
+        }
+
+        l_current = 1 - l_current;
+        l_has_current = l_has_next;
+    }
+
+    l_pool.WaitIdle();
+
+    p_summary.num_solved = l_num_outcomes[static_cast<unsigned int>(Outcome::Solved)];
+    p_summary.num_unsolvable = l_num_outcomes[static_cast<unsigned int>(Outcome::Unsolvable)];
+    p_summary.num_invalid = l_num_outcomes[static_cast<unsigned int>(Outcome::Invalid)];
+    p_summary.num_out_of_budget = l_num_outcomes[static_cast<unsigned int>(Outcome::OutOfBudget)];
+    p_summary.num_multiple = l_num_multiple;
+}
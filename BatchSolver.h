@@ -0,0 +1,201 @@
+#pragma once
+
+#include<iostream>
+#include<string>
+#include<vector>
+
+#include"BoardWriter.h"
+#include"CanonicalForm.h"
+#include"SudokuBoard.h"
+#include"PuzzleReader.h"
+#include"SolutionCache.h"
+
+
+/*
+* Solves a sequence of puzzles read from one stream (see PuzzleReader for the accepted formats), writing one line of
+  output per puzzle, in the same order as the input:
+    - the solution in the one-line format (see PuzzleReader), if the puzzle was solved;
+    - "no solution", if the puzzle adheres to the rules of sudoku but cannot be solved;
+    - "invalid", if the puzzle's pre-filled cells violate the rules of sudoku;
+    - "budget exceeded", if the search was stopped by the budget of the board (see SudokuBoard::GetBudget), e.g. by
+      a time limit, so that one hard puzzle can't hold up a worker indefinitely.
+* For grids with more than 35 digits, which cannot be written in the one-line format, the values of the solution are
+  instead written on one line separated by spaces. The solutions can also be written in the other formats of
+  BoardWriter (see SetOutputFormat), in which case they take several lines each.
+* The results are gathered into large buffers, each written in one call; nothing is flushed until the end of Run.
+* The puzzles can be solved in parallel by a WorkStealingPool, in which case each worker thread has its own board.
+  The output is then either in the input order (the default) or in the order in which the puzzles are solved, in which
+  case each line is prefixed by the puzzle's number (starting from 1) and a space.
+* When counting (see SetCounting), the solution of a solved puzzle is preceded by its number of solutions (up to the
+  limit) and a space, and the solution is the first one found.
+* The statistics of each puzzle (see SolverStats) can also be written, as one JSON object per line, to a separate
+  stream (see SetStatsOutput); the lines are in the same order as the results.
+* The puzzles can be solved through a SolutionCache (see SetCache), so that repeated and equivalent puzzles are
+  answered without searching.
+*/
+class BatchSolver
+{
+
+public:
+
+    // The outcome of a puzzle.
+    enum class Outcome
+    {
+        Solved,
+        Unsolvable,
+        Invalid,
+        OutOfBudget
+    };
+
+    // The totals of a call to Run.
+    struct Summary
+    {
+        unsigned long long num_puzzles;
+        unsigned long long num_solved;
+        unsigned long long num_unsolvable;
+        unsigned long long num_invalid;
+        unsigned long long num_out_of_budget;
+
+        // The number of solved puzzles with more than one solution; only known when counting.
+        unsigned long long num_multiple;
+
+        // The wall-clock time taken by Run, in seconds.
+        double seconds;
+    };
+
+    // The order in which the results are written.
+    enum class OutputOrder
+    {
+        Input,
+        Completion
+    };
+
+
+private:
+
+    // The board that each puzzle is read into and, when solving on one thread, solved by; reused for every puzzle.
+    // When solving in parallel, the workers' boards copy its settings.
+    SudokuBoard f_board;
+
+    // The number of threads used to solve the puzzles (0 for one per hardware thread).
+    unsigned int f_num_threads;
+
+    // The order in which the results are written.
+    OutputOrder f_output_order;
+
+    // The format in which the solutions are written.
+    BoardWriter::Format f_output_format;
+
+    // Whether or not the solutions of each puzzle are counted, and the number at which the count stops.
+    bool f_is_counting;
+    unsigned long long f_max_solutions;
+
+    // The stream that the statistics of each puzzle are written to, or nullptr if they aren't.
+    std::ostream* f_stats_output;
+
+    // The cache that the puzzles are solved through, or nullptr if there's none.
+    SolutionCache* f_cache;
+
+    // A puzzle that has been read but not yet solved, and the time taken to read it (if the statistics are written).
+    struct Puzzle
+    {
+        SudokuBoard::Snapshot snapshot;
+        double seconds_parse;
+    };
+
+    // The number of puzzles that are read in one go when solving in parallel, and the number in each task.
+    static const unsigned int S_SIZE_BLOCK = 4096;
+    static const unsigned int S_SIZE_TASK = 8;
+
+    // The size that the results gathered by RunSequential reach before they're written.
+    static const std::size_t S_SIZE_OUTPUT = 1 << 16;
+
+
+public:
+
+    BatchSolver();
+
+    /*
+    * Returns the board used to solve the puzzles, so that its engine and settings can be configured.
+    */
+    SudokuBoard& GetBoard();
+
+    /*
+    * Sets the number of threads used to solve the puzzles (0 for one per hardware thread); the default is 1.
+    */
+    void SetNumThreads(unsigned int p_num_threads);
+
+    /*
+    * Sets the order in which the results are written; the default is OutputOrder::Input.
+    */
+    void SetOutputOrder(OutputOrder p_output_order);
+
+    /*
+    * Sets the format in which the solutions are written; the default is BoardWriter::Format::Compact.
+    */
+    void SetOutputFormat(BoardWriter::Format p_output_format);
+
+    /*
+    * Sets whether or not the solutions of each puzzle are counted, stopping at p_max_solutions (0 for no limit; see
+      SudokuBoard::CountSolutions); the default limit of 2 checks whether each solution is unique. Off by default.
+    */
+    void SetCounting(bool p_is_counting, unsigned long long p_max_solutions = 2);
+
+    /*
+    * Sets the stream that the statistics of each puzzle are written to (nullptr, the default, for none). Each line is
+      a JSON object with the puzzle's number (starting from 1), its outcome ("solved", "unsolvable", "invalid" or
+      "out_of_budget"), its number of solutions when counting, and the members written by SolverStats::WriteJson, all
+      four phases being timed.
+    */
+    void SetStatsOutput(std::ostream* p_stats_output);
+
+    /*
+    * Sets the cache that the puzzles are solved through (nullptr, the default, for none); it isn't used when counting.
+      The cache is shared by the threads, and its entries are kept after Run, e.g. to be saved.
+    */
+    void SetCache(SolutionCache* p_cache);
+
+    /*
+    * Solves every puzzle of p_input, writing the results to p_output, and assigns the totals to p_summary.
+    * Returns false if the input is malformed, in which case p_error describes the problem; the puzzles before the
+      malformed one are still solved and counted.
+    */
+    bool Run(std::istream& p_input, std::ostream& p_output, Summary& p_summary, std::string& p_error);
+
+    /*
+    * As above, but reads the puzzles with p_reader (e.g. one that has opened a file; see PuzzleReader::Open).
+    */
+    bool Run(PuzzleReader& p_reader, std::ostream& p_output, Summary& p_summary, std::string& p_error);
+
+    /*
+    * Appends the output for p_board (see the class comment) to p_text, where p_result is the result of
+      p_board.TrySolve(). If p_num_solutions isn't 0, it's written before the solution, as it is when counting.
+    * Returns the outcome that was written.
+    */
+    Outcome WriteResult(std::string& p_text, SudokuBoard& p_board, SudokuBoard::Result p_result,
+                        unsigned long long p_num_solutions = 0) const;
+
+
+private:
+
+    /* Auxiliary of RunSequential, RunParallel
+    * Solves p_board (through the cache, if there's one, with p_form computing its canonical form) or, when counting,
+      counts its solutions (assigning the count to p_num_solutions; otherwise it's 0). Returns the result, as
+      SudokuBoard::TrySolve does.
+    */
+    SudokuBoard::Result SolveBoard(SudokuBoard& p_board, CanonicalForm& p_form,
+                                   unsigned long long& p_num_solutions) const;
+
+    /* Auxiliary of RunSequential, RunParallel
+    * Writes the line of statistics of the puzzle numbered p_id (see SetStatsOutput) to p_output.
+    */
+    void WriteStats(std::ostream& p_output, unsigned long long p_id, Outcome p_outcome,
+                    unsigned long long p_num_solutions, const SolverStats& p_stats) const;
+
+    /* Auxiliary of Run
+    * Solve the puzzles on the calling thread, or on the threads of a WorkStealingPool, respectively.
+    */
+    void RunSequential(PuzzleReader& p_reader, std::ostream& p_output, Summary& p_summary);
+    void RunParallel(PuzzleReader& p_reader, std::ostream& p_output, Summary& p_summary);
+
+};
@@ -0,0 +1,285 @@
+#pragma once
+
+#if defined(_MSC_VER)
+#include<intrin.h>
+#endif
+
+
+/*
+* Small helpers for working with the bitmasks that the solver uses to represent sets of digits.
+* Bit (d - 1) of a mask corresponds to the digit d, so a mask of the digits 1 to N is (1 << N) - 1.
+*/
+
+/*
+* Returns the number of bits that are set in p_mask.
+*/
+inline unsigned int CountBits(unsigned long long p_mask)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<unsigned int>(__popcnt64(p_mask));
+#elif defined(_MSC_VER)
+    unsigned int l_count = 0;
+    for (; p_mask != 0; p_mask &= p_mask - 1)
+    { ++l_count; }
+    return l_count;
+#else
+    return static_cast<unsigned int>(__builtin_popcountll(p_mask));
+#endif
+}
+
+/*
+* Returns the index of the lowest bit that is set in p_mask.
+* p_mask must not be 0.
+*/
+inline unsigned int IndexLowestBit(unsigned long long p_mask)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long l_index;
+    _BitScanForward64(&l_index, p_mask);
+    return static_cast<unsigned int>(l_index);
+#elif defined(_MSC_VER)
+    unsigned int l_index = 0;
+    for (; (p_mask & 1) == 0; p_mask >>= 1)
+    { ++l_index; }
+    return l_index;
+#else
+    return static_cast<unsigned int>(__builtin_ctzll(p_mask));
+#endif
+}
+
+/*
+* Returns a mask in which the lowest p_num_bits bits are set.
+*/
+constexpr unsigned long long MaskOfLowestBits(unsigned int p_num_bits)
+{
+    return p_num_bits >= 64 ? ~0ULL : (1ULL << p_num_bits) - 1;
+}
+
+/*
+* A mask of N * 64 bits, for sets of more digits than an unsigned long long can hold; word i holds bits 64 * i to
+  64 * i + 63.
+* It behaves as an unsigned integer of that width under the bitwise operators, the shifts, addition and subtraction
+  (all modulo 2^(64 * N)), and it's true in a condition if any of its bits are set; so the idioms used with unsigned
+  long long masks carry over, e.g. m & (m - 1) clears the lowest bit of m and m & (~m + 1) keeps only that bit.
+*/
+template <unsigned int N>
+class WideMask
+{
+
+private:
+
+    unsigned long long f_words[N];
+
+
+public:
+
+    WideMask()
+        : WideMask(0)
+    {
+    }
+
+    /*
+    * Creates the mask whose lowest 64 bits are those of p_word; implicit, as for an integer, so that e.g. a mask can
+      be compared with 0.
+    */
+    WideMask(unsigned long long p_word)
+    {
+        f_words[0] = p_word;
+
+        for (unsigned int i = 1; i < N; ++i)
+        {
+            f_words[i] = 0;
+        }
+
+    }
+
+    unsigned long long GetWord(unsigned int p_index) const
+    {
+        return f_words[p_index];
+    }
+
+    explicit operator bool() const
+    {
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            if (f_words[i] != 0)
+            { return true; }
+        }
+
+        return false;
+    }
+
+    WideMask operator~() const
+    {
+        WideMask l_result;
+
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            l_result.f_words[i] = ~f_words[i];
+        }
+
+        return l_result;
+    }
+
+    WideMask& operator&=(const WideMask& p_other)
+    {
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            f_words[i] &= p_other.f_words[i];
+        }
+
+        return *this;
+    }
+
+    WideMask& operator|=(const WideMask& p_other)
+    {
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            f_words[i] |= p_other.f_words[i];
+        }
+
+        return *this;
+    }
+
+    WideMask& operator^=(const WideMask& p_other)
+    {
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            f_words[i] ^= p_other.f_words[i];
+        }
+
+        return *this;
+    }
+
+    /*
+    * Notes:
+        (a). A word carries into the next if the sum wrapped around, i.e. came out less than the word added.
+    */
+    WideMask& operator+=(const WideMask& p_other)
+    {
+        unsigned long long l_carry = 0;
+
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            unsigned long long l_sum = f_words[i] + p_other.f_words[i];
+            unsigned long long l_carry_next = l_sum < f_words[i];
+
+            // (a).
+            f_words[i] = l_sum + l_carry;
+            l_carry = l_carry_next | (f_words[i] < l_carry);
+        }
+
+        return *this;
+    }
+
+    /*
+    * Notes:
+        (a). A word borrows from the next if the word subtracted (plus any borrow) is greater than it.
+    */
+    WideMask& operator-=(const WideMask& p_other)
+    {
+        unsigned long long l_borrow = 0;
+
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            unsigned long long l_difference = f_words[i] - p_other.f_words[i];
+            unsigned long long l_borrow_next = f_words[i] < p_other.f_words[i];
+
+            // (a).
+            l_borrow_next |= l_difference < l_borrow;
+            f_words[i] = l_difference - l_borrow;
+            l_borrow = l_borrow_next;
+        }
+
+        return *this;
+    }
+
+    /*
+    * Notes:
+        (a). Bits shifted past either end are lost; shifting by the width of the mask or more leaves it 0.
+    */
+    WideMask operator<<(unsigned int p_shift) const
+    {
+        WideMask l_result;
+        unsigned int l_words = p_shift / 64;
+        unsigned int l_bits = p_shift % 64;
+
+        // (a).
+        for (unsigned int i = N; i-- > l_words; )
+        {
+            l_result.f_words[i] = f_words[i - l_words] << l_bits;
+
+            if (l_bits != 0 && i > l_words)
+            { l_result.f_words[i] |= f_words[i - l_words - 1] >> (64 - l_bits); }
+        }
+
+        return l_result;
+    }
+
+    WideMask operator>>(unsigned int p_shift) const
+    {
+        WideMask l_result;
+        unsigned int l_words = p_shift / 64;
+        unsigned int l_bits = p_shift % 64;
+
+        for (unsigned int i = 0; i + l_words < N; ++i)
+        {
+            l_result.f_words[i] = f_words[i + l_words] >> l_bits;
+
+            if (l_bits != 0 && i + l_words + 1 < N)
+            { l_result.f_words[i] |= f_words[i + l_words + 1] << (64 - l_bits); }
+        }
+
+        return l_result;
+    }
+
+    friend WideMask operator&(WideMask p_left, const WideMask& p_right) { return p_left &= p_right; }
+    friend WideMask operator|(WideMask p_left, const WideMask& p_right) { return p_left |= p_right; }
+    friend WideMask operator^(WideMask p_left, const WideMask& p_right) { return p_left ^= p_right; }
+    friend WideMask operator+(WideMask p_left, const WideMask& p_right) { return p_left += p_right; }
+    friend WideMask operator-(WideMask p_left, const WideMask& p_right) { return p_left -= p_right; }
+
+    friend bool operator==(const WideMask& p_left, const WideMask& p_right)
+    {
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            if (p_left.f_words[i] != p_right.f_words[i])
+            { return false; }
+        }
+
+        return true;
+    }
+
+    friend bool operator!=(const WideMask& p_left, const WideMask& p_right)
+    {
+        return !(p_left == p_right);
+    }
+
+};
+
+/*
+* As above, for a WideMask.
+*/
+template <unsigned int N>
+inline unsigned int CountBits(const WideMask<N>& p_mask)
+{
+    unsigned int l_count = 0;
+
+    for (unsigned int i = 0; i < N; ++i)
+    {
+        l_count += CountBits(p_mask.GetWord(i));
+    }
+
+    return l_count;
+}
+
+template <unsigned int N>
+inline unsigned int IndexLowestBit(const WideMask<N>& p_mask)
+{
+    unsigned int i = 0;
+
+    while (p_mask.GetWord(i) == 0)
+    { ++i; }
+
+    return 64 * i + IndexLowestBit(p_mask.GetWord(i));
+}
@@ -0,0 +1,401 @@
+#include"BitboardKernel.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BITBOARD_KERNEL_X86
+#endif
+
+
+#ifdef BITBOARD_KERNEL_X86
+
+#include<immintrin.h>
+
+// The kernels' bodies aren't compiled for any particular instruction set (see the notes of the wrappers below), so
+// the compiler would warn that they exchange AVX registers with the operations that they call; in fact, every such
+// call is inlined into a wrapper that's compiled for AVX2.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/*
+* The operations that the kernels need on a row of 16 16-bit lanes, for each instruction set. A lane that's 'set' is
+  0xFFFF, as produced by the comparisons.
+*/
+
+// A lane is set in the element i of S_LANES_FIRST + 16 - n if i < n.
+static const unsigned short S_LANES_FIRST[32] =
+{
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+#define BITBOARD_AVX2 __attribute__((target("avx2")))
+#define BITBOARD_SSE41 __attribute__((target("sse4.1")))
+
+struct Avx2Ops
+{
+    typedef __m256i Row;
+
+    BITBOARD_AVX2 static inline Row Zero()
+    { return _mm256_setzero_si256(); }
+
+    BITBOARD_AVX2 static inline Row Load(const unsigned short* p_lanes)
+    { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_lanes)); }
+
+    // The lanes of the bytes that are 0 are set.
+    BITBOARD_AVX2 static inline Row LoadIsZero(const unsigned char* p_bytes)
+    {
+        __m128i l_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_bytes));
+        return _mm256_cvtepi8_epi16(_mm_cmpeq_epi8(l_bytes, _mm_setzero_si128()));
+    }
+
+    BITBOARD_AVX2 static inline void Store(unsigned short* p_lanes, Row p_row)
+    { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p_lanes), p_row); }
+
+    BITBOARD_AVX2 static inline Row And(Row p_a, Row p_b)
+    { return _mm256_and_si256(p_a, p_b); }
+
+    BITBOARD_AVX2 static inline Row Or(Row p_a, Row p_b)
+    { return _mm256_or_si256(p_a, p_b); }
+
+    // ~p_a & p_b
+    BITBOARD_AVX2 static inline Row AndNot(Row p_a, Row p_b)
+    { return _mm256_andnot_si256(p_a, p_b); }
+
+    BITBOARD_AVX2 static inline Row Decrement(Row p_row)
+    { return _mm256_sub_epi16(p_row, _mm256_set1_epi16(1)); }
+
+    BITBOARD_AVX2 static inline Row IsZero(Row p_row)
+    { return _mm256_cmpeq_epi16(p_row, _mm256_setzero_si256()); }
+
+    BITBOARD_AVX2 static inline bool IsAllZero(Row p_row)
+    { return _mm256_testz_si256(p_row, p_row) != 0; }
+
+    // Lane i of the result is lane i + K of p_row (or 0).
+    template <int K>
+    BITBOARD_AVX2 static inline Row ShiftLanes(Row p_row)
+    {
+        Row l_high = _mm256_permute2x128_si256(p_row, p_row, 0x81);
+        return K == 8 ? l_high : _mm256_alignr_epi8(l_high, p_row, (2 * K) & 15);
+    }
+
+    BITBOARD_AVX2 static inline unsigned short FirstLane(Row p_row)
+    { return static_cast<unsigned short>(_mm256_extract_epi16(p_row, 0)); }
+
+    // Bit i of the result is set if lane i is set.
+    BITBOARD_AVX2 static inline unsigned short ToBits(Row p_row)
+    {
+        __m256i l_bytes = _mm256_permute4x64_epi64(_mm256_packs_epi16(p_row, _mm256_setzero_si256()), 0x08);
+        return static_cast<unsigned short>(_mm256_movemask_epi8(l_bytes));
+    }
+};
+
+struct Sse41Ops
+{
+    // Lanes 0 to 7, and lanes 8 to 15.
+    struct Row
+    {
+        __m128i low;
+        __m128i high;
+    };
+
+    BITBOARD_SSE41 static inline Row Zero()
+    { return Row{ _mm_setzero_si128(), _mm_setzero_si128() }; }
+
+    BITBOARD_SSE41 static inline Row Load(const unsigned short* p_lanes)
+    {
+        return Row{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_lanes)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_lanes + 8)) };
+    }
+
+    BITBOARD_SSE41 static inline Row LoadIsZero(const unsigned char* p_bytes)
+    {
+        __m128i l_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_bytes));
+        __m128i l_is_zero = _mm_cmpeq_epi8(l_bytes, _mm_setzero_si128());
+        return Row{ _mm_cvtepi8_epi16(l_is_zero), _mm_cvtepi8_epi16(_mm_srli_si128(l_is_zero, 8)) };
+    }
+
+    BITBOARD_SSE41 static inline void Store(unsigned short* p_lanes, Row p_row)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p_lanes), p_row.low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p_lanes + 8), p_row.high);
+    }
+
+    BITBOARD_SSE41 static inline Row And(Row p_a, Row p_b)
+    { return Row{ _mm_and_si128(p_a.low, p_b.low), _mm_and_si128(p_a.high, p_b.high) }; }
+
+    BITBOARD_SSE41 static inline Row Or(Row p_a, Row p_b)
+    { return Row{ _mm_or_si128(p_a.low, p_b.low), _mm_or_si128(p_a.high, p_b.high) }; }
+
+    BITBOARD_SSE41 static inline Row AndNot(Row p_a, Row p_b)
+    { return Row{ _mm_andnot_si128(p_a.low, p_b.low), _mm_andnot_si128(p_a.high, p_b.high) }; }
+
+    BITBOARD_SSE41 static inline Row Decrement(Row p_row)
+    {
+        __m128i l_one = _mm_set1_epi16(1);
+        return Row{ _mm_sub_epi16(p_row.low, l_one), _mm_sub_epi16(p_row.high, l_one) };
+    }
+
+    BITBOARD_SSE41 static inline Row IsZero(Row p_row)
+    {
+        __m128i l_zero = _mm_setzero_si128();
+        return Row{ _mm_cmpeq_epi16(p_row.low, l_zero), _mm_cmpeq_epi16(p_row.high, l_zero) };
+    }
+
+    BITBOARD_SSE41 static inline bool IsAllZero(Row p_row)
+    {
+        __m128i l_any = _mm_or_si128(p_row.low, p_row.high);
+        return _mm_testz_si128(l_any, l_any) != 0;
+    }
+
+    template <int K>
+    BITBOARD_SSE41 static inline Row ShiftLanes(Row p_row)
+    {
+        if (K == 8)
+        { return Row{ p_row.high, _mm_setzero_si128() }; }
+
+        return Row{ _mm_alignr_epi8(p_row.high, p_row.low, (2 * K) & 15), _mm_srli_si128(p_row.high, (2 * K) & 15) };
+    }
+
+    BITBOARD_SSE41 static inline unsigned short FirstLane(Row p_row)
+    { return static_cast<unsigned short>(_mm_extract_epi16(p_row.low, 0)); }
+
+    BITBOARD_SSE41 static inline unsigned short ToBits(Row p_row)
+    { return static_cast<unsigned short>(_mm_movemask_epi8(_mm_packs_epi16(p_row.low, p_row.high))); }
+};
+
+
+/*
+* Merges the digits seen at least once (p_once) and at least twice (p_twice) in one set of cells with those of
+  another, disjoint set of cells, lane by lane.
+*/
+template <class Ops>
+inline void Merge(typename Ops::Row& p_once, typename Ops::Row& p_twice,
+                  const typename Ops::Row& p_once_other, const typename Ops::Row& p_twice_other)
+{
+    p_twice = Ops::Or(Ops::Or(p_twice, p_twice_other), Ops::And(p_once, p_once_other));
+    p_once = Ops::Or(p_once, p_once_other);
+}
+
+/*
+* Merges each lane with the following K lanes (see Merge).
+*/
+template <class Ops, int K>
+inline void MergeShifted(typename Ops::Row& p_once, typename Ops::Row& p_twice,
+                         const typename Ops::Row& p_once_other, const typename Ops::Row& p_twice_other)
+{
+    Merge<Ops>(p_once, p_twice, Ops::template ShiftLanes<K>(p_once_other), Ops::template ShiftLanes<K>(p_twice_other));
+}
+
+/*
+* See BitboardKernel::find_naked_singles.
+
+* Notes:
+    (a). The lanes beyond the end of the row (which hold the start of the next row) are ignored.
+    (b). A set of digits has at most one digit if clearing its lowest bit leaves it empty.
+*/
+template <class Ops, unsigned int W, unsigned int H>
+bool FindNakedSingles(const unsigned short* p_candidates, const unsigned char* p_cells, unsigned short* p_singles)
+{
+    typedef typename Ops::Row Row;
+
+    const unsigned int l_size_grid = W * H;
+
+    // (a).
+    Row l_in_row = Ops::Load(S_LANES_FIRST + 16 - l_size_grid);
+
+    // The empty cells that have no candidates.
+    Row l_stuck = Ops::Zero();
+
+    for (unsigned int row = 0; row < l_size_grid; ++row)
+    {
+        Row l_candidates = Ops::Load(p_candidates + row * l_size_grid);
+        Row l_is_empty = Ops::And(l_in_row, Ops::LoadIsZero(p_cells + row * l_size_grid));
+        Row l_is_none = Ops::IsZero(l_candidates);
+
+        // (b).
+        Row l_is_at_most_one = Ops::IsZero(Ops::And(l_candidates, Ops::Decrement(l_candidates)));
+
+        l_stuck = Ops::Or(l_stuck, Ops::And(l_is_empty, l_is_none));
+        p_singles[row] = Ops::ToBits(Ops::AndNot(l_is_none, Ops::And(l_is_empty, l_is_at_most_one)));
+    }
+
+    return Ops::IsAllZero(l_stuck);
+}
+
+/*
+* See BitboardKernel::count_units.
+
+* Notes:
+    (a). Merging the rows lane by lane gives the counts of every column at once.
+    (b). Merging each lane with the lanes that follow it, in windows that double in size, leaves the counts of the
+         whole row in the first lane; a 9-cell row needs one more lane after a window of 8.
+    (c). Merging the rows of a band of boxes lane by lane and then each lane with the next W - 1 lanes leaves the
+         counts of each box in the first lane of its columns.
+*/
+template <class Ops, unsigned int W, unsigned int H>
+void CountUnits(const unsigned short* p_candidates, unsigned short* p_once, unsigned short* p_twice)
+{
+    static_assert((W == 3 && H == 3) || (W == 4 && H == 4), "there are only kernels for 3x3 and 4x4 boxes");
+
+    typedef typename Ops::Row Row;
+
+    const unsigned int l_size_grid = W * H;
+
+    Row l_in_row = Ops::Load(S_LANES_FIRST + 16 - l_size_grid);
+    Row l_zero = Ops::Zero();
+
+    Row l_rows[l_size_grid];
+
+    for (unsigned int row = 0; row < l_size_grid; ++row)
+    {
+        l_rows[row] = Ops::And(l_in_row, Ops::Load(p_candidates + row * l_size_grid));
+    }
+
+    unsigned short l_lanes_once[16];
+    unsigned short l_lanes_twice[16];
+
+    // (a).
+    Row l_once = l_zero;
+    Row l_twice = l_zero;
+
+    for (unsigned int row = 0; row < l_size_grid; ++row)
+    {
+        Merge<Ops>(l_once, l_twice, l_rows[row], l_zero);
+    }
+
+    Ops::Store(l_lanes_once, l_once);
+    Ops::Store(l_lanes_twice, l_twice);
+
+    for (unsigned int col = 0; col < l_size_grid; ++col)
+    {
+        p_once[l_size_grid + col] = l_lanes_once[col];
+        p_twice[l_size_grid + col] = l_lanes_twice[col];
+    }
+
+    // (b).
+    for (unsigned int row = 0; row < l_size_grid; ++row)
+    {
+        l_once = l_rows[row];
+        l_twice = l_zero;
+
+        MergeShifted<Ops, 1>(l_once, l_twice, l_once, l_twice);
+        MergeShifted<Ops, 2>(l_once, l_twice, l_once, l_twice);
+        MergeShifted<Ops, 4>(l_once, l_twice, l_once, l_twice);
+
+        if (l_size_grid == 16)
+        { MergeShifted<Ops, 8>(l_once, l_twice, l_once, l_twice); }
+        else
+        { MergeShifted<Ops, 8>(l_once, l_twice, l_rows[row], l_zero); }
+
+        p_once[row] = Ops::FirstLane(l_once);
+        p_twice[row] = Ops::FirstLane(l_twice);
+    }
+
+    // (c).
+    for (unsigned int band = 0; band < W; ++band)
+    {
+        Row l_once_band = l_zero;
+        Row l_twice_band = l_zero;
+
+        for (unsigned int row = band * H; row < (band + 1) * H; ++row)
+        {
+            Merge<Ops>(l_once_band, l_twice_band, l_rows[row], l_zero);
+        }
+
+        l_once = l_once_band;
+        l_twice = l_twice_band;
+
+        if (W == 3)
+        {
+            MergeShifted<Ops, 1>(l_once, l_twice, l_once_band, l_twice_band);
+            MergeShifted<Ops, 2>(l_once, l_twice, l_once_band, l_twice_band);
+        }
+        else
+        {
+            MergeShifted<Ops, 1>(l_once, l_twice, l_once, l_twice);
+            MergeShifted<Ops, 2>(l_once, l_twice, l_once, l_twice);
+        }
+
+        Ops::Store(l_lanes_once, l_once);
+        Ops::Store(l_lanes_twice, l_twice);
+
+        for (unsigned int i = 0; i < H; ++i)
+        {
+            p_once[2 * l_size_grid + band * H + i] = l_lanes_once[i * W];
+            p_twice[2 * l_size_grid + band * H + i] = l_lanes_twice[i * W];
+        }
+
+    }
+
+}
+
+/*
+* The kernels of each instruction set.
+
+* Notes:
+    (a). The kernels' bodies above aren't compiled for any particular instruction set; 'flatten' makes the compiler
+         inline the whole body, and the operations that it calls, into these wrappers, where they're compiled for the
+         wrapper's instruction set.
+*/
+
+// (a).
+template <unsigned int W, unsigned int H>
+__attribute__((target("avx2"), flatten))
+bool FindNakedSinglesAvx2(const unsigned short* p_candidates, const unsigned char* p_cells, unsigned short* p_singles)
+{
+    return FindNakedSingles<Avx2Ops, W, H>(p_candidates, p_cells, p_singles);
+}
+
+template <unsigned int W, unsigned int H>
+__attribute__((target("avx2"), flatten))
+void CountUnitsAvx2(const unsigned short* p_candidates, unsigned short* p_once, unsigned short* p_twice)
+{
+    CountUnits<Avx2Ops, W, H>(p_candidates, p_once, p_twice);
+}
+
+template <unsigned int W, unsigned int H>
+__attribute__((target("sse4.1"), flatten))
+bool FindNakedSinglesSse41(const unsigned short* p_candidates, const unsigned char* p_cells, unsigned short* p_singles)
+{
+    return FindNakedSingles<Sse41Ops, W, H>(p_candidates, p_cells, p_singles);
+}
+
+template <unsigned int W, unsigned int H>
+__attribute__((target("sse4.1"), flatten))
+void CountUnitsSse41(const unsigned short* p_candidates, unsigned short* p_once, unsigned short* p_twice)
+{
+    CountUnits<Sse41Ops, W, H>(p_candidates, p_once, p_twice);
+}
+
+#endif
+
+
+/*
+* Returns the kernel for boxes of W by H cells, as described by BitboardKernel::Select.
+*/
+template <unsigned int W, unsigned int H>
+BitboardKernel<W, H> SelectKernel()
+{
+#ifdef BITBOARD_KERNEL_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+    { return BitboardKernel<W, H>{ &FindNakedSinglesAvx2<W, H>, &CountUnitsAvx2<W, H> }; }
+
+    if (__builtin_cpu_supports("sse4.1"))
+    { return BitboardKernel<W, H>{ &FindNakedSinglesSse41<W, H>, &CountUnitsSse41<W, H> }; }
+#endif
+
+    return BitboardKernel<W, H>{ nullptr, nullptr };
+}
+
+template <>
+BitboardKernel<3, 3> BitboardKernel<3, 3>::Select()
+{
+    return SelectKernel<3, 3>();
+}
+
+template <>
+BitboardKernel<4, 4> BitboardKernel<4, 4>::Select()
+{
+    return SelectKernel<4, 4>();
+}
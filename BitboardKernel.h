@@ -0,0 +1,50 @@
+#pragma once
+
+#include<type_traits>
+
+
+/*
+* The vectorised parts of FixedSizeSolver's propagation, for grids whose boxes are W cells wide and H cells tall.
+* There are kernels for the two sizes that most puzzles are, 9x9 and 16x16 (boxes of 3x3 and 4x4): each row of the
+  grid fits in a vector of 16 16-bit lanes (one AVX2 register, or two SSE registers), so that the candidates of a
+  whole row are examined at once, and those of every column at once by combining the rows lane by lane.
+* The kernel is chosen at run time, according to the instruction sets that the CPU supports (see Select); for other
+  sizes, other CPUs or other compilers, the functions are nullptr and the solver uses its scalar code instead.
+*/
+template <unsigned int W, unsigned int H>
+struct BitboardKernel
+{
+    // The type of FixedSizeSolver's sets of digits: bit (d - 1) is set if the digit d is in the set.
+    typedef typename std::conditional<W * H <= 16, unsigned short, unsigned int>::type Mask;
+
+    // The number of elements that the arrays passed to the kernel must have beyond the last cell, as the last row is
+    // loaded as a whole vector.
+    static const unsigned int S_PADDING = 16;
+
+    /*
+    * Given the candidates of each cell (0 for a filled cell) and the value of each cell (0 for an empty cell), both
+      indexed by row * (W * H) + col, sets p_singles[row] to the set of columns of the row's empty cells that have
+      exactly one candidate (bit c for column c).
+    * Returns false, leaving p_singles unspecified, if any empty cell has no candidates.
+    */
+    bool (*find_naked_singles)(const Mask* p_candidates, const unsigned char* p_cells, Mask* p_singles);
+
+    /*
+    * Sets p_once[unit] and p_twice[unit] to the digits that are candidates of at least one, and of at least two, of
+      the cells of each unit (numbered as in FixedSizeTables).
+    */
+    void (*count_units)(const Mask* p_candidates, Mask* p_once, Mask* p_twice);
+
+    /*
+    * Returns the kernel for the widest instruction set that the CPU supports (AVX2, then SSE4.1), or one whose
+      functions are nullptr if there's no suitable kernel.
+    */
+    static BitboardKernel Select()
+    {
+        return BitboardKernel{ nullptr, nullptr };
+    }
+};
+
+// The sizes that have kernels; see BitboardKernel.cpp.
+template <> BitboardKernel<3, 3> BitboardKernel<3, 3>::Select();
+template <> BitboardKernel<4, 4> BitboardKernel<4, 4>::Select();
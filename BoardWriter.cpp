@@ -0,0 +1,229 @@
+#include"BoardWriter.h"
+
+#include<cstring>
+
+#include"PuzzleReader.h"
+
+
+BoardWriter::BoardWriter(Format p_format /*= Format::Pretty*/)
+    : f_format(p_format)
+{
+}
+
+void BoardWriter::SetFormat(Format p_format)
+{
+    f_format = p_format;
+}
+
+BoardWriter::Format BoardWriter::GetFormat() const
+{
+    return f_format;
+}
+
+/*
+* Notes:
+    (a). The buffer is cleared rather than replaced, so its storage is kept for the next board.
+*/
+void BoardWriter::Write(std::ostream& p_output, const SudokuBoard& p_board)
+{
+    // (a).
+    f_text.clear();
+
+    Render(f_text, p_board, f_format);
+
+    p_output.write(f_text.data(), f_text.size());
+}
+
+void BoardWriter::Render(std::string& p_text, const SudokuBoard& p_board, Format p_format)
+{
+    switch (p_format)
+    {
+        case Format::Pretty: RenderPretty(p_text, p_board); break;
+        case Format::Compact: RenderCompact(p_text, p_board); break;
+        case Format::Raw: RenderRaw(p_text, p_board); break;
+    }
+
+}
+
+bool BoardWriter::ParseFormat(const char* p_name, Format& p_format)
+{
+    if (std::strcmp(p_name, "pretty") == 0)
+    { p_format = Format::Pretty; }
+    else if (std::strcmp(p_name, "compact") == 0)
+    { p_format = Format::Compact; }
+    else if (std::strcmp(p_name, "raw") == 0)
+    { p_format = Format::Raw; }
+    else
+    { return false; }
+
+    return true;
+}
+
+
+/* Auxiliary of Render
+
+* Notes:
+    (a). When all of the values are single digits (max value is at most 9), each value occupies one character and each
+            box is horizontally separated by one character from the others in its row.
+            '(l_size_grid / l_width_box)' is the number of boxes per row; therefore, this value minus 1 is the number of
+            box divider characters per row.
+    (b). When the maximum value has more than one digit (is equal to at least 10), each value must occupy as many
+            characters as the maximum value has digits (padded on the left) in order for the sudoku to be easily read;
+            in addition, rather than each value being placed right next to each other, a space separates them, as
+            otherwise two or more multi-digit numbers placed right next to each other would appear as one long number.
+            Because of the extra spacing within the boxes, they must be horizontally separated by more than one space.
+*/
+void BoardWriter::RenderPretty(std::string& p_text, const SudokuBoard& p_board)
+{
+    const CompactGrid& l_grid = p_board.GetGrid();
+    unsigned int l_size_grid = p_board.GetSizeGrid();
+    unsigned int l_width_box = p_board.GetWidthBox();
+    unsigned int l_height_box = p_board.GetHeightBox();
+
+    // The number of boxes per row.
+    unsigned int l_num_boxes_in_row = l_height_box;
+
+    // The number of characters that each value occupies: the number of digits of the maximum value.
+    unsigned int l_width_value = GetNumDigits(l_size_grid);
+
+    // The width of each row (not incl. the borders).
+    unsigned int l_width_output;
+    if (l_width_value == 1)
+    {
+        // (a).
+        l_width_output = l_size_grid + 4 * (l_num_boxes_in_row - 1) + 2;
+    }
+    else
+    {
+        // (b).
+        l_width_output = l_num_boxes_in_row * ( l_width_value + (l_width_value + 1) * (l_width_box - 1) ) +
+                         4 * (l_num_boxes_in_row - 1) + 2;
+    }
+
+    for (unsigned int row = 0; row < l_size_grid; ++row)
+    {
+        // Output the top border and, at each new row of boxes, separate the boxes vertically.
+        if (row % l_height_box == 0)
+        {
+            p_text += '|';
+            p_text.append(l_width_output, '=');
+            p_text += "|\n";
+        }
+
+        for (unsigned int col = 0; col < l_size_grid; ++col)
+        {
+            // The value associated with the coordinates.
+            unsigned int l_value = l_grid.Get(row, col);
+
+            // A flag that, when true, indicates that l_value is the first value of a box for this row.
+            bool l_is_new_box = col % l_width_box == 0;
+
+            // Left border and its padding, or separate the boxes horizontally.
+            if (col == 0)
+            { p_text += "| "; }
+            else if (l_is_new_box)
+            { p_text += " || "; }
+
+            // The value, padded to the width of the maximum value (and separated by a space within a box) if there
+            // are multi-digit values.
+            if (l_width_value > 1 && !l_is_new_box)
+            { p_text += ' '; }
+
+            p_text.append(l_width_value - GetNumDigits(l_value), ' ');
+
+            AppendNumber(p_text, l_value);
+        }
+
+        // Padding from the right border, and the right border.
+        p_text += " |\n";
+    }
+
+    // The bottom border.
+    p_text += '|';
+    p_text.append(l_width_output, '=');
+    p_text += "|\n";
+}
+
+/* Auxiliary of Render
+*/
+void BoardWriter::RenderCompact(std::string& p_text, const SudokuBoard& p_board)
+{
+    const CompactGrid& l_grid = p_board.GetGrid();
+    unsigned int l_size_grid = p_board.GetSizeGrid();
+
+    for (unsigned int row = 0; row < l_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < l_size_grid; ++col)
+        {
+            unsigned int l_value = l_grid.Get(row, col);
+
+            if (l_size_grid <= 35)
+            {
+                p_text += PuzzleReader::ToChar(l_value);
+            }
+            else
+            {
+                if (row != 0 || col != 0)
+                { p_text += ' '; }
+
+                AppendNumber(p_text, l_value);
+            }
+
+        }
+
+    }
+
+    p_text += '\n';
+}
+
+/* Auxiliary of Render
+*/
+void BoardWriter::RenderRaw(std::string& p_text, const SudokuBoard& p_board)
+{
+    const CompactGrid& l_grid = p_board.GetGrid();
+    unsigned int l_size_grid = p_board.GetSizeGrid();
+
+    AppendNumber(p_text, p_board.GetWidthBox());
+    p_text += ' ';
+    AppendNumber(p_text, p_board.GetHeightBox());
+    p_text += '\n';
+
+    for (unsigned int row = 0; row < l_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < l_size_grid; ++col)
+        {
+            AppendNumber(p_text, l_grid.Get(row, col));
+            p_text += col + 1 < l_size_grid ? ' ' : '\n';
+        }
+
+    }
+
+}
+
+unsigned int BoardWriter::GetNumDigits(unsigned int p_value)
+{
+    unsigned int l_num_digits = 1;
+
+    for (; p_value >= 10; p_value /= 10)
+    { ++l_num_digits; }
+
+    return l_num_digits;
+}
+
+void BoardWriter::AppendNumber(std::string& p_text, unsigned int p_value)
+{
+    char l_digits[10];
+    unsigned int l_num_digits = 0;
+
+    do
+    {
+        l_digits[l_num_digits++] = static_cast<char>('0' + p_value % 10);
+        p_value /= 10;
+    } while (p_value != 0);
+
+    while (l_num_digits != 0)
+    {
+        p_text += l_digits[--l_num_digits];
+    }
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include<iostream>
+#include<string>
+
+#include"SudokuBoard.h"
+
+
+/*
+* Renders boards as text into a buffer that's reused from board to board, then writes each rendering to its stream in
+  one call, without flushing.
+* Three formats are available:
+    (1). Pretty: the boxed layout of operator<<(std::ostream&, const SudokuBoard&), for people.
+    (2). Compact: the one-line format (see PuzzleReader) followed by '\n'; for grids of more than 35 digits, which that
+         format can't hold, the values are instead written on one line separated by spaces.
+    (3). Raw: the format of the example files, i.e. a line holding the width and height of the boxes followed by one
+         line per row of the grid, the values separated by spaces (0 for empty cells).
+* Formats (2) and (3) can be read back by PuzzleReader (except for the compact format of grids of more than 35 digits,
+  and the dimensions of the boxes in the compact format, which are inferred from the size of the grid).
+*/
+class BoardWriter
+{
+
+public:
+
+    // The formats that boards can be rendered in.
+    enum class Format
+    {
+        Pretty,
+        Compact,
+        Raw
+    };
+
+
+private:
+
+    // The format that Write renders boards in.
+    Format f_format;
+
+    // The buffer that Write renders each board into.
+    std::string f_text;
+
+
+public:
+
+    BoardWriter(Format p_format = Format::Pretty);
+
+    void SetFormat(Format p_format);
+
+    Format GetFormat() const;
+
+    /*
+    * Renders p_board into the buffer and writes it to p_output in one call.
+    */
+    void Write(std::ostream& p_output, const SudokuBoard& p_board);
+
+    /*
+    * Appends the rendering of p_board in the format p_format to p_text; for callers that gather several renderings
+      (and other text) into a buffer of their own before writing it.
+    */
+    static void Render(std::string& p_text, const SudokuBoard& p_board, Format p_format);
+
+    /*
+    * Assigns to p_format the format named p_name ("pretty", "compact" or "raw"). Returns false if there's no such
+      format.
+    */
+    static bool ParseFormat(const char* p_name, Format& p_format);
+
+
+private:
+
+    /* Auxiliary of Render
+    * Append the rendering of p_board in each format to p_text.
+    */
+    static void RenderPretty(std::string& p_text, const SudokuBoard& p_board);
+    static void RenderCompact(std::string& p_text, const SudokuBoard& p_board);
+    static void RenderRaw(std::string& p_text, const SudokuBoard& p_board);
+
+    /* Auxiliary of RenderPretty
+    * Returns the number of decimal digits of p_value.
+    */
+    static unsigned int GetNumDigits(unsigned int p_value);
+
+    /* Auxiliary of RenderPretty, RenderCompact, RenderRaw
+    * Appends the decimal digits of p_value to p_text (without the temporary string of std::to_string).
+    */
+    static void AppendNumber(std::string& p_text, unsigned int p_value);
+
+};
@@ -0,0 +1,433 @@
+#include"CanonicalForm.h"
+
+#include<algorithm>
+#include<cstring>
+
+
+CanonicalForm::CanonicalForm()
+    : f_width_box(0), f_height_box(0), f_size_grid(0), f_is_transposed(false), f_num_labels(0)
+{
+    std::memset(f_labels, 0, sizeof(f_labels));
+}
+
+/*
+* Notes:
+    (a). The transposed grid has boxes of the swapped dimensions, so it's only a candidate when the dimensions are
+         equal, or when it's the one whose boxes are wider than they're tall (the form's orientation).
+    (b). The rows of the (transposed) grid are in bands of the height of its boxes, and their cells in stacks of the
+         width of its boxes; its columns are the rows of the other grid, with the dimensions the other way around.
+    (c). Every candidate is counted before any is compared, so that a puzzle with too many is given up on at once.
+*/
+bool CanonicalForm::Compute(const SudokuBoard& p_board)
+{
+    const CompactGrid& l_grid = p_board.GetGrid();
+
+    f_width_box = p_board.GetWidthBox();
+    f_height_box = p_board.GetHeightBox();
+    f_size_grid = p_board.GetSizeGrid();
+
+    unsigned int l_num_cells = f_size_grid * f_size_grid;
+
+    // The number of cells holding each digit.
+    unsigned int l_num_digits[CompactGrid::S_MAX_VALUE + 1] = { 0 };
+
+    f_cells[0].resize(l_num_cells);
+    f_cells[1].resize(l_num_cells);
+
+    for (unsigned int row = 0; row < f_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < f_size_grid; ++col)
+        {
+            unsigned char l_value = l_grid[row * f_size_grid + col];
+
+            f_cells[0][row * f_size_grid + col] = l_value;
+            f_cells[1][col * f_size_grid + row] = l_value;
+            ++l_num_digits[l_value];
+        }
+
+    }
+
+    l_num_digits[0] = 0;
+
+    // (a).
+    unsigned int l_transposed_first = f_width_box < f_height_box ? 1 : 0;
+    unsigned int l_transposed_last = f_width_box > f_height_box ? 0 : 1;
+
+    // (c).
+    unsigned long long l_num_candidates = 0;
+
+    for (unsigned int t = l_transposed_first; t <= l_transposed_last; ++t)
+    {
+        // (b).
+        unsigned int l_width_box = t == 0 ? f_width_box : f_height_box;
+        unsigned int l_height_box = t == 0 ? f_height_box : f_width_box;
+
+        l_num_candidates += BuildAxis(f_cells[t], l_height_box, l_width_box, l_num_digits, f_axis_rows) *
+                            BuildAxis(f_cells[1 - t], l_width_box, l_height_box, l_num_digits, f_axis_cols);
+
+        if (l_num_candidates > S_MAX_CANDIDATES)
+        { return false; }
+    }
+
+    f_key.assign(1, static_cast<char>(l_transposed_first == 0 ? f_width_box : f_height_box));
+    f_key += static_cast<char>(l_transposed_first == 0 ? f_height_box : f_width_box);
+    f_candidate.resize(l_num_cells);
+
+    for (unsigned int t = l_transposed_first; t <= l_transposed_last; ++t)
+    {
+        // (b).
+        unsigned int l_width_box = t == 0 ? f_width_box : f_height_box;
+        unsigned int l_height_box = t == 0 ? f_height_box : f_width_box;
+
+        BuildAxis(f_cells[t], l_height_box, l_width_box, l_num_digits, f_axis_rows);
+        BuildAxis(f_cells[1 - t], l_width_box, l_height_box, l_num_digits, f_axis_cols);
+
+        do
+        {
+            do
+            {
+                CompareCandidate(t == 1);
+            } while (NextOrdering(f_axis_cols));
+
+        } while (NextOrdering(f_axis_rows));
+
+    }
+
+    return true;
+}
+
+const std::string& CanonicalForm::GetKey() const
+{
+    return f_key;
+}
+
+unsigned long long CanonicalForm::GetHash() const
+{
+    return Hash(f_key);
+}
+
+void CanonicalForm::ToCanonical(const CompactGrid& p_solution, std::string& p_cells) const
+{
+    unsigned char l_labels[CompactGrid::S_MAX_VALUE + 1];
+    std::memcpy(l_labels, f_labels, sizeof(l_labels));
+
+    unsigned int l_num_labels = f_num_labels;
+
+    p_cells.resize(f_size_grid * f_size_grid);
+
+    for (unsigned int i = 0; i < f_size_grid; ++i)
+    {
+        for (unsigned int j = 0; j < f_size_grid; ++j)
+        {
+            unsigned int l_value = f_is_transposed ? p_solution.Get(f_cols[j], f_rows[i]) :
+                                                     p_solution.Get(f_rows[i], f_cols[j]);
+
+            if (l_value != 0 && l_labels[l_value] == 0)
+            { l_labels[l_value] = static_cast<unsigned char>(++l_num_labels); }
+
+            p_cells[i * f_size_grid + j] = static_cast<char>(l_labels[l_value]);
+        }
+
+    }
+
+}
+
+void CanonicalForm::FromCanonical(const std::string& p_cells, CompactGrid& p_grid) const
+{
+    // The digit of each label.
+    unsigned char l_digits[CompactGrid::S_MAX_VALUE + 1] = { 0 };
+    unsigned int l_num_labels = f_num_labels;
+
+    for (unsigned int value = 1; value <= CompactGrid::S_MAX_VALUE; ++value)
+    {
+        if (f_labels[value] != 0)
+        { l_digits[f_labels[value]] = static_cast<unsigned char>(value); }
+    }
+
+    for (unsigned int value = 1; value <= f_size_grid; ++value)
+    {
+        if (f_labels[value] == 0)
+        { l_digits[++l_num_labels] = static_cast<unsigned char>(value); }
+    }
+
+    p_grid.Resize(f_size_grid);
+
+    for (unsigned int i = 0; i < f_size_grid; ++i)
+    {
+        for (unsigned int j = 0; j < f_size_grid; ++j)
+        {
+            unsigned int l_value = l_digits[static_cast<unsigned char>(p_cells[i * f_size_grid + j])];
+
+            if (f_is_transposed)
+            { p_grid.Set(f_cols[j], f_rows[i], l_value); }
+            else
+            { p_grid.Set(f_rows[i], f_cols[j], l_value); }
+        }
+
+    }
+
+}
+
+unsigned long long CanonicalForm::Hash(const std::string& p_key)
+{
+    unsigned long long l_hash = 14695981039346656037ULL;
+
+    for (char l_byte : p_key)
+    {
+        l_hash ^= static_cast<unsigned char>(l_byte);
+        l_hash *= 1099511628211ULL;
+    }
+
+    return l_hash;
+}
+
+
+/* Auxiliary of Compute
+
+* Notes:
+    (a). The invariants of a line don't depend on the order of the lines, nor on the digits' labels: its number of
+         clues, then, for each clue, the number of clues in its cross line and of the cells holding its digit (sorted),
+         then the number of clues in each of its cross blocks (sorted).
+    (b). The lines are ranked by their invariants, equal invariants having equal ranks; the invariants of a block are
+         the ranks of its lines (sorted).
+    (c). The blocks, and the lines of each block, are sorted by their invariants, and by their index when those are
+         equal; the ranges of equal ones are then in increasing order, which is where std::next_permutation starts.
+*/
+unsigned long long CanonicalForm::BuildAxis(const std::vector<unsigned char>& p_cells, unsigned int p_size_block,
+                                            unsigned int p_size_block_cross, const unsigned int* p_num_digits,
+                                            Axis& p_axis)
+{
+    unsigned int l_num_blocks = f_size_grid / p_size_block;
+    unsigned int l_num_blocks_cross = f_size_grid / p_size_block_cross;
+
+    f_counts_cross.assign(f_size_grid, 0);
+
+    for (unsigned int cell = 0; cell < p_cells.size(); ++cell)
+    {
+        if (p_cells[cell] != 0)
+        { ++f_counts_cross[cell % f_size_grid]; }
+    }
+
+    f_keys.resize(f_size_grid);
+    f_ranks.resize(f_size_grid);
+
+    // (a).
+    for (unsigned int line = 0; line < f_size_grid; ++line)
+    {
+        std::vector<unsigned int>& l_key = f_keys[line];
+        const unsigned char* l_cells = &p_cells[line * f_size_grid];
+
+        l_key.assign(1 + l_num_blocks_cross, 0);
+
+        for (unsigned int i = 0; i < f_size_grid; ++i)
+        {
+            if (l_cells[i] == 0)
+            { continue; }
+
+            ++l_key[0];
+            ++l_key[1 + i / p_size_block_cross];
+            l_key.push_back(f_counts_cross[i] * (f_size_grid * f_size_grid + 1) + p_num_digits[l_cells[i]]);
+        }
+
+        std::sort(l_key.begin() + 1, l_key.begin() + 1 + l_num_blocks_cross);
+        std::sort(l_key.begin() + 1 + l_num_blocks_cross, l_key.end());
+    }
+
+    // (b).
+    p_axis.map.resize(f_size_grid);
+
+    for (unsigned int line = 0; line < f_size_grid; ++line)
+    {
+        p_axis.map[line] = line;
+    }
+
+    std::sort(p_axis.map.begin(), p_axis.map.end(),
+              [&](unsigned int p_a, unsigned int p_b) { return f_keys[p_a] < f_keys[p_b]; });
+
+    for (unsigned int i = 0; i < f_size_grid; ++i)
+    {
+        bool l_is_new = i == 0 || f_keys[p_axis.map[i - 1]] < f_keys[p_axis.map[i]];
+        f_ranks[p_axis.map[i]] = i == 0 ? 0 : f_ranks[p_axis.map[i - 1]] + (l_is_new ? 1 : 0);
+    }
+
+    for (unsigned int block = 0; block < l_num_blocks; ++block)
+    {
+        std::vector<unsigned int>& l_key = f_keys[block];
+
+        l_key.assign(f_ranks.begin() + block * p_size_block, f_ranks.begin() + (block + 1) * p_size_block);
+        std::sort(l_key.begin(), l_key.end());
+    }
+
+    // (c).
+    unsigned long long l_num_candidates = 1;
+
+    // Adds the range [p_begin, p_end) to p_ties if it has more than one member, multiplying the number of candidates
+    // by its number of orders.
+    auto l_add_tie = [&](std::vector<std::pair<unsigned int, unsigned int>>& p_ties, unsigned int p_begin,
+                         unsigned int p_end)
+    {
+        for (unsigned int i = 2; i <= p_end - p_begin && l_num_candidates <= S_MAX_CANDIDATES; ++i)
+        {
+            l_num_candidates *= i;
+        }
+
+        if (p_end - p_begin > 1)
+        { p_ties.emplace_back(p_begin, p_end); }
+    };
+
+    p_axis.size_block = p_size_block;
+    p_axis.blocks.resize(l_num_blocks);
+    p_axis.ties_blocks.clear();
+
+    for (unsigned int block = 0; block < l_num_blocks; ++block)
+    {
+        p_axis.blocks[block] = block;
+    }
+
+    std::stable_sort(p_axis.blocks.begin(), p_axis.blocks.end(),
+                     [&](unsigned int p_a, unsigned int p_b) { return f_keys[p_a] < f_keys[p_b]; });
+
+    for (unsigned int l_begin = 0, l_end = 1; l_end <= l_num_blocks; ++l_end)
+    {
+        if (l_end == l_num_blocks || f_keys[p_axis.blocks[l_begin]] != f_keys[p_axis.blocks[l_end]])
+        {
+            l_add_tie(p_axis.ties_blocks, l_begin, l_end);
+            l_begin = l_end;
+        }
+
+    }
+
+    p_axis.lines.resize(f_size_grid);
+    p_axis.ties_lines.clear();
+
+    for (unsigned int block = 0; block < l_num_blocks; ++block)
+    {
+        auto l_first = p_axis.lines.begin() + block * p_size_block;
+
+        for (unsigned int i = 0; i < p_size_block; ++i)
+        {
+            l_first[i] = block * p_size_block + i;
+        }
+
+        std::stable_sort(l_first, l_first + p_size_block,
+                         [&](unsigned int p_a, unsigned int p_b) { return f_ranks[p_a] < f_ranks[p_b]; });
+
+        for (unsigned int l_begin = 0, l_end = 1; l_end <= p_size_block; ++l_end)
+        {
+            if (l_end == p_size_block || f_ranks[l_first[l_begin]] != f_ranks[l_first[l_end]])
+            {
+                l_add_tie(p_axis.ties_lines, block * p_size_block + l_begin, block * p_size_block + l_end);
+                l_begin = l_end;
+            }
+
+        }
+
+    }
+
+    MapAxis(p_axis);
+
+    return std::min(l_num_candidates, static_cast<unsigned long long>(S_MAX_CANDIDATES) + 1);
+}
+
+/* Auxiliary of Compute
+
+* Notes:
+    (a). The ranges are advanced like the digits of an odometer: a range that has been through all of its orders
+         returns to the first (std::next_permutation returns false once it has), and the next range is advanced.
+*/
+bool CanonicalForm::NextOrdering(Axis& p_axis)
+{
+    // (a).
+    for (const auto& l_tie : p_axis.ties_blocks)
+    {
+        if (std::next_permutation(p_axis.blocks.begin() + l_tie.first, p_axis.blocks.begin() + l_tie.second))
+        {
+            MapAxis(p_axis);
+            return true;
+        }
+
+    }
+
+    for (const auto& l_tie : p_axis.ties_lines)
+    {
+        if (std::next_permutation(p_axis.lines.begin() + l_tie.first, p_axis.lines.begin() + l_tie.second))
+        {
+            MapAxis(p_axis);
+            return true;
+        }
+
+    }
+
+    MapAxis(p_axis);
+    return false;
+}
+
+/* Auxiliary of BuildAxis, NextOrdering
+*/
+void CanonicalForm::MapAxis(Axis& p_axis)
+{
+    for (unsigned int i = 0; i < p_axis.map.size(); ++i)
+    {
+        p_axis.map[i] = p_axis.lines[p_axis.blocks[i / p_axis.size_block] * p_axis.size_block + i % p_axis.size_block];
+    }
+
+}
+
+/* Auxiliary of Compute
+
+* Notes:
+    (a). The candidate is given up on as soon as one of its cells is greater than that of the form, as it can no
+         longer be less; most are given up on within a row or two.
+    (b). A candidate equal to the form (from an automorphism of the puzzle) is left aside.
+*/
+void CanonicalForm::CompareCandidate(bool p_is_transposed)
+{
+    const unsigned char* l_cells = f_cells[p_is_transposed ? 1 : 0].data();
+    const char* l_form = f_key.data() + 2;
+
+    // Whether or not the candidate is already known to be less than the form (always, if there's no form yet).
+    bool l_is_less = f_key.size() == 2;
+
+    unsigned int l_num_labels = 0;
+    std::memset(f_labels_candidate, 0, sizeof(f_labels_candidate));
+
+    for (unsigned int i = 0, cell = 0; i < f_size_grid; ++i)
+    {
+        const unsigned char* l_row = l_cells + f_axis_rows.map[i] * f_size_grid;
+
+        for (unsigned int j = 0; j < f_size_grid; ++j, ++cell)
+        {
+            unsigned int l_value = l_row[f_axis_cols.map[j]];
+
+            if (l_value != 0 && f_labels_candidate[l_value] == 0)
+            { f_labels_candidate[l_value] = static_cast<unsigned char>(++l_num_labels); }
+
+            unsigned char l_label = f_labels_candidate[l_value];
+
+            // (a).
+            if (!l_is_less)
+            {
+                unsigned char l_label_form = static_cast<unsigned char>(l_form[cell]);
+
+                if (l_label > l_label_form)
+                { return; }
+
+                l_is_less = l_label < l_label_form;
+            }
+
+            f_candidate[cell] = static_cast<char>(l_label);
+        }
+
+    }
+
+    // (b).
+    if (!l_is_less)
+    { return; }
+
+    f_key.replace(2, std::string::npos, f_candidate);
+    f_is_transposed = p_is_transposed;
+    f_rows = f_axis_rows.map;
+    f_cols = f_axis_cols.map;
+    std::memcpy(f_labels, f_labels_candidate, sizeof(f_labels));
+    f_num_labels = l_num_labels;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include<string>
+#include<vector>
+
+#include"CompactGrid.h"
+#include"SudokuBoard.h"
+
+
+/*
+* Maps a puzzle to a canonical form that it shares with the puzzles equivalent to it, i.e. those obtained from it by
+  the transformations that preserve the rules of sudoku:
+    - permuting the bands (rows of boxes), and the rows within each band;
+    - permuting the stacks (columns of boxes), and the columns within each stack;
+    - transposing the grid (which swaps the dimensions of the boxes);
+    - relabelling the digits.
+* The form is the lexicographically least grid among the candidates, with each digit relabelled in the order in
+  which it first appears (row by row). The candidates order the bands, rows, stacks and columns by invariants of the
+  puzzle (e.g. the number of clues in each, and in the columns and of the digits that they hold); only the lines that
+  these can't tell apart are permuted. So every candidate set of a puzzle is the image of that of any equivalent
+  puzzle, and equivalent puzzles have the same form; that it's reached by a transformation also means that puzzles
+  with the same form are always equivalent.
+* When the invariants leave more than S_MAX_CANDIDATES candidates (e.g. for a nearly empty grid, whose lines are all
+  alike), no form is computed.
+* The transformation that led to the form is kept, so that a solution can be mapped to and from the canonical
+  coordinates and digits (see ToCanonical and FromCanonical); a solution cached for one puzzle thus solves every
+  puzzle equivalent to it.
+* The storage is kept from one call to the next, so an object should be reused (one per thread).
+*/
+class CanonicalForm
+{
+
+public:
+
+    // The greatest number of candidate grids that are compared.
+    static const unsigned int S_MAX_CANDIDATES = 1 << 14;
+
+
+private:
+
+    // The orderings of the lines (rows or columns) of a grid that are candidates, i.e. that sort the blocks (bands
+    // or stacks) and the lines within each block by their invariants, and differ only in the order of equal ones.
+    struct Axis
+    {
+        // The number of lines in a block.
+        unsigned int size_block;
+
+        // The blocks in their current order.
+        std::vector<unsigned int> blocks;
+
+        // The lines of each block in their current order, block b's at index b * size_block.
+        std::vector<unsigned int> lines;
+
+        // The ranges, as [begin, end) indices into blocks and into lines, of the blocks and of the lines whose
+        // invariants are equal; each one is permuted through all of its orders.
+        std::vector<std::pair<unsigned int, unsigned int>> ties_blocks;
+        std::vector<std::pair<unsigned int, unsigned int>> ties_lines;
+
+        // The line at each position of the current ordering.
+        std::vector<unsigned int> map;
+    };
+
+    // The dimensions of the boxes of the puzzle, and of its grid.
+    unsigned int f_width_box;
+    unsigned int f_height_box;
+    unsigned int f_size_grid;
+
+    // The cells of the puzzle in row-major order, and those of its transpose.
+    std::vector<unsigned char> f_cells[2];
+
+    // The canonical form: the dimensions of its boxes (one byte each) followed by its cells in row-major order.
+    std::string f_key;
+
+    // The transformation that led to the form: whether or not the grid was transposed, the line of the (transposed)
+    // grid at each row and column of the form, and the label of each digit of the puzzle (0 if it's absent).
+    bool f_is_transposed;
+    std::vector<unsigned int> f_rows;
+    std::vector<unsigned int> f_cols;
+    unsigned char f_labels[CompactGrid::S_MAX_VALUE + 1];
+
+    // The number of distinct digits of the puzzle.
+    unsigned int f_num_labels;
+
+    // The orderings of the rows and of the columns, the candidate being compared, and the labels of its digits.
+    Axis f_axis_rows;
+    Axis f_axis_cols;
+    std::string f_candidate;
+    unsigned char f_labels_candidate[CompactGrid::S_MAX_VALUE + 1];
+
+    // The number of clues in each line across those of an axis, the invariants of its lines (then of its blocks),
+    // and the ranks of the lines; reused by BuildAxis.
+    std::vector<unsigned int> f_counts_cross;
+    std::vector<std::vector<unsigned int>> f_keys;
+    std::vector<unsigned int> f_ranks;
+
+
+public:
+
+    CanonicalForm();
+
+    /*
+    * Computes the canonical form of p_board's puzzle. Returns false if there were too many candidates (see
+      S_MAX_CANDIDATES), in which case there's no form.
+    */
+    bool Compute(const SudokuBoard& p_board);
+
+    /*
+    * Returns the canonical form (see f_key), which identifies the puzzle's class of equivalent puzzles.
+    */
+    const std::string& GetKey() const;
+
+    /*
+    * Returns the hash of the canonical form (see Hash).
+    */
+    unsigned long long GetHash() const;
+
+    /*
+    * Assigns to p_cells the cells, in row-major order, of the solution p_solution of the puzzle, transformed as the
+      puzzle was into its canonical form. The digits that are absent from the puzzle are labelled in the order in
+      which they first appear.
+    */
+    void ToCanonical(const CompactGrid& p_solution, std::string& p_cells) const;
+
+    /*
+    * The reverse of ToCanonical: assigns to p_grid (which is resized to the puzzle's grid) the solution of the puzzle
+      whose canonical cells are p_cells. The labels that don't belong to any digit of the puzzle are given to its
+      absent digits, in increasing order.
+    */
+    void FromCanonical(const std::string& p_cells, CompactGrid& p_grid) const;
+
+    /*
+    * Returns the 64-bit FNV-1a hash of p_key.
+    */
+    static unsigned long long Hash(const std::string& p_key);
+
+
+private:
+
+    /* Auxiliary of Compute
+    * Builds in p_axis the candidate orderings of the lines of p_cells (the rows of an N by N grid), in blocks of
+      p_size_block lines whose cells are in blocks of p_size_block_cross; p_num_digits holds the number of cells of
+      each digit. Returns the number of candidates (saturated at S_MAX_CANDIDATES + 1).
+    */
+    unsigned long long BuildAxis(const std::vector<unsigned char>& p_cells, unsigned int p_size_block,
+                                 unsigned int p_size_block_cross, const unsigned int* p_num_digits, Axis& p_axis);
+
+    /* Auxiliary of Compute
+    * Moves p_axis to its next candidate ordering, and updates its map. Returns false, having returned to the first
+      ordering, once every ordering has been visited.
+    */
+    static bool NextOrdering(Axis& p_axis);
+
+    /* Auxiliary of BuildAxis, NextOrdering
+    * Computes the map of p_axis from its current ordering.
+    */
+    static void MapAxis(Axis& p_axis);
+
+    /* Auxiliary of Compute
+    * Compares the candidate given by the current orderings of the (transposed, if p_is_transposed) grid with the
+      form found so far, and makes it the form if it's less (or if there's none yet).
+    */
+    void CompareCandidate(bool p_is_transposed);
+
+};
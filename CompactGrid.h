@@ -0,0 +1,230 @@
+#pragma once
+
+#include<cstring>
+#include<memory>
+#include<stdexcept>
+#include<utility>
+
+
+/*
+* The cells of a square sudoku grid in row-major order, one byte per cell (enough for the values of any supported grid,
+  the largest being 121x121).
+* A grid of up to S_NUM_CELLS_INLINE cells (16x16) is stored in the object itself; a larger one on the heap. Either way
+  the cells are contiguous, so copying a grid (e.g. to take a snapshot of a board) is a single memcpy.
+* The accessors Get, Set and operator[] don't check their arguments, and are meant for the loops of the engines, which
+  know the grid's size; GetChecked and SetChecked throw std::range_error for a cell outside of the grid.
+*/
+class CompactGrid
+{
+
+public:
+
+    // The greatest number of cells that are stored in the object itself.
+    static const unsigned int S_NUM_CELLS_INLINE = 256;
+
+    // The greatest value that a cell can hold.
+    static const unsigned int S_MAX_VALUE = 255;
+
+
+private:
+
+    // The cells of a grid of up to S_NUM_CELLS_INLINE cells.
+    unsigned char f_cells_inline[S_NUM_CELLS_INLINE];
+
+    // The cells of a larger grid (nullptr until one is needed), and the number of cells it has room for; kept when
+    // the grid shrinks, so that it can grow again without allocating.
+    std::unique_ptr<unsigned char[]> f_cells_heap;
+    unsigned int f_capacity_heap;
+
+    // The cells in use: f_cells_inline or f_cells_heap.
+    unsigned char* f_cells;
+
+    // The number of rows (and columns), and of cells.
+    unsigned int f_size;
+    unsigned int f_num_cells;
+
+
+public:
+
+    CompactGrid()
+        : f_capacity_heap(0), f_cells(f_cells_inline), f_size(0), f_num_cells(0)
+    {
+    }
+
+    /*
+    * Creates a grid of p_size by p_size empty (0) cells.
+    */
+    explicit CompactGrid(unsigned int p_size)
+        : CompactGrid()
+    {
+        Resize(p_size);
+    }
+
+    CompactGrid(const CompactGrid& p_other)
+        : CompactGrid()
+    {
+        *this = p_other;
+    }
+
+    CompactGrid(CompactGrid&& p_other)
+        : CompactGrid()
+    {
+        *this = std::move(p_other);
+    }
+
+    CompactGrid& operator=(const CompactGrid& p_other)
+    {
+        if (this != &p_other)
+        {
+            Allocate(p_other.f_size);
+            std::memcpy(f_cells, p_other.f_cells, f_num_cells);
+        }
+
+        return *this;
+    }
+
+    /*
+    * Notes:
+        (a). A grid held on the heap is taken over rather than copied; either way, p_other is left empty.
+    */
+    CompactGrid& operator=(CompactGrid&& p_other)
+    {
+        if (this == &p_other)
+        { return *this; }
+
+        // (a).
+        if (p_other.f_cells != p_other.f_cells_inline)
+        {
+            f_cells_heap = std::move(p_other.f_cells_heap);
+            f_capacity_heap = p_other.f_capacity_heap;
+            f_cells = f_cells_heap.get();
+            f_size = p_other.f_size;
+            f_num_cells = p_other.f_num_cells;
+
+            p_other.f_capacity_heap = 0;
+        }
+        else
+        {
+            Allocate(p_other.f_size);
+            std::memcpy(f_cells, p_other.f_cells, f_num_cells);
+        }
+
+        p_other.f_cells = p_other.f_cells_inline;
+        p_other.f_size = 0;
+        p_other.f_num_cells = 0;
+
+        return *this;
+    }
+
+
+    /*
+    * Changes the grid to p_size by p_size cells. If the size differs from the current one, every cell is emptied (0);
+      otherwise the grid is unchanged.
+    */
+    void Resize(unsigned int p_size)
+    {
+        if (p_size == f_size)
+        { return; }
+
+        Allocate(p_size);
+        Fill(0);
+    }
+
+    unsigned int GetSize() const
+    {
+        return f_size;
+    }
+
+    unsigned int GetNumCells() const
+    {
+        return f_num_cells;
+    }
+
+    /*
+    * Returns/sets the value at row p_row and column p_col, without checking either.
+    */
+    unsigned int Get(unsigned int p_row, unsigned int p_col) const
+    {
+        return f_cells[p_row * f_size + p_col];
+    }
+
+    void Set(unsigned int p_row, unsigned int p_col, unsigned int p_value)
+    {
+        f_cells[p_row * f_size + p_col] = static_cast<unsigned char>(p_value);
+    }
+
+    /*
+    * Returns the cell at index p_cell (i.e. row p_cell / GetSize(), column p_cell % GetSize()), without checking it.
+    */
+    unsigned char& operator[](unsigned int p_cell)
+    {
+        return f_cells[p_cell];
+    }
+
+    unsigned char operator[](unsigned int p_cell) const
+    {
+        return f_cells[p_cell];
+    }
+
+    /*
+    * As Get and Set, but throw std::range_error if the row or column is outside of the grid, or (for SetChecked) if
+      the value is greater than S_MAX_VALUE.
+    */
+    unsigned int GetChecked(unsigned int p_row, unsigned int p_col) const
+    {
+        if (p_row >= f_size || p_col >= f_size)
+        { throw std::range_error("The given row and/or column are invalid."); }
+
+        return Get(p_row, p_col);
+    }
+
+    void SetChecked(unsigned int p_row, unsigned int p_col, unsigned int p_value)
+    {
+        if (p_row >= f_size || p_col >= f_size)
+        { throw std::range_error("The given row and/or column are invalid."); }
+
+        if (p_value > S_MAX_VALUE)
+        { throw std::range_error("The given value is too large."); }
+
+        Set(p_row, p_col, p_value);
+    }
+
+    /*
+    * Sets all cells to the given value.
+    */
+    void Fill(unsigned int p_value)
+    {
+        std::memset(f_cells, static_cast<int>(p_value), f_num_cells);
+    }
+
+
+private:
+
+    /* Auxiliary of operator=, Resize
+    * Makes room for p_size by p_size cells, whose values are then undefined: inline if they fit, and otherwise on the
+      heap, which is only reallocated if it's too small.
+    */
+    void Allocate(unsigned int p_size)
+    {
+        unsigned int l_num_cells = p_size * p_size;
+
+        if (l_num_cells <= S_NUM_CELLS_INLINE)
+        {
+            f_cells = f_cells_inline;
+        }
+        else
+        {
+            if (l_num_cells > f_capacity_heap)
+            {
+                f_cells_heap.reset(new unsigned char[l_num_cells]);
+                f_capacity_heap = l_num_cells;
+            }
+
+            f_cells = f_cells_heap.get();
+        }
+
+        f_size = p_size;
+        f_num_cells = l_num_cells;
+    }
+
+};
@@ -0,0 +1,252 @@
+#include"ConflictTracker.h"
+
+
+ConflictTracker::ConflictTracker()
+    : f_width_box(0), f_height_box(0), f_size_grid(0), f_is_current(false), f_num_empty(0)
+{
+}
+
+/*
+* Notes:
+    (a). Every value is counted before any reasons are given, as a cell's reasons depend on the whole of its units
+         (adding the cells one at a time with AddValue would look for the other holder of a value among the cells
+         that haven't been counted yet).
+    (b). Values that are out of range aren't counted in any unit; they're a reason of their own.
+*/
+void ConflictTracker::Reset(const CompactGrid& p_grid, unsigned int p_width_box, unsigned int p_height_box)
+{
+    f_width_box = p_width_box;
+    f_height_box = p_height_box;
+    f_size_grid = p_width_box * p_height_box;
+
+    unsigned int l_num_cells = f_size_grid * f_size_grid;
+    unsigned int l_stride = f_size_grid + 1;
+
+    f_counts.assign(3 * f_size_grid * l_stride, 0);
+    f_num_reasons.assign(l_num_cells, 0);
+    f_positions.resize(l_num_cells);
+    f_conflicts.clear();
+    f_num_empty = 0;
+
+    // (a).
+    for (unsigned int cell = 0; cell < l_num_cells; ++cell)
+    {
+        unsigned int l_value = p_grid[cell];
+        unsigned int l_row = cell / f_size_grid;
+        unsigned int l_col = cell % f_size_grid;
+        unsigned int l_box = (l_row / f_height_box) * f_height_box + l_col / f_width_box;
+
+        if (l_value == 0)
+        { ++f_num_empty; }
+        else if (l_value <= f_size_grid)
+        {
+            ++f_counts[l_row * l_stride + l_value];
+            ++f_counts[(f_size_grid + l_col) * l_stride + l_value];
+            ++f_counts[(2 * f_size_grid + l_box) * l_stride + l_value];
+        }
+
+    }
+
+    for (unsigned int cell = 0; cell < l_num_cells; ++cell)
+    {
+        unsigned int l_value = p_grid[cell];
+        unsigned int l_row = cell / f_size_grid;
+        unsigned int l_col = cell % f_size_grid;
+        unsigned int l_box = (l_row / f_height_box) * f_height_box + l_col / f_width_box;
+
+        if (l_value == 0)
+        { continue; }
+
+        // (b).
+        if (l_value > f_size_grid)
+        {
+            AddReason(cell);
+            continue;
+        }
+
+        if (f_counts[l_row * l_stride + l_value] > 1)
+        { AddReason(cell); }
+
+        if (f_counts[(f_size_grid + l_col) * l_stride + l_value] > 1)
+        { AddReason(cell); }
+
+        if (f_counts[(2 * f_size_grid + l_box) * l_stride + l_value] > 1)
+        { AddReason(cell); }
+    }
+
+    f_is_current = true;
+}
+
+void ConflictTracker::Invalidate()
+{
+    f_is_current = false;
+}
+
+bool ConflictTracker::IsCurrent() const
+{
+    return f_is_current;
+}
+
+void ConflictTracker::Update(const CompactGrid& p_grid, unsigned int p_cell, unsigned int p_value_old)
+{
+    unsigned int l_value_new = p_grid[p_cell];
+
+    if (l_value_new == p_value_old)
+    { return; }
+
+    if (p_value_old == 0)
+    { --f_num_empty; }
+    else
+    { RemoveValue(p_grid, p_cell, p_value_old); }
+
+    if (l_value_new == 0)
+    { ++f_num_empty; }
+    else
+    { AddValue(p_grid, p_cell, l_value_new); }
+}
+
+bool ConflictTracker::IsConflicting(unsigned int p_cell) const
+{
+    return f_num_reasons[p_cell] != 0;
+}
+
+const std::vector<unsigned int>& ConflictTracker::GetConflicts() const
+{
+    return f_conflicts;
+}
+
+unsigned int ConflictTracker::GetNumEmpty() const
+{
+    return f_num_empty;
+}
+
+
+/* Auxiliary of Update
+
+* Notes:
+    (a). When the value appears a second time in a unit, the cell that already held it starts to conflict as well;
+         when it appears a third time or more, the others are already conflicting.
+*/
+void ConflictTracker::AddValue(const CompactGrid& p_grid, unsigned int p_cell, unsigned int p_value)
+{
+    if (p_value > f_size_grid)
+    {
+        AddReason(p_cell);
+        return;
+    }
+
+    unsigned int l_row = p_cell / f_size_grid;
+    unsigned int l_col = p_cell % f_size_grid;
+    unsigned int l_units[3] = { l_row, f_size_grid + l_col,
+                                2 * f_size_grid + (l_row / f_height_box) * f_height_box + l_col / f_width_box };
+
+    for (unsigned int l_unit : l_units)
+    {
+        unsigned char& l_count = f_counts[l_unit * (f_size_grid + 1) + p_value];
+
+        // (a).
+        if (++l_count == 2)
+        { AddReason(FindOther(p_grid, l_unit, p_cell, p_value)); }
+
+        if (l_count >= 2)
+        { AddReason(p_cell); }
+    }
+
+}
+
+/* Auxiliary of Update
+
+* Notes:
+    (a). When the value is left in only one cell of a unit, that cell no longer conflicts because of it.
+*/
+void ConflictTracker::RemoveValue(const CompactGrid& p_grid, unsigned int p_cell, unsigned int p_value)
+{
+    if (p_value > f_size_grid)
+    {
+        RemoveReason(p_cell);
+        return;
+    }
+
+    unsigned int l_row = p_cell / f_size_grid;
+    unsigned int l_col = p_cell % f_size_grid;
+    unsigned int l_units[3] = { l_row, f_size_grid + l_col,
+                                2 * f_size_grid + (l_row / f_height_box) * f_height_box + l_col / f_width_box };
+
+    for (unsigned int l_unit : l_units)
+    {
+        unsigned char& l_count = f_counts[l_unit * (f_size_grid + 1) + p_value];
+
+        if (l_count >= 2)
+        { RemoveReason(p_cell); }
+
+        // (a).
+        if (--l_count == 1)
+        { RemoveReason(FindOther(p_grid, l_unit, p_cell, p_value)); }
+    }
+
+}
+
+/* Auxiliary of AddValue, RemoveValue
+
+* Notes:
+    (a). The boxes of each row of boxes are numbered left to right, and there are f_height_box of them per row of
+         boxes (as in SudokuSolver).
+*/
+unsigned int ConflictTracker::FindOther(const CompactGrid& p_grid, unsigned int p_unit, unsigned int p_cell,
+                                        unsigned int p_value) const
+{
+    for (unsigned int i = 0; i < f_size_grid; ++i)
+    {
+        unsigned int l_cell;
+
+        if (p_unit < f_size_grid)
+        { l_cell = p_unit * f_size_grid + i; }
+        else if (p_unit < 2 * f_size_grid)
+        { l_cell = i * f_size_grid + (p_unit - f_size_grid); }
+        else
+        {
+            // (a).
+            unsigned int l_box = p_unit - 2 * f_size_grid;
+            unsigned int l_row = (l_box / f_height_box) * f_height_box + i / f_width_box;
+            unsigned int l_col = (l_box % f_height_box) * f_width_box + i % f_width_box;
+
+            l_cell = l_row * f_size_grid + l_col;
+        }
+
+        if (l_cell != p_cell && p_grid[l_cell] == p_value)
+        { return l_cell; }
+    }
+
+    return p_cell;
+}
+
+/* Auxiliary of AddValue, RemoveValue
+*/
+void ConflictTracker::AddReason(unsigned int p_cell)
+{
+    if (f_num_reasons[p_cell]++ == 0)
+    {
+        f_positions[p_cell] = static_cast<unsigned int>(f_conflicts.size());
+        f_conflicts.push_back(p_cell);
+    }
+
+}
+
+/* Auxiliary of AddValue, RemoveValue
+
+* Notes:
+    (a). The cell is replaced by the last of the set, so that the removal doesn't shift the others.
+*/
+void ConflictTracker::RemoveReason(unsigned int p_cell)
+{
+    if (--f_num_reasons[p_cell] == 0)
+    {
+        // (a).
+        unsigned int l_last = f_conflicts.back();
+
+        f_conflicts[f_positions[p_cell]] = l_last;
+        f_positions[l_last] = f_positions[p_cell];
+        f_conflicts.pop_back();
+    }
+
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include<vector>
+
+#include"CompactGrid.h"
+
+
+/*
+* Keeps track of which cells of a grid conflict with the rules of sudoku, so that a change to one cell can be checked
+  without rescanning the grid.
+* For every unit (row, column and box) it counts the cells holding each value; a cell conflicts if its value appears
+  more than once in any of its units, or if the value is greater than the size of the grid. The conflicting cells are
+  kept in a set, so whether the grid is valid, and which cells break it, is known at any time.
+* Reset builds the counts from a whole grid in O(N^2) for an N by N grid; Update then follows a change to one cell in
+  O(1), plus a scan of a unit (O(N)) whenever a value starts or stops appearing twice in it.
+*/
+class ConflictTracker
+{
+
+private:
+
+    // The dimensions of the boxes, and of the grid.
+    unsigned int f_width_box;
+    unsigned int f_height_box;
+    unsigned int f_size_grid;
+
+    // Whether or not the counts follow the grid (see Reset and Invalidate).
+    bool f_is_current;
+
+    // The number of cells holding each value in each unit: unit u's count of value v is at index u * (N + 1) + v. The
+    // units are the rows (0 to N - 1), then the columns (N to 2N - 1), then the boxes (2N to 3N - 1).
+    std::vector<unsigned char> f_counts;
+
+    // The number of reasons each cell conflicts: one per unit in which its value appears more than once, plus one if
+    // the value is out of range.
+    std::vector<unsigned char> f_num_reasons;
+
+    // The conflicting cells (those with at least one reason), in no particular order, and the position of each cell
+    // within f_conflicts (only meaningful for the cells in it).
+    std::vector<unsigned int> f_conflicts;
+    std::vector<unsigned int> f_positions;
+
+    // The number of empty cells.
+    unsigned int f_num_empty;
+
+
+public:
+
+    ConflictTracker();
+
+    /*
+    * Builds the counts from p_grid, whose boxes are p_width_box by p_height_box.
+    */
+    void Reset(const CompactGrid& p_grid, unsigned int p_width_box, unsigned int p_height_box);
+
+    /*
+    * Marks the counts as no longer following the grid, e.g. after the whole of it has been overwritten; Reset must be
+      called before they're used again.
+    */
+    void Invalidate();
+
+    bool IsCurrent() const;
+
+    /*
+    * Follows the change of the cell at index p_cell from p_value_old to the value that p_grid now holds there.
+    */
+    void Update(const CompactGrid& p_grid, unsigned int p_cell, unsigned int p_value_old);
+
+    bool IsConflicting(unsigned int p_cell) const;
+
+    /*
+    * Returns the indices (row * N + col) of the conflicting cells, in no particular order.
+    */
+    const std::vector<unsigned int>& GetConflicts() const;
+
+    unsigned int GetNumEmpty() const;
+
+
+private:
+
+    /* Auxiliary of Update
+    * Count/uncount the value p_value of the cell at index p_cell, updating the reasons of the cells that conflict
+      with it; p_grid must no longer hold p_value there when removing it.
+    */
+    void AddValue(const CompactGrid& p_grid, unsigned int p_cell, unsigned int p_value);
+    void RemoveValue(const CompactGrid& p_grid, unsigned int p_cell, unsigned int p_value);
+
+    /* Auxiliary of AddValue, RemoveValue
+    * Returns the index of the cell other than p_cell in unit p_unit that holds p_value; there must be one.
+    */
+    unsigned int FindOther(const CompactGrid& p_grid, unsigned int p_unit, unsigned int p_cell,
+                           unsigned int p_value) const;
+
+    /* Auxiliary of AddValue, RemoveValue
+    * Add/remove one reason for the cell at index p_cell to conflict, adding it to/removing it from f_conflicts when
+      it's its first/last.
+    */
+    void AddReason(unsigned int p_cell);
+    void RemoveReason(unsigned int p_cell);
+
+};
@@ -0,0 +1,363 @@
+#include"DancingLinksSolver.h"
+
+#include<algorithm>
+
+
+DancingLinksSolver::DancingLinksSolver()
+    : f_width_box(0), f_height_box(0), f_size_grid(0), f_num_cells(0), f_num_columns(0), f_num_givens(0),
+      f_visit(nullptr), f_stats()
+{
+}
+
+/*
+* Notes:
+    (a). The matrix only depends on the dimensions of the grid; as Solve always returns it to its unreduced state, it
+         can be reused for the next grid of the same dimensions.
+    (b). A pre-filled value conflicts with another if one of the columns of its row has already been covered by a
+         previous pre-filled value: i.e. the cell, or the digit in the cell's row, column or box, is already taken.
+*/
+bool DancingLinksSolver::Load(const CompactGrid& p_grid, unsigned int p_width_box, unsigned int p_height_box)
+{
+    // Undo the selection of a previous grid's pre-filled cells if Solve wasn't called for it.
+    DeselectGivens();
+
+    f_stats.ClearSearch();
+
+    // (a).
+    if (p_width_box != f_width_box || p_height_box != f_height_box)
+    {
+        f_width_box = p_width_box;
+        f_height_box = p_height_box;
+        f_size_grid = f_width_box * f_height_box;
+        f_num_cells = f_size_grid * f_size_grid;
+        f_num_columns = 4 * f_num_cells;
+
+        f_cells.resize(f_num_cells);
+        f_selected.reserve(f_num_cells);
+
+        BuildMatrix();
+    }
+
+    for (unsigned int row = 0; row < f_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < f_size_grid; ++col)
+        {
+            unsigned int l_cell = row * f_size_grid + col;
+            unsigned int l_value = p_grid[l_cell];
+
+            f_cells[l_cell] = l_value;
+
+            if (l_value == S_VALUE_EMPTY_CELL)
+            { continue; }
+
+            if (l_value > f_size_grid)
+            {
+                DeselectGivens();
+                return false;
+            }
+
+            unsigned int l_node = FirstNodeOfRow(l_cell, l_value);
+
+            // (b).
+            for (unsigned int i = 0; i < S_NODES_PER_ROW; ++i)
+            {
+                if (f_is_covered[f_column[l_node + i]])
+                {
+                    DeselectGivens();
+                    return false;
+                }
+            }
+
+            Cover(f_column[l_node]);
+            SelectRow(l_node);
+
+            f_selected.push_back(l_node);
+            ++f_num_givens;
+        }
+
+    }
+
+    return true;
+}
+
+void DancingLinksSolver::Store(CompactGrid& p_grid) const
+{
+    for (unsigned int row = 0; row < f_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < f_size_grid; ++col)
+        {
+            p_grid.Set(row, col, f_cells[row * f_size_grid + col]);
+        }
+
+    }
+
+}
+
+bool DancingLinksSolver::Solve()
+{
+    bool l_is_solved = Search();
+
+    DeselectGivens();
+
+    return l_is_solved;
+}
+
+unsigned long long DancingLinksSolver::Enumerate(const std::function<bool()>& p_visit)
+{
+    unsigned long long l_num_solutions = 0;
+
+    std::function<bool()> l_visit = [&]()
+    {
+        ++l_num_solutions;
+        return p_visit();
+    };
+
+    f_visit = &l_visit;
+    Solve();
+    f_visit = nullptr;
+
+    return l_num_solutions;
+}
+
+void DancingLinksSolver::SetBudget(SearchBudget* p_budget)
+{
+    f_meter.Start(p_budget);
+}
+
+const SolverStats& DancingLinksSolver::GetStats() const
+{
+    return f_stats;
+}
+
+
+/* Auxiliary of Load
+
+* Notes:
+    (a). The header list is circular: the root's right neighbour is the first column, and the last column's right
+         neighbour is the root. Each column's vertical list is also circular, with the header as its sentinel.
+    (b). The row that corresponds to placing digit d (1-based) at (row, col) in box 'box' covers the columns:
+            cell:         cell
+            row-digit:    f_num_cells + row * f_size_grid + (d - 1)
+            column-digit: 2 * f_num_cells + col * f_size_grid + (d - 1)
+            box-digit:    3 * f_num_cells + box * f_size_grid + (d - 1)
+         each offset by 1 to account for the root node.
+    (c). Appending each node to the bottom of its column keeps the rows of each column in ascending order, so the
+         digits of a cell are tried in ascending order, as they are in SudokuSolver.
+*/
+void DancingLinksSolver::BuildMatrix()
+{
+    unsigned int l_num_nodes = 1 + f_num_columns + S_NODES_PER_ROW * f_num_cells * f_size_grid;
+
+    f_left.resize(l_num_nodes);
+    f_right.resize(l_num_nodes);
+    f_up.resize(l_num_nodes);
+    f_down.resize(l_num_nodes);
+    f_column.resize(l_num_nodes);
+    f_size_column.assign(1 + f_num_columns, 0);
+    f_is_covered.assign(1 + f_num_columns, false);
+
+    // (a).
+    for (unsigned int i = 0; i <= f_num_columns; ++i)
+    {
+        f_left[i] = i == 0 ? f_num_columns : i - 1;
+        f_right[i] = i == f_num_columns ? 0 : i + 1;
+        f_up[i] = f_down[i] = f_column[i] = i;
+    }
+
+    for (unsigned int row = 0; row < f_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < f_size_grid; ++col)
+        {
+            unsigned int l_cell = row * f_size_grid + col;
+            unsigned int l_box = (row / f_height_box) * f_height_box + col / f_width_box;
+
+            for (unsigned int value = 1; value <= f_size_grid; ++value)
+            {
+                unsigned int l_node = FirstNodeOfRow(l_cell, value);
+
+                // (b).
+                unsigned int l_columns[S_NODES_PER_ROW] =
+                {
+                    1 + l_cell,
+                    1 + f_num_cells + row * f_size_grid + (value - 1),
+                    1 + 2 * f_num_cells + col * f_size_grid + (value - 1),
+                    1 + 3 * f_num_cells + l_box * f_size_grid + (value - 1)
+                };
+
+                for (unsigned int i = 0; i < S_NODES_PER_ROW; ++i)
+                {
+                    unsigned int l_current = l_node + i;
+                    unsigned int l_header = l_columns[i];
+
+                    f_left[l_current] = l_node + (i + S_NODES_PER_ROW - 1) % S_NODES_PER_ROW;
+                    f_right[l_current] = l_node + (i + 1) % S_NODES_PER_ROW;
+
+                    // (c).
+                    f_column[l_current] = l_header;
+                    f_up[l_current] = f_up[l_header];
+                    f_down[l_current] = l_header;
+                    f_down[f_up[l_header]] = l_current;
+                    f_up[l_header] = l_current;
+
+                    ++f_size_column[l_header];
+                }
+
+            }
+
+        }
+
+    }
+
+}
+
+/* Auxiliary of Solve
+* Returns true if a solution was found, or, when enumerating, if f_visit stopped the search.
+
+* Notes:
+    (a). If every column has been covered, the selected rows form a solution. Each selected node may be any of the
+         nodes of its row, but as the nodes of a row are contiguous, dividing by the number of nodes per row gives the
+         index of the row, which is cell * f_size_grid + (value - 1).
+    (b). Choose the column with the fewest rows (Knuth's 'S heuristic'), stopping early if one with zero or one rows is
+         found; a column with no rows means that the current branch is a dead end.
+    (c). The matrix is restored before returning, even when a solution was found, so that it can be reused.
+    (d). When enumerating, returning false (unless told to stop) makes the search carry on as if this were a dead end.
+    (e). The depth of the node is the number of rows that the search has selected.
+    (f). A search that has run out of budget gives up, unwinding its recursion without trying any more rows.
+*/
+bool DancingLinksSolver::Search()
+{
+    // (f).
+    if (!f_meter.Tick())
+    { return false; }
+
+    // (e).
+    SUDOKU_STAT(++f_stats.nodes);
+    SUDOKU_STAT(f_stats.max_depth = std::max<unsigned long long>(f_stats.max_depth, f_selected.size() - f_num_givens));
+
+    // (a).
+    if (f_right[0] == 0)
+    {
+        for (unsigned int i = f_num_givens; i < f_selected.size(); ++i)
+        {
+            unsigned int l_row = (f_selected[i] - 1 - f_num_columns) / S_NODES_PER_ROW;
+
+            f_cells[l_row / f_size_grid] = l_row % f_size_grid + 1;
+        }
+
+        // (d).
+        return f_visit == nullptr || !(*f_visit)();
+    }
+
+    // (b).
+    unsigned int l_column = f_right[0];
+    for (unsigned int c = f_right[l_column]; c != 0 && f_size_column[l_column] > 1; c = f_right[c])
+    {
+        if (f_size_column[c] < f_size_column[l_column])
+        { l_column = c; }
+    }
+
+    if (f_size_column[l_column] == 0)
+    {
+        SUDOKU_STAT(++f_stats.backtracks);
+        return false;
+    }
+
+    bool l_is_solved = false;
+
+    Cover(l_column);
+
+    // (f).
+    for (unsigned int r = f_down[l_column]; r != l_column && !l_is_solved && !f_meter.IsExhausted(); r = f_down[r])
+    {
+        SelectRow(r);
+        f_selected.push_back(r);
+
+        SUDOKU_STAT(++f_stats.placements);
+
+        l_is_solved = Search();
+
+        // (c).
+        f_selected.pop_back();
+        DeselectRow(r);
+    }
+
+    Uncover(l_column);
+
+    return l_is_solved;
+}
+
+void DancingLinksSolver::Cover(unsigned int p_column)
+{
+    f_is_covered[p_column] = true;
+
+    f_right[f_left[p_column]] = f_right[p_column];
+    f_left[f_right[p_column]] = f_left[p_column];
+
+    for (unsigned int i = f_down[p_column]; i != p_column; i = f_down[i])
+    {
+        for (unsigned int j = f_right[i]; j != i; j = f_right[j])
+        {
+            f_down[f_up[j]] = f_down[j];
+            f_up[f_down[j]] = f_up[j];
+            --f_size_column[f_column[j]];
+        }
+
+    }
+
+}
+
+void DancingLinksSolver::Uncover(unsigned int p_column)
+{
+    for (unsigned int i = f_up[p_column]; i != p_column; i = f_up[i])
+    {
+        for (unsigned int j = f_left[i]; j != i; j = f_left[j])
+        {
+            ++f_size_column[f_column[j]];
+            f_down[f_up[j]] = j;
+            f_up[f_down[j]] = j;
+        }
+
+    }
+
+    f_right[f_left[p_column]] = p_column;
+    f_left[f_right[p_column]] = p_column;
+
+    f_is_covered[p_column] = false;
+}
+
+void DancingLinksSolver::SelectRow(unsigned int p_node)
+{
+    for (unsigned int j = f_right[p_node]; j != p_node; j = f_right[j])
+    {
+        Cover(f_column[j]);
+    }
+
+}
+
+void DancingLinksSolver::DeselectRow(unsigned int p_node)
+{
+    for (unsigned int j = f_left[p_node]; j != p_node; j = f_left[j])
+    {
+        Uncover(f_column[j]);
+    }
+
+}
+
+void DancingLinksSolver::DeselectGivens()
+{
+    for (; f_num_givens > 0; --f_num_givens)
+    {
+        unsigned int l_node = f_selected.back();
+
+        f_selected.pop_back();
+
+        DeselectRow(l_node);
+        Uncover(f_column[l_node]);
+    }
+
+}
+
+unsigned int DancingLinksSolver::FirstNodeOfRow(unsigned int p_cell, unsigned int p_value) const
+{
+    return 1 + f_num_columns + S_NODES_PER_ROW * (p_cell * f_size_grid + (p_value - 1));
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include<functional>
+#include<vector>
+
+#include"CompactGrid.h"
+#include"SearchBudget.h"
+#include"SolverStats.h"
+
+
+/*
+* An alternative engine for SudokuBoard, which encodes the grid as an exact-cover problem and solves it with Knuth's
+  Algorithm X, implemented via the 'Dancing Links' technique.
+* Each possible placement (a digit in a cell) is a row of the exact-cover matrix, and each of the four kinds of rule of
+  sudoku is a group of columns:
+    (1). cell: each cell holds exactly one digit;
+    (2). row-digit: each row contains each digit exactly once;
+    (3). column-digit: each column contains each digit exactly once;
+    (4). box-digit: each box contains each digit exactly once.
+* A solution is a set of rows that covers every column exactly once.
+*/
+class DancingLinksSolver
+{
+
+private:
+
+    // The width of a box in the grid.
+    unsigned int f_width_box;
+
+    // The height of a box in the grid.
+    unsigned int f_height_box;
+
+    // The dimension (width/height) of the grid.
+    unsigned int f_size_grid;
+
+    // The number of cells in the grid (f_size_grid * f_size_grid).
+    unsigned int f_num_cells;
+
+    // The number of columns of the matrix (4 * f_num_cells).
+    unsigned int f_num_columns;
+
+    /*
+    * The nodes of the matrix. Node 0 is the root, nodes 1 to f_num_columns are the column headers, and the remaining
+      nodes are the 1s of the matrix, four per row (one for each constraint that the row satisfies).
+    * Each node is linked to its neighbours to the left/right (within its row) and up/down (within its column).
+    */
+    std::vector<unsigned int> f_left;
+    std::vector<unsigned int> f_right;
+    std::vector<unsigned int> f_up;
+    std::vector<unsigned int> f_down;
+
+    // The column header of each node.
+    std::vector<unsigned int> f_column;
+
+    // The number of (uncovered) nodes in each column, indexed by the column's header node.
+    std::vector<unsigned int> f_size_column;
+
+    // Whether or not each column is covered, indexed by the column's header node.
+    std::vector<bool> f_is_covered;
+
+    // The rows that are currently selected: the pre-filled cells first, followed by the choices of the search.
+    std::vector<unsigned int> f_selected;
+
+    // The number of entries at the start of f_selected that correspond to pre-filled cells.
+    unsigned int f_num_givens;
+
+    // The value of each cell, indexed by row * f_size_grid + col; filled in when a solution is found.
+    std::vector<unsigned int> f_cells;
+
+    // The function that Enumerate calls at each solution, or nullptr when the search stops at the first one.
+    const std::function<bool()>* f_visit;
+
+    // The meter of the search's budget (see SetBudget).
+    SearchBudget::Meter f_meter;
+
+    // The statistics of the search since the grid was loaded (see SolverStats; only the counters are used). Each
+    // selection of a row by the search is a node and a placement; there's no propagation.
+    SolverStats f_stats;
+
+
+    // The value used for empty cells in the grid.
+    static const unsigned int S_VALUE_EMPTY_CELL = 0;
+
+    // The number of nodes in each row of the matrix.
+    static const unsigned int S_NODES_PER_ROW = 4;
+
+
+public:
+
+    DancingLinksSolver();
+
+    /*
+    * Builds the matrix for the given dimensions (if they differ from the previous grid's) and selects the rows that
+      correspond to the grid's pre-filled cells.
+    * Returns false if any of the pre-filled cells violate the rules of sudoku (or hold a value that's out of range),
+      in which case Solve mustn't be called.
+    */
+    bool Load(const CompactGrid& p_grid, unsigned int p_width_box, unsigned int p_height_box);
+
+    /*
+    * Copies the solver's cells into the given grid, which must have the same dimensions as the loaded one.
+    */
+    void Store(CompactGrid& p_grid) const;
+
+    /*
+    * Tries to fill all of the empty cells of the loaded grid; returns whether or not this was possible.
+    * Whatever the result, the matrix is returned to its unreduced state.
+    */
+    bool Solve();
+
+    /*
+    * Searches for every solution of the loaded grid, calling p_visit at each one while the solver holds it (so that
+      it can be copied with Store); the search stops early if p_visit returns false.
+    * Returns the number of solutions visited. As with Solve, the matrix is returned to its unreduced state.
+    */
+    unsigned long long Enumerate(const std::function<bool()>& p_visit);
+
+    /*
+    * Sets the budget (already started; see SearchBudget::Start) that the next search spends a node of at each node
+      of its tree, giving up once it runs out (nullptr for none).
+    */
+    void SetBudget(SearchBudget* p_budget);
+
+    /*
+    * Returns the counters of the searches since the grid was loaded.
+    */
+    const SolverStats& GetStats() const;
+
+
+private:
+
+    /* Auxiliary of Load
+    * Creates the nodes and links of the (unreduced) matrix.
+    */
+    void BuildMatrix();
+
+    /* Auxiliary of Solve
+    * Recursively searches for a set of rows that covers all of the remaining columns.
+    */
+    bool Search();
+
+    /* Auxiliary of Load, Solve, Search
+    * Removes the column from the header list and removes the rows that intersect it from the other columns.
+    */
+    void Cover(unsigned int p_column);
+
+    /* Auxiliary of Load, Solve, Search
+    * Reverses the corresponding call to Cover.
+    */
+    void Uncover(unsigned int p_column);
+
+    /* Auxiliary of Load, Solve, Search
+    * Selects/deselects the given matrix row by covering/uncovering the columns of its nodes (other than p_node's).
+    */
+    void SelectRow(unsigned int p_node);
+    void DeselectRow(unsigned int p_node);
+
+    /* Auxiliary of Load, Solve
+    * Deselects the rows of the pre-filled cells, which returns the matrix to its unreduced state.
+    */
+    void DeselectGivens();
+
+    /*
+    * Returns the first node of the matrix row that corresponds to placing p_value in p_cell.
+    */
+    unsigned int FirstNodeOfRow(unsigned int p_cell, unsigned int p_value) const;
+
+};
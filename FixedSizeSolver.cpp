@@ -0,0 +1,27 @@
+#include"FixedSizeSolver.h"
+
+
+template class FixedSizeSolver<2, 2>;
+template class FixedSizeSolver<3, 2>;
+template class FixedSizeSolver<3, 3>;
+template class FixedSizeSolver<4, 3>;
+template class FixedSizeSolver<4, 4>;
+template class FixedSizeSolver<5, 5>;
+
+
+std::unique_ptr<FixedSizeSolverBase> FixedSizeSolverBase::Create(unsigned int p_width_box, unsigned int p_height_box)
+{
+    FixedSizeSolverBase* l_solver = nullptr;
+
+    switch (p_width_box * 16 + p_height_box)
+    {
+    case 2 * 16 + 2: l_solver = new FixedSizeSolver<2, 2>(); break;
+    case 3 * 16 + 2: l_solver = new FixedSizeSolver<3, 2>(); break;
+    case 3 * 16 + 3: l_solver = new FixedSizeSolver<3, 3>(); break;
+    case 4 * 16 + 3: l_solver = new FixedSizeSolver<4, 3>(); break;
+    case 4 * 16 + 4: l_solver = new FixedSizeSolver<4, 4>(); break;
+    case 5 * 16 + 5: l_solver = new FixedSizeSolver<5, 5>(); break;
+    }
+
+    return std::unique_ptr<FixedSizeSolverBase>(l_solver);
+}
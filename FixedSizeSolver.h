@@ -0,0 +1,669 @@
+#pragma once
+
+#include<algorithm>
+#include<cstring>
+#include<functional>
+#include<memory>
+#include<vector>
+
+#include"CompactGrid.h"
+#include"BitUtils.h"
+#include"BitboardKernel.h"
+#include"SearchBudget.h"
+#include"SolverStats.h"
+
+
+/*
+* The lookup tables of a grid whose boxes are W cells wide and H cells tall, computed at compile time.
+* Units 0 to N - 1 are the rows, units N to 2N - 1 the columns and units 2N to 3N - 1 the boxes (where N = W * H);
+  the boxes are numbered in the same way as in SudokuSolver.
+*/
+template <unsigned int W, unsigned int H>
+struct FixedSizeTables
+{
+    static const unsigned int S_SIZE_GRID = W * H;
+    static const unsigned int S_NUM_CELLS = S_SIZE_GRID * S_SIZE_GRID;
+    static const unsigned int S_NUM_UNITS = 3 * S_SIZE_GRID;
+
+    // The number of peers of each cell: the other cells of its row and column, plus those of its box that are in
+    // neither.
+    static const unsigned int S_NUM_PEERS = 2 * (S_SIZE_GRID - 1) + (W - 1) * (H - 1);
+
+    // The peers of each cell.
+    unsigned short peers[S_NUM_CELLS][S_NUM_PEERS];
+
+    // The cells of each unit.
+    unsigned short unit_cells[S_NUM_UNITS][S_SIZE_GRID];
+
+    // The box of each cell.
+    unsigned char box_of_cell[S_NUM_CELLS];
+
+    /*
+    * Notes:
+        (a). The peers of a cell are listed row first, then column, then the cells of the box that share neither its
+             row nor its column, so that no peer is listed twice.
+    */
+    constexpr FixedSizeTables()
+        : peers(), unit_cells(), box_of_cell()
+    {
+        for (unsigned int i = 0; i < S_SIZE_GRID; ++i)
+        {
+            unsigned int l_row_min_box = (i / H) * H;
+            unsigned int l_col_min_box = (i % H) * W;
+
+            for (unsigned int j = 0; j < S_SIZE_GRID; ++j)
+            {
+                unit_cells[i][j] = static_cast<unsigned short>(i * S_SIZE_GRID + j);
+                unit_cells[S_SIZE_GRID + i][j] = static_cast<unsigned short>(j * S_SIZE_GRID + i);
+                unit_cells[2 * S_SIZE_GRID + i][j] =
+                    static_cast<unsigned short>((l_row_min_box + j / W) * S_SIZE_GRID + l_col_min_box + j % W);
+            }
+
+        }
+
+        // (a).
+        for (unsigned int cell = 0; cell < S_NUM_CELLS; ++cell)
+        {
+            unsigned int l_row = cell / S_SIZE_GRID;
+            unsigned int l_col = cell % S_SIZE_GRID;
+            unsigned int l_row_min_box = l_row - l_row % H;
+            unsigned int l_col_min_box = l_col - l_col % W;
+            unsigned int l_num_peers = 0;
+
+            box_of_cell[cell] = static_cast<unsigned char>((l_row / H) * H + l_col / W);
+
+            for (unsigned int i = 0; i < S_SIZE_GRID; ++i)
+            {
+                if (i != l_col)
+                { peers[cell][l_num_peers++] = static_cast<unsigned short>(l_row * S_SIZE_GRID + i); }
+            }
+
+            for (unsigned int i = 0; i < S_SIZE_GRID; ++i)
+            {
+                if (i != l_row)
+                { peers[cell][l_num_peers++] = static_cast<unsigned short>(i * S_SIZE_GRID + l_col); }
+            }
+
+            for (unsigned int row = l_row_min_box; row < l_row_min_box + H; ++row)
+            {
+                for (unsigned int col = l_col_min_box; col < l_col_min_box + W; ++col)
+                {
+                    if (row != l_row && col != l_col)
+                    { peers[cell][l_num_peers++] = static_cast<unsigned short>(row * S_SIZE_GRID + col); }
+                }
+
+            }
+
+        }
+
+    }
+};
+
+
+/*
+* The interface through which SudokuBoard uses a FixedSizeSolver without knowing its dimensions at compile time.
+*/
+class FixedSizeSolverBase
+{
+
+public:
+
+    virtual ~FixedSizeSolverBase() {}
+
+    virtual unsigned int GetWidthBox() const = 0;
+    virtual unsigned int GetHeightBox() const = 0;
+
+    /*
+    * Copies p_grid (whose dimensions must match the solver's) into the solver, as SudokuSolver::Load does.
+    * Returns false if any of the pre-filled cells violate the rules of sudoku (or hold a value that's out of range),
+      in which case neither Solve nor Enumerate may be called.
+    */
+    virtual bool Load(const CompactGrid& p_grid) = 0;
+
+    /*
+    * Tries to fill all of the empty cells of the loaded grid, and returns whether or not this was possible; if it was,
+      the solution can be copied with Store.
+    */
+    virtual bool Solve() = 0;
+
+    /*
+    * Searches for every solution of the loaded grid, calling p_visit at each one while the solver holds it (so that
+      it can be copied with Store); the search stops early if p_visit returns false.
+    * Returns the number of solutions visited.
+    */
+    virtual unsigned long long Enumerate(const std::function<bool()>& p_visit) = 0;
+
+    /*
+    * Sets the budget (already started; see SearchBudget::Start) that the next search spends a node of at each node
+      of its tree, giving up once it runs out (nullptr for none).
+    */
+    virtual void SetBudget(SearchBudget* p_budget) = 0;
+
+    /*
+    * Copies the solution found by Solve, or the one that's being visited by Enumerate, into p_grid.
+    */
+    virtual void Store(CompactGrid& p_grid) const = 0;
+
+    /*
+    * Returns the counters of the searches since the grid was loaded.
+    */
+    virtual const SolverStats& GetStats() const = 0;
+
+    /*
+    * Returns a solver for boxes of the given dimensions, or nullptr if there's no specialisation for them (see
+      FixedSizeSolver.cpp), in which case the generic SudokuSolver must be used.
+    */
+    static std::unique_ptr<FixedSizeSolverBase> Create(unsigned int p_width_box, unsigned int p_height_box);
+
+};
+
+
+/*
+* A solver for grids whose boxes are W cells wide and H cells tall, which are fixed at compile time so that the
+  dimensions, the peer and unit tables (see FixedSizeTables) and the bounds of every loop are constants; the compiler
+  can then fold the index arithmetic and unroll the loops over peers and units.
+* It implements SudokuSolver's default settings only: naked and hidden singles at every step of the search, and
+  branching on the most constrained cell (the lowest in row-major order among ties), so the solution it finds is the
+  one SudokuSolver would find with those settings.
+* Rather than keeping an undo trail, each step of the search works on its own copy of the state, which (being of
+  fixed size) is a plain memberwise copy. The search is iterative, and the states of all of the steps are allocated
+  once, by the constructor, so it neither allocates nor uses more of the call stack as it goes deeper.
+* For 9x9 and 16x16 grids, the singles are found by a vectorised kernel when the CPU supports one (see
+  BitboardKernel).
+*/
+template <unsigned int W, unsigned int H>
+class FixedSizeSolver : public FixedSizeSolverBase
+{
+
+private:
+
+    typedef FixedSizeTables<W, H> Tables;
+
+    static const unsigned int S_SIZE_GRID = Tables::S_SIZE_GRID;
+    static const unsigned int S_NUM_CELLS = Tables::S_NUM_CELLS;
+    static const unsigned int S_NUM_UNITS = Tables::S_NUM_UNITS;
+    static const unsigned int S_NUM_PEERS = Tables::S_NUM_PEERS;
+
+    static_assert(S_SIZE_GRID <= 32, "the digits of a FixedSizeSolver must fit in an unsigned int");
+
+    typedef BitboardKernel<W, H> Kernel;
+
+    // A set of digits: bit (d - 1) is set if the digit d is in the set.
+    typedef typename Kernel::Mask Mask;
+
+    // The number of unused elements at the end of each array of State, for the kernel.
+    static const unsigned int S_PADDING = Kernel::S_PADDING;
+
+    // The set of all digits (1 to S_SIZE_GRID).
+    static const Mask S_MASK_ALL = static_cast<Mask>(MaskOfLowestBits(S_SIZE_GRID));
+
+    // The value used for empty cells in the grid.
+    static const unsigned char S_VALUE_EMPTY_CELL = 0;
+
+    static constexpr Tables S_TABLES = Tables();
+
+    /*
+    * The state of the grid at one step of the search.
+    */
+    struct State
+    {
+        // The value of each cell, indexed by row * S_SIZE_GRID + col.
+        unsigned char cells[S_NUM_CELLS + S_PADDING];
+
+        // The candidates of each empty cell (0 for a filled cell).
+        Mask candidates[S_NUM_CELLS + S_PADDING];
+
+        // The digits that are used in each unit.
+        Mask used[S_NUM_UNITS];
+
+        // The number of cells that are empty.
+        unsigned int num_empty;
+    };
+
+    // The state of each step of the search; a step places at least one value, so there are at most S_NUM_CELLS steps
+    // after the initial state. The states are value-initialised, so the padding of their arrays is 0.
+    std::vector<State> f_states;
+
+    // The cell that each node on the path to the current node branches on, and its candidates that are yet to be tried.
+    struct Branch
+    {
+        unsigned int cell;
+        Mask candidates;
+    };
+    std::vector<Branch> f_branches;
+
+    // The vectorised kernel for the CPU, whose functions are nullptr if there isn't one.
+    Kernel f_kernel;
+
+    // The solution found by Solve or being visited by Enumerate, or nullptr.
+    const State* f_solution;
+
+    // The statistics of the search since the grid was loaded (see SolverStats; only the counters are used).
+    SolverStats f_stats;
+
+    // The meter of the search's budget (see SetBudget).
+    SearchBudget::Meter f_meter;
+
+
+public:
+
+    FixedSizeSolver()
+        : f_states(S_NUM_CELLS + 1), f_branches(S_NUM_CELLS), f_kernel(Kernel::Select()), f_solution(nullptr),
+          f_stats()
+    {
+    }
+
+    unsigned int GetWidthBox() const override
+    {
+        return W;
+    }
+
+    unsigned int GetHeightBox() const override
+    {
+        return H;
+    }
+
+    /*
+    * Notes:
+        (a). The grid is copied into f_states[0], the state that Search starts from.
+        (b). A pre-filled value conflicts with another if it's no longer a candidate of its cell.
+    */
+    bool Load(const CompactGrid& p_grid) override
+    {
+        f_solution = nullptr;
+        f_stats.ClearSearch();
+
+        // (a).
+        State& l_state = f_states[0];
+
+        l_state.num_empty = S_NUM_CELLS;
+
+        for (unsigned int cell = 0; cell < S_NUM_CELLS; ++cell)
+        {
+            l_state.cells[cell] = S_VALUE_EMPTY_CELL;
+            l_state.candidates[cell] = S_MASK_ALL;
+        }
+
+        for (unsigned int unit = 0; unit < S_NUM_UNITS; ++unit)
+        {
+            l_state.used[unit] = 0;
+        }
+
+        for (unsigned int cell = 0; cell < S_NUM_CELLS; ++cell)
+        {
+            unsigned int l_value = p_grid[cell];
+
+            if (l_value == S_VALUE_EMPTY_CELL)
+            { continue; }
+
+            // (b).
+            if (l_value > S_SIZE_GRID || !(l_state.candidates[cell] & (1U << (l_value - 1))))
+            { return false; }
+
+            if (!Assign(l_state, cell, l_value))
+            { return false; }
+        }
+
+        return true;
+    }
+
+    /*
+    * Notes:
+        (a). The search stops at the first solution, which stays in f_states until the next call to Load.
+    */
+    bool Solve() override
+    {
+        // (a).
+        f_solution = Search([](const State&) { return false; });
+
+        return f_solution != nullptr;
+    }
+
+    unsigned long long Enumerate(const std::function<bool()>& p_visit) override
+    {
+        unsigned long long l_num_solutions = 0;
+
+        Search([&](const State& p_solution)
+        {
+            ++l_num_solutions;
+
+            f_solution = &p_solution;
+            bool l_is_wanted = p_visit();
+            f_solution = nullptr;
+
+            return l_is_wanted;
+        });
+
+        return l_num_solutions;
+    }
+
+    void SetBudget(SearchBudget* p_budget) override
+    {
+        f_meter.Start(p_budget);
+    }
+
+    void Store(CompactGrid& p_grid) const override
+    {
+        Store(*f_solution, p_grid);
+    }
+
+    const SolverStats& GetStats() const override
+    {
+        return f_stats;
+    }
+
+
+private:
+
+    /* Auxiliary of Store
+    * Copies the cells of p_state into p_grid; both hold a byte per cell in row-major order.
+    */
+    static void Store(const State& p_state, CompactGrid& p_grid)
+    {
+        std::memcpy(&p_grid[0], p_state.cells, S_NUM_CELLS);
+    }
+
+    /* Auxiliary of Solve, Enumerate
+    * Searches from the state f_states[0], iteratively: f_states[d] is the state of the node at depth d of the path to
+      the current node, and f_branches[d] the cell that it branches on and the candidates that are yet to be tried.
+    * p_visit is called with each solved state, and returns whether or not the search should carry on; being a template
+      parameter, it costs nothing when Solve stops at the first solution.
+    * Returns the solved state at which p_visit stopped the search, or nullptr if there was none.
+
+    * Notes:
+        (a). A node is 'entered' once its state has been set; the node is propagated and, unless it's a dead end or
+             solved, branched on.
+        (b). Find the empty cell with the fewest candidates; a cell with two is the best that can be found after
+             propagation, as it leaves no cells with one.
+        (c). Each value is tried on a fresh copy of the parent's state, so there's nothing to undo when it fails.
+        (d). To carry on past a solution, the search backtracks from it as if it were a dead end.
+        (e). Each value that's tried is a node at the depth of the number of nodes that are being branched on; it's a
+             dead end if placing the value, or propagating it, leaves a cell without any candidates.
+        (f). A search that has run out of budget gives up as if it had found no solution.
+    */
+    template <class Visit>
+    const State* Search(Visit p_visit)
+    {
+        // The number of nodes on the path that are being branched on.
+        unsigned int l_num_open = 0;
+
+        SUDOKU_STAT(++f_stats.nodes);
+
+        // (f).
+        if (!f_meter.Tick())
+        { return nullptr; }
+
+        // (a).
+        bool l_is_entering = true;
+
+        for (;;)
+        {
+            if (l_is_entering)
+            {
+                l_is_entering = false;
+
+                State& l_state = f_states[l_num_open];
+
+                if (!Propagate(l_state))
+                {
+                    SUDOKU_STAT(++f_stats.backtracks);
+                }
+                else
+                {
+                    // (d).
+                    if (l_state.num_empty == 0)
+                    {
+                        if (!p_visit(l_state))
+                        { return &l_state; }
+
+                        continue;
+                    }
+
+                    // (b).
+                    unsigned int l_cell = 0;
+                    unsigned int l_fewest = S_SIZE_GRID + 1;
+
+                    for (unsigned int cell = 0; cell < S_NUM_CELLS && l_fewest > 2; ++cell)
+                    {
+                        if (l_state.cells[cell] != S_VALUE_EMPTY_CELL)
+                        { continue; }
+
+                        unsigned int l_num_candidates = CountBits(l_state.candidates[cell]);
+
+                        if (l_num_candidates < l_fewest)
+                        {
+                            l_cell = cell;
+                            l_fewest = l_num_candidates;
+                        }
+                    }
+
+                    f_branches[l_num_open] = Branch{ l_cell, l_state.candidates[l_cell] };
+                    ++l_num_open;
+                }
+
+            }
+
+            if (l_num_open == 0)
+            { return nullptr; }
+
+            Branch& l_branch = f_branches[l_num_open - 1];
+
+            if (l_branch.candidates == 0)
+            {
+                --l_num_open;
+                continue;
+            }
+
+            unsigned int l_value = IndexLowestBit(l_branch.candidates) + 1;
+            l_branch.candidates &= l_branch.candidates - 1;
+
+            // (f).
+            if (!f_meter.Tick())
+            { return nullptr; }
+
+            // (c).
+            State& l_next = f_states[l_num_open];
+            l_next = f_states[l_num_open - 1];
+
+            l_is_entering = Assign(l_next, l_branch.cell, l_value);
+
+            // (e).
+            SUDOKU_STAT(++f_stats.nodes);
+            SUDOKU_STAT(++f_stats.placements);
+            SUDOKU_STAT(f_stats.max_depth = std::max<unsigned long long>(f_stats.max_depth, l_num_open));
+            SUDOKU_STAT(f_stats.backtracks += !l_is_entering);
+        }
+
+    }
+
+    /* Auxiliary of Load, Search, Propagate
+    * Places p_value at the (empty) cell p_cell and removes it from the candidates of the cell's peers.
+    * Returns false if this leaves an empty peer without any candidates.
+    */
+    static bool Assign(State& p_state, unsigned int p_cell, unsigned int p_value)
+    {
+        Mask l_bit = 1U << (p_value - 1);
+        bool l_is_consistent = true;
+
+        p_state.cells[p_cell] = static_cast<unsigned char>(p_value);
+        p_state.candidates[p_cell] = 0;
+        --p_state.num_empty;
+
+        p_state.used[p_cell / S_SIZE_GRID] |= l_bit;
+        p_state.used[S_SIZE_GRID + p_cell % S_SIZE_GRID] |= l_bit;
+        p_state.used[2 * S_SIZE_GRID + S_TABLES.box_of_cell[p_cell]] |= l_bit;
+
+        const unsigned short* l_peers = S_TABLES.peers[p_cell];
+
+        for (unsigned int i = 0; i < S_NUM_PEERS; ++i)
+        {
+            Mask& l_candidates = p_state.candidates[l_peers[i]];
+
+            if (l_candidates & l_bit)
+            {
+                l_candidates &= ~l_bit;
+                l_is_consistent &= l_candidates != 0;
+            }
+        }
+
+        return l_is_consistent;
+    }
+
+    /* Auxiliary of Search
+    * Applies naked singles and then hidden singles until neither makes progress (as SudokuSolver::Propagate does).
+    * Returns false if a contradiction is found.
+
+    * Notes:
+        (a). The singles are found in a snapshot of the state (by the kernel, if there is one) and then placed one by
+             one. A cell that was a naked single in the snapshot may since have lost its last candidate.
+        (b). See SudokuSolver::ApplyHiddenSingles. Placing the hidden singles of previous units may have placed one of
+             the snapshot's hidden singles in this unit (so it's now in p_state.used), or left its digit without a
+             cell; the counts of the snapshot remain sound, as later states only have fewer candidates.
+        (c). The deductions of naked singles and hidden singles are at indexes 0 and 1 of SolverStats::deductions.
+    */
+    bool Propagate(State& p_state)
+    {
+        bool l_changed;
+
+        do
+        {
+            l_changed = false;
+
+            // (a).
+            Mask l_singles[S_SIZE_GRID];
+
+            bool l_is_consistent = f_kernel.find_naked_singles != nullptr ?
+                f_kernel.find_naked_singles(p_state.candidates, p_state.cells, l_singles) :
+                FindNakedSingles(p_state, l_singles);
+
+            if (!l_is_consistent)
+            { return false; }
+
+            for (unsigned int row = 0; row < S_SIZE_GRID; ++row)
+            {
+                for (Mask l_cols = l_singles[row]; l_cols != 0; l_cols &= l_cols - 1)
+                {
+                    unsigned int l_cell = row * S_SIZE_GRID + IndexLowestBit(l_cols);
+                    Mask l_candidates = p_state.candidates[l_cell];
+
+                    if (l_candidates == 0 || !Assign(p_state, l_cell, IndexLowestBit(l_candidates) + 1))
+                    { return false; }
+
+                    l_changed = true;
+
+                    // (c).
+                    SUDOKU_STAT(++f_stats.placements);
+                    SUDOKU_STAT(++f_stats.deductions[0]);
+                }
+
+            }
+
+            if (l_changed)
+            { continue; }
+
+            Mask l_once[S_NUM_UNITS];
+            Mask l_twice[S_NUM_UNITS];
+
+            if (f_kernel.count_units != nullptr)
+            { f_kernel.count_units(p_state.candidates, l_once, l_twice); }
+            else
+            { CountUnits(p_state, l_once, l_twice); }
+
+            // (b).
+            for (unsigned int unit = 0; unit < S_NUM_UNITS; ++unit)
+            {
+                const unsigned short* l_cells = S_TABLES.unit_cells[unit];
+
+                if ((l_once[unit] | p_state.used[unit]) != S_MASK_ALL)
+                { return false; }
+
+                for (Mask l_hidden = l_once[unit] & ~l_twice[unit] & ~p_state.used[unit]; l_hidden != 0;
+                     l_hidden &= l_hidden - 1)
+                {
+                    Mask l_bit = l_hidden & ~(l_hidden - 1);
+
+                    unsigned int i = 0;
+                    for (; i < S_SIZE_GRID && !(p_state.candidates[l_cells[i]] & l_bit); ++i);
+
+                    if (i == S_SIZE_GRID || !Assign(p_state, l_cells[i], IndexLowestBit(l_bit) + 1))
+                    { return false; }
+
+                    l_changed = true;
+
+                    // (c).
+                    SUDOKU_STAT(++f_stats.placements);
+                    SUDOKU_STAT(++f_stats.deductions[1]);
+                }
+
+            }
+
+        }
+        while (l_changed);
+
+        return true;
+    }
+
+    /* Auxiliary of Propagate
+    * The scalar equivalents of the kernel's functions (see BitboardKernel).
+    */
+    static bool FindNakedSingles(const State& p_state, Mask* p_singles)
+    {
+        for (unsigned int row = 0; row < S_SIZE_GRID; ++row)
+        {
+            p_singles[row] = 0;
+
+            for (unsigned int col = 0; col < S_SIZE_GRID; ++col)
+            {
+                unsigned int l_cell = row * S_SIZE_GRID + col;
+                Mask l_candidates = p_state.candidates[l_cell];
+
+                if (p_state.cells[l_cell] != S_VALUE_EMPTY_CELL || (l_candidates & (l_candidates - 1)) != 0)
+                { continue; }
+
+                if (l_candidates == 0)
+                { return false; }
+
+                p_singles[row] |= 1U << col;
+            }
+
+        }
+
+        return true;
+    }
+
+    static void CountUnits(const State& p_state, Mask* p_once, Mask* p_twice)
+    {
+        for (unsigned int unit = 0; unit < S_NUM_UNITS; ++unit)
+        {
+            const unsigned short* l_cells = S_TABLES.unit_cells[unit];
+
+            Mask l_once = 0;
+            Mask l_twice = 0;
+
+            for (unsigned int i = 0; i < S_SIZE_GRID; ++i)
+            {
+                Mask l_candidates = p_state.candidates[l_cells[i]];
+
+                l_twice |= l_once & l_candidates;
+                l_once |= l_candidates;
+            }
+
+            p_once[unit] = l_once;
+            p_twice[unit] = l_twice;
+        }
+
+    }
+
+};
+
+template <unsigned int W, unsigned int H>
+constexpr typename FixedSizeSolver<W, H>::Tables FixedSizeSolver<W, H>::S_TABLES;
+
+
+// The specialisations that are compiled (once) into FixedSizeSolver.cpp; see FixedSizeSolverBase::Create.
+extern template class FixedSizeSolver<2, 2>;
+extern template class FixedSizeSolver<3, 2>;
+extern template class FixedSizeSolver<3, 3>;
+extern template class FixedSizeSolver<4, 3>;
+extern template class FixedSizeSolver<4, 4>;
+extern template class FixedSizeSolver<5, 5>;
@@ -0,0 +1,220 @@
+#include"InputBuffer.h"
+
+#include<cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define INPUT_BUFFER_MMAP
+#endif
+
+#ifdef INPUT_BUFFER_MMAP
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+#endif
+
+
+InputBuffer::InputBuffer()
+    : f_stream(nullptr), f_is_by_line(false), f_mapping(nullptr), f_size_mapping(0), f_position(nullptr), f_end(nullptr)
+{
+}
+
+InputBuffer::InputBuffer(std::istream& p_stream, bool p_is_by_line)
+    : f_stream(&p_stream), f_is_by_line(p_is_by_line), f_mapping(nullptr), f_size_mapping(0), f_position(nullptr), f_end(nullptr)
+{
+}
+
+InputBuffer::~InputBuffer()
+{
+    Unmap();
+}
+
+/*
+* Notes:
+    (a). Only a non-empty regular file is mapped; anything else (an empty file, a pipe such as /dev/stdin, or a
+         platform without mmap) is read in blocks, as a stream would be.
+    (b). The file is read from start to end, so the kernel is advised to read ahead.
+*/
+bool InputBuffer::Open(const char* p_file)
+{
+    Unmap();
+
+    if (f_file.is_open())
+    { f_file.close(); }
+
+    f_stream = nullptr;
+    f_is_by_line = false;
+    f_position = nullptr;
+    f_end = nullptr;
+
+    // (a).
+#ifdef INPUT_BUFFER_MMAP
+    int l_descriptor = open(p_file, O_RDONLY);
+
+    if (l_descriptor < 0)
+    { return false; }
+
+    struct stat l_status;
+
+    if (fstat(l_descriptor, &l_status) == 0 && S_ISREG(l_status.st_mode) && l_status.st_size > 0)
+    {
+        std::size_t l_size = static_cast<std::size_t>(l_status.st_size);
+        void* l_mapping = mmap(nullptr, l_size, PROT_READ, MAP_PRIVATE, l_descriptor, 0);
+
+        if (l_mapping != MAP_FAILED)
+        {
+            // (b).
+            madvise(l_mapping, l_size, MADV_SEQUENTIAL);
+
+            close(l_descriptor);
+
+            f_mapping = l_mapping;
+            f_size_mapping = l_size;
+            f_position = static_cast<const char*>(l_mapping);
+            f_end = f_position + l_size;
+
+            return true;
+        }
+    }
+
+    close(l_descriptor);
+#endif
+
+    f_file.open(p_file, std::ios::binary);
+
+    if (!f_file.is_open())
+    { return false; }
+
+    f_stream = &f_file;
+
+    return true;
+}
+
+/*
+* Notes:
+    (a). The line may be cut off at the end of the block, in which case the next block is read and the search for the
+         '\n' starts again.
+*/
+bool InputBuffer::NextLine(const char*& p_begin, const char*& p_end)
+{
+    while (true)
+    {
+        const char* l_newline = f_position == f_end ? nullptr :
+                                static_cast<const char*>(std::memchr(f_position, '\n', f_end - f_position));
+
+        if (l_newline != nullptr)
+        {
+            p_begin = f_position;
+            p_end = l_newline;
+            f_position = l_newline + 1;
+
+            return true;
+        }
+
+        // (a).
+        if (!ReadBlock())
+        { break; }
+    }
+
+    // The last line, which doesn't end with '\n'.
+    if (f_position == f_end)
+    { return false; }
+
+    p_begin = f_position;
+    p_end = f_end;
+    f_position = f_end;
+
+    return true;
+}
+
+
+/*
+* Notes:
+    (a). The bytes that are kept fill the whole buffer only if a single line is longer than it, in which case the
+         buffer is doubled.
+    (b). Only the next line (and its '\n', if it has one) is taken from the stream, into a buffer no larger than the
+         line.
+*/
+bool InputBuffer::ReadBlock()
+{
+    if (f_stream == nullptr)
+    { return false; }
+
+    std::size_t l_num_kept = f_end - f_position;
+
+    // (b).
+    if (f_is_by_line)
+    { return ReadLine(l_num_kept); }
+
+    if (f_block.empty())
+    { f_block.resize(S_SIZE_BLOCK); }
+
+    if (l_num_kept != 0)
+    { std::memmove(f_block.data(), f_position, l_num_kept); }
+
+    // (a).
+    if (l_num_kept == f_block.size())
+    { f_block.resize(2 * f_block.size()); }
+
+    f_stream->read(f_block.data() + l_num_kept, f_block.size() - l_num_kept);
+    std::size_t l_num_read = static_cast<std::size_t>(f_stream->gcount());
+
+    f_position = f_block.data();
+    f_end = f_position + l_num_kept + l_num_read;
+
+    if (l_num_read == 0)
+    {
+        f_stream = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+/* Auxiliary of ReadBlock
+
+* Notes:
+    (a). On failure the kept bytes are left where they are. std::getline sets the failbit of the stream if it has no
+         more characters, as extracting a value would; its eofbit is set if the last line doesn't end with '\n'.
+*/
+bool InputBuffer::ReadLine(std::size_t p_num_kept)
+{
+    std::string l_line;
+
+    // (a).
+    if (!std::getline(*f_stream, l_line))
+    {
+        f_stream = nullptr;
+        return false;
+    }
+
+    if (!f_stream->eof())
+    { l_line.push_back('\n'); }
+
+    if (p_num_kept + l_line.size() > f_block.size())
+    {
+        std::vector<char> l_block(p_num_kept + l_line.size());
+        std::memcpy(l_block.data(), f_position, p_num_kept);
+        f_block.swap(l_block);
+    }
+    else if (p_num_kept != 0)
+    { std::memmove(f_block.data(), f_position, p_num_kept); }
+
+    std::memcpy(f_block.data() + p_num_kept, l_line.data(), l_line.size());
+
+    f_position = f_block.data();
+    f_end = f_position + p_num_kept + l_line.size();
+
+    return true;
+}
+
+void InputBuffer::Unmap()
+{
+#ifdef INPUT_BUFFER_MMAP
+    if (f_mapping != nullptr)
+    { munmap(f_mapping, f_size_mapping); }
+#endif
+
+    f_mapping = nullptr;
+    f_size_mapping = 0;
+}
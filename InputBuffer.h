@@ -0,0 +1,96 @@
+#pragma once
+
+#include<cstddef>
+#include<fstream>
+#include<iostream>
+#include<string>
+#include<vector>
+
+
+/*
+* Hands out the bytes of an input one line at a time, in place, without copying them into strings.
+* A file is memory-mapped where the platform allows it, so the whole of it can be scanned where it lies. Otherwise,
+  as for a stream, the input is read in large blocks. The part of a line that's cut off at the end of a block is moved
+  to the front of the buffer, and the next block is read after it.
+* A stream can instead be read one line at a time, so that nothing past the last line handed out is taken from it.
+*/
+class InputBuffer
+{
+
+private:
+
+    // The stream that the blocks are read from, or nullptr if the input is mapped, has ended or was never opened.
+    std::istream* f_stream;
+
+    // The file opened by Open, when it's read in blocks rather than mapped.
+    std::ifstream f_file;
+
+    // The buffer that the blocks are read into; it only grows beyond S_SIZE_BLOCK for a line longer than that.
+    std::vector<char> f_block;
+
+    // Whether f_stream is read one line at a time rather than in blocks.
+    bool f_is_by_line;
+
+    // The mapping of the file opened by Open (nullptr if there's none), and its size in bytes.
+    void* f_mapping;
+    std::size_t f_size_mapping;
+
+    // The bytes that haven't been handed out yet.
+    const char* f_position;
+    const char* f_end;
+
+
+    // The number of bytes read from a stream at a time.
+    static const std::size_t S_SIZE_BLOCK = 1 << 20;
+
+
+public:
+
+    /*
+    * Creates an empty input, to be opened with Open.
+    */
+    InputBuffer();
+
+    /*
+    * Creates an input that reads p_stream in blocks or, if p_is_by_line is true, one line at a time (which is slower,
+      but leaves the rest of the stream to be read by others).
+    */
+    InputBuffer(std::istream& p_stream, bool p_is_by_line = false);
+
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+
+    ~InputBuffer();
+
+    /*
+    * Replaces the input with the file p_file, which is mapped if possible (and otherwise read in blocks).
+    * Returns false, leaving the input empty, if the file can't be opened.
+    */
+    bool Open(const char* p_file);
+
+    /*
+    * Assigns to p_begin and p_end the bounds of the next line, without its '\n'. The last line needn't end with one.
+    * The line stays valid until the next call. Returns false at the end of the input.
+    */
+    bool NextLine(const char*& p_begin, const char*& p_end);
+
+
+private:
+
+    /* Auxiliary of NextLine
+    * Moves the bytes that haven't been handed out to the front of f_block and reads the next block (or line) after
+      them. Returns false, leaving those bytes in place, if the stream has no more bytes.
+    */
+    bool ReadBlock();
+
+    /* Auxiliary of ReadBlock
+    * Reads the next line of f_stream into f_block after the p_num_kept bytes at its front; see ReadBlock.
+    */
+    bool ReadLine(std::size_t p_num_kept);
+
+    /* Auxiliary of Open, ~InputBuffer
+    * Unmaps the file opened by Open, if it was mapped.
+    */
+    void Unmap();
+
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include<algorithm>
+
+
+/*
+* A histogram of latencies in microseconds, from which percentiles can be read at any time in constant memory, however
+  many latencies are added (e.g. over the life of a service).
+* The buckets are exact below S_NUM_SUB_BUCKETS microseconds; above, each power of two is split into
+  S_NUM_SUB_BUCKETS buckets of equal width, so a percentile is within 1/S_NUM_SUB_BUCKETS (about 6%) of the true one.
+* It isn't synchronised; its owner must guard it if it's shared by threads.
+*/
+class LatencyHistogram
+{
+
+public:
+
+    // The number of buckets per power of two.
+    static const unsigned int S_NUM_SUB_BUCKETS = 16;
+
+
+private:
+
+    // The number of buckets: the exact ones, then S_NUM_SUB_BUCKETS for each power of two from S_NUM_SUB_BUCKETS up.
+    static const unsigned int S_NUM_BUCKETS = S_NUM_SUB_BUCKETS + (64 - 4) * S_NUM_SUB_BUCKETS;
+
+    // The number of latencies in each bucket.
+    unsigned long long f_counts[S_NUM_BUCKETS];
+
+    // The number of latencies, their sum and the greatest of them.
+    unsigned long long f_count;
+    unsigned long long f_sum;
+    unsigned long long f_max;
+
+
+public:
+
+    LatencyHistogram()
+        : f_counts(), f_count(0), f_sum(0), f_max(0)
+    {
+    }
+
+    void Add(unsigned long long p_microseconds)
+    {
+        ++f_counts[GetBucket(p_microseconds)];
+        ++f_count;
+        f_sum += p_microseconds;
+        f_max = std::max(f_max, p_microseconds);
+    }
+
+    unsigned long long GetCount() const
+    {
+        return f_count;
+    }
+
+    double GetMean() const
+    {
+        return f_count != 0 ? static_cast<double>(f_sum) / f_count : 0.0;
+    }
+
+    unsigned long long GetMax() const
+    {
+        return f_max;
+    }
+
+    /*
+    * Returns the latency below which p_fraction (e.g. 0.99) of the latencies fall: the upper bound of the bucket that
+      holds it, but no more than the greatest latency. Returns 0 if there are none.
+    */
+    unsigned long long GetPercentile(double p_fraction) const
+    {
+        if (f_count == 0)
+        { return 0; }
+
+        unsigned long long l_rank = static_cast<unsigned long long>(p_fraction * f_count);
+        unsigned long long l_num_below = 0;
+
+        for (unsigned int bucket = 0; bucket < S_NUM_BUCKETS; ++bucket)
+        {
+            l_num_below += f_counts[bucket];
+
+            if (l_num_below > l_rank)
+            { return std::min(GetUpperBound(bucket), f_max); }
+        }
+
+        return f_max;
+    }
+
+
+private:
+
+    /* Auxiliary of Add
+    * Returns the bucket of p_microseconds: the value itself if it's exact, and otherwise the position of its highest
+      bit (from 4, i.e. S_NUM_SUB_BUCKETS) and the 4 bits below it.
+    */
+    static unsigned int GetBucket(unsigned long long p_microseconds)
+    {
+        if (p_microseconds < S_NUM_SUB_BUCKETS)
+        { return static_cast<unsigned int>(p_microseconds); }
+
+        unsigned int l_bit = 63;
+        for (; (p_microseconds >> l_bit) == 0; --l_bit);
+
+        unsigned int l_sub_bucket = static_cast<unsigned int>(p_microseconds >> (l_bit - 4)) & (S_NUM_SUB_BUCKETS - 1);
+
+        return S_NUM_SUB_BUCKETS + (l_bit - 4) * S_NUM_SUB_BUCKETS + l_sub_bucket;
+    }
+
+    /* Auxiliary of GetPercentile
+    * Returns the greatest latency of p_bucket.
+    */
+    static unsigned long long GetUpperBound(unsigned int p_bucket)
+    {
+        if (p_bucket < S_NUM_SUB_BUCKETS)
+        { return p_bucket; }
+
+        unsigned int l_bit = 4 + (p_bucket - S_NUM_SUB_BUCKETS) / S_NUM_SUB_BUCKETS;
+        unsigned long long l_sub_bucket = (p_bucket - S_NUM_SUB_BUCKETS) % S_NUM_SUB_BUCKETS;
+
+        return ((S_NUM_SUB_BUCKETS + l_sub_bucket + 1) << (l_bit - 4)) - 1;
+    }
+
+};
@@ -1,41 +1,812 @@
-
 #include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <memory>
+#include <stdexcept>
 
 #include"SudokuBoard.h"
+#include"BatchSolver.h"
+#include"BoardWriter.h"
+#include"PackedCorpusWriter.h"
+#include"PortfolioSolver.h"
+#include"PuzzleGenerator.h"
+#include"SolutionCache.h"
+#include"SolverService.h"
+
+
+// The number of entries of the cache of batch and service modes when --cache doesn't give one.
+static const std::size_t S_SIZE_CACHE_DEFAULT = 100000;
+
+
+/*
+* Returns the value of the command line option p_name if it's in the form '<p_name>=<value>'; otherwise nullptr.
+*/
+const char* GetOptionValue(const char* p_arg, const char* p_name)
+{
+    std::size_t l_length_name = std::strlen(p_name);
+
+    if (std::strncmp(p_arg, p_name, l_length_name) != 0 || p_arg[l_length_name] != '=')
+    { return nullptr; }
+
+    return p_arg + l_length_name + 1;
+}
+
+
+/*
+* Assigns to p_techniques the combination of SudokuSolver's technique flags named in the comma-separated list
+  p_list (e.g. "naked-singles,hidden-singles"); the names 'all' and 'none' are also accepted.
+* Returns false if any of the names aren't recognised.
+*/
+bool ParseTechniques(const char* p_list, unsigned int& p_techniques)
+{
+    // The name of each technique, and its flag.
+    static const struct { const char* name; unsigned int flag; } s_techniques[] =
+    {
+        { "none", SudokuSolver::S_PROPAGATE_NONE },
+        { "all", SudokuSolver::S_PROPAGATE_ALL },
+        { "naked-singles", SudokuSolver::S_NAKED_SINGLES },
+        { "hidden-singles", SudokuSolver::S_HIDDEN_SINGLES },
+        { "locked-candidates", SudokuSolver::S_LOCKED_CANDIDATES },
+        { "naked-pairs", SudokuSolver::S_NAKED_PAIRS },
+        { "hidden-pairs", SudokuSolver::S_HIDDEN_PAIRS }
+    };
+
+    p_techniques = SudokuSolver::S_PROPAGATE_NONE;
+
+    while (*p_list != '\0')
+    {
+        std::size_t l_length = std::strcspn(p_list, ",");
+
+        bool l_is_found = false;
+
+        for (const auto& l_technique : s_techniques)
+        {
+            if (std::strlen(l_technique.name) == l_length && std::strncmp(p_list, l_technique.name, l_length) == 0)
+            {
+                p_techniques |= l_technique.flag;
+                l_is_found = true;
+            }
+        }
+
+        if (!l_is_found)
+        { return false; }
+
+        p_list += l_length;
+
+        if (*p_list == ',')
+        { ++p_list; }
+    }
+
+    return true;
+}
+
+
+/*
+* Creates p_cache with p_size_cache entries, unless p_size_cache is 0, loading it from the file p_file_cache if it's
+  given and exists. Returns false, having reported the problem on stderr, if the file is malformed.
+*/
+bool CreateCache(std::size_t p_size_cache, const char* p_file_cache, std::unique_ptr<SolutionCache>& p_cache)
+{
+    if (p_size_cache == 0)
+    { return true; }
+
+    p_cache.reset(new SolutionCache(p_size_cache));
+
+    if (p_file_cache != nullptr && std::ifstream(p_file_cache).good() && !p_cache->Load(p_file_cache))
+    {
+        std::cerr << "The cache file '" << p_file_cache << "' is malformed.\n";
+        return false;
+    }
+
+    return true;
+}
+
+
+/*
+* Writes the counters of p_cache to stderr, and saves it to the file p_file_cache if it's given. Returns false, having
+  reported the problem, if the file can't be written.
+*/
+bool ReportCache(const SolutionCache& p_cache, const char* p_file_cache)
+{
+    SolutionCache::Counters l_counters = p_cache.GetCounters();
+
+    std::cerr << "Answered " << l_counters.num_hits << " of " << l_counters.num_lookups << " puzzles from the cache ("
+              << (l_counters.num_lookups > 0 ? 100.0 * l_counters.num_hits / l_counters.num_lookups : 0)
+              << "% hit rate), saving " << l_counters.seconds_saved << " s of search for "
+              << l_counters.seconds_canonical << " s spent on canonical forms";
+
+    if (l_counters.num_skipped != 0)
+    { std::cerr << "; " << l_counters.num_skipped << " puzzles had too many symmetries to be cached"; }
+
+    std::cerr << ". The cache holds " << p_cache.GetSize() << " entries.\n";
+
+    if (p_file_cache != nullptr && !p_cache.Save(p_file_cache))
+    {
+        std::cerr << "The cache file '" << p_file_cache << "' could not be written.\n";
+        return false;
+    }
+
+    return true;
+}
+
+
+/*
+* Opens the file p_file with p_reader. Returns false, having reported the problem on stderr, if it can't be opened or
+  is a malformed packed corpus.
+*/
+bool OpenPuzzles(PuzzleReader& p_reader, const char* p_file)
+{
+    if (p_reader.Open(p_file))
+    { return true; }
+
+    if (p_reader.GetError().empty())
+    { std::cerr << "The file '" << p_file << "' could not be opened.\n"; }
+    else
+    { std::cerr << "The file '" << p_file << "' is malformed (" << p_reader.GetError() << ").\n"; }
+
+    return false;
+}
+
+
+/*
+* Solves every puzzle of the given file (or of stdin, if p_file is nullptr or "-") with the settings of p_settings,
+  writing one line per puzzle to stdout and a summary to stderr. If p_is_counting is true, the solutions of each
+  puzzle are counted up to p_max_solutions (see BatchSolver::SetCounting).
+* If p_is_showing_stats is true, the statistics of each puzzle are written as JSON lines to the file p_file_stats, or
+  to stderr if it's nullptr (see BatchSolver::SetStatsOutput).
+* If p_size_cache isn't 0 (and the solutions aren't counted), the puzzles are solved through a SolutionCache of that
+  many entries, which is loaded from the file p_file_cache (if it's given and exists) and saved to it at the end; the
+  cache's counters are added to the summary.
+* If p_num_shards isn't 0, only the p_index_shard-th of that many slices of the file is solved, which must then be a
+  packed corpus (see PuzzleReader::SelectShard).
+*/
+int RunBatch(const char* p_file, const SudokuBoard& p_settings, unsigned int p_num_threads,
+             BatchSolver::OutputOrder p_output_order, BoardWriter::Format p_output_format, bool p_is_counting,
+             unsigned long long p_max_solutions, bool p_is_showing_stats, const char* p_file_stats,
+             std::size_t p_size_cache, const char* p_file_cache, unsigned int p_index_shard, unsigned int p_num_shards)
+{
+    // A file is mapped into memory (see PuzzleReader::Open); stdin is read in blocks.
+    PuzzleReader l_reader(std::cin);
+
+    if (p_file != nullptr && std::strcmp(p_file, "-") != 0 && !OpenPuzzles(l_reader, p_file))
+    { return EXIT_FAILURE; }
+
+    if (p_num_shards != 0 && !l_reader.SelectShard(p_index_shard, p_num_shards))
+    {
+        std::cerr << "Only a packed corpus can be read in shards (see --pack).\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream l_file_stats;
+
+    if (p_file_stats != nullptr)
+    {
+        l_file_stats.open(p_file_stats);
+
+        if (!l_file_stats.good())
+        {
+            std::cerr << "The file '" << p_file_stats << "' could not be created.\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::unique_ptr<SolutionCache> l_cache;
+
+    if (!p_is_counting && !CreateCache(p_size_cache, p_file_cache, l_cache))
+    { return EXIT_FAILURE; }
+
+    // The output is written per puzzle, so there's no need for stdout to be synchronised with C's stdio.
+    std::ios::sync_with_stdio(false);
+
+    BatchSolver l_batch;
+    l_batch.GetBoard().CopySettings(p_settings);
+    l_batch.SetNumThreads(p_num_threads);
+    l_batch.SetOutputOrder(p_output_order);
+    l_batch.SetOutputFormat(p_output_format);
+    l_batch.SetCounting(p_is_counting, p_max_solutions);
+
+    if (p_is_showing_stats)
+    { l_batch.SetStatsOutput(l_file_stats.is_open() ? &l_file_stats : &std::cerr); }
+
+    l_batch.SetCache(l_cache.get());
+
+    BatchSolver::Summary l_summary;
+    std::string l_error;
+
+    bool l_is_input_valid = l_batch.Run(l_reader, std::cout, l_summary, l_error);
+
+    if (!l_is_input_valid)
+    { std::cerr << "Malformed input (" << l_error << ").\n"; }
+
+    std::cerr << "Solved " << l_summary.num_solved << " of " << l_summary.num_puzzles << " puzzles ("
+              << l_summary.num_unsolvable << " without a solution, " << l_summary.num_invalid << " invalid";
+
+    if (l_summary.num_out_of_budget != 0)
+    { std::cerr << ", " << l_summary.num_out_of_budget << " over budget"; }
+
+    if (p_is_counting)
+    { std::cerr << ", " << l_summary.num_multiple << " with more than one solution"; }
+
+    std::cerr << ") in " << l_summary.seconds << " s: "
+              << (l_summary.seconds > 0 ? l_summary.num_puzzles / l_summary.seconds : 0) << " puzzles/s.\n";
+
+    if (l_cache && !ReportCache(*l_cache, p_file_cache))
+    { return EXIT_FAILURE; }
+
+    return l_is_input_valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/*
+* Answers the puzzles sent to a SolverService with the settings of p_settings and p_num_threads workers, on stdin and
+  stdout if p_path_socket is nullptr and otherwise on the connections to the Unix domain socket at p_path_socket;
+  writes the percentiles of the times taken to answer them to stderr at the end.
+* The cache is used as in RunBatch.
+*/
+int RunService(const char* p_path_socket, const SudokuBoard& p_settings, unsigned int p_num_threads,
+               std::size_t p_size_cache, const char* p_file_cache)
+{
+    std::unique_ptr<SolutionCache> l_cache;
+
+    if (!CreateCache(p_size_cache, p_file_cache, l_cache))
+    { return EXIT_FAILURE; }
+
+    std::ios::sync_with_stdio(false);
+
+    SolverService l_service(p_settings, p_num_threads);
+    l_service.SetCache(l_cache.get());
+
+    std::string l_error;
+
+    if (p_path_socket == nullptr)
+    { l_service.Serve(std::cin, std::cout); }
+    else if (!l_service.ServeSocket(p_path_socket, l_error))
+    {
+        std::cerr << "The socket '" << p_path_socket << "' could not be served (" << l_error << ").\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << "Answered puzzles: ";
+    l_service.WriteLatencies(std::cerr);
+    std::cerr << '\n';
+
+    if (l_cache && !ReportCache(*l_cache, p_file_cache))
+    { return EXIT_FAILURE; }
+
+    return EXIT_SUCCESS;
+}
+
+
+/*
+* Converts the puzzles of the given file (or of stdin, if p_file is nullptr or "-") into a packed corpus, written to the
+  file p_file_packed (see PackedCorpusWriter); writes a summary to stderr. The puzzles must all have the same
+  dimensions, which are those of the corpus.
+*/
+int RunPack(const char* p_file, const char* p_file_packed)
+{
+    std::chrono::steady_clock::time_point l_start = std::chrono::steady_clock::now();
+
+    PuzzleReader l_reader(std::cin);
+
+    if (p_file != nullptr && std::strcmp(p_file, "-") != 0 && !OpenPuzzles(l_reader, p_file))
+    { return EXIT_FAILURE; }
+
+    // The dimensions of the corpus are those of its first puzzle (or the default ones, if there's none).
+    SudokuBoard l_board;
+    bool l_has_puzzle = l_reader.Read(l_board);
+
+    PackedCorpusWriter l_writer;
+
+    if (!l_writer.Create(p_file_packed, l_board.GetWidthBox(), l_board.GetHeightBox()))
+    {
+        std::cerr << "The file '" << p_file_packed << "' could not be created.\n";
+        return EXIT_FAILURE;
+    }
+
+    bool l_is_packed = true;
+
+    for (; l_has_puzzle; l_has_puzzle = l_reader.Read(l_board))
+    {
+        if (!l_writer.Write(l_board))
+        {
+            std::cerr << "Puzzle " << (l_writer.GetNumPuzzles() + 1) << " has other box dimensions than the first; "
+                      << "a packed corpus holds puzzles of one size.\n";
+            l_is_packed = false;
+            break;
+        }
+    }
+
+    if (l_is_packed && !l_reader.GetError().empty())
+    {
+        std::cerr << "Malformed input (" << l_reader.GetError() << ").\n";
+        l_is_packed = false;
+    }
+
+    if (!l_writer.Close() && l_is_packed)
+    {
+        std::cerr << "The file '" << p_file_packed << "' could not be written.\n";
+        l_is_packed = false;
+    }
+
+    // A corpus that couldn't be finished is removed, rather than left holding only some of the puzzles.
+    if (!l_is_packed)
+    {
+        std::remove(p_file_packed);
+        return EXIT_FAILURE;
+    }
+
+    double l_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - l_start).count();
+
+    std::cerr << "Packed " << l_writer.GetNumPuzzles() << " puzzles with " << l_board.GetWidthBox() << 'x'
+              << l_board.GetHeightBox() << " boxes into " << l_writer.GetSize() << " bytes ("
+              << PackedCorpus::GetSizeRecord(l_board.GetSizeGrid()) << " per puzzle) in " << l_seconds << " s.\n";
+
+    return EXIT_SUCCESS;
+}
+
+
+/*
+* Generates p_num_puzzles puzzles with the settings of p_generator on p_num_threads threads, writing them to stdout in
+  the batch format and a summary to stderr.
+*/
+int RunGenerate(unsigned long long p_num_puzzles, PuzzleGenerator& p_generator, unsigned int p_num_threads)
+{
+    std::chrono::steady_clock::time_point l_start = std::chrono::steady_clock::now();
+
+    std::ios::sync_with_stdio(false);
+
+    unsigned long long l_num_clues = p_generator.GenerateBatch(p_num_puzzles, p_num_threads, std::cout);
+
+    double l_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - l_start).count();
+
+    std::cerr << "Generated " << p_num_puzzles << " puzzles with " << p_generator.GetWidthBox() << 'x'
+              << p_generator.GetHeightBox() << " boxes (" << (p_num_puzzles > 0 ? double(l_num_clues) / p_num_puzzles : 0)
+              << " clues on average) in " << l_seconds << " s: "
+              << (l_seconds > 0 ? p_num_puzzles / l_seconds : 0) << " puzzles/s.\n";
+
+    return EXIT_SUCCESS;
+}
 
 
 /*
 * The entry-point function.
+* Usage: sudoku_solver <puzzle file> [options]
+*        sudoku_solver --batch [<puzzles file>] [--shard=<index>/<count>] [options]
+*        sudoku_solver [<puzzles file>] --pack=<packed file>
+*        sudoku_solver --serve[=<socket path>] [--engine=...] [--propagate=...] [--threads=<count>] [--cache...]
+*        sudoku_solver --generate=<count> [--box=<width>x<height>] [--clues=<target>]
+*                      [--symmetry=none|rotational|mirror|diagonal] [--seed=<seed>] [--threads=<count>]
+* Options: [--engine=backtracking|dlx] [--propagate=<techniques>] [--propagate-root-only] [--portfolio[=<strategies>]]
+*          [--randomize[=<seed>]] [--restarts=none|luby|geometric] [--restart-nodes=<count>]
+*          [--threads=<count>] [--count[=<max>]] [--stats[=<file>]] [--format=pretty|compact|raw]
+*          [--time-limit=<seconds>] [--max-nodes=<count>]
+*          [--completion-order] [--cache[=<entries>]] [--cache-file=<file>] (batch and service modes only)
+* The puzzle files may be text (see PuzzleReader) or packed corpora (see PackedCorpus).
+* In batch and service modes the threads solve different puzzles (one per hardware thread by default); otherwise they
+  search the single puzzle's tree in parallel (one thread by default).
+* With --serve, the puzzles are read one per line from stdin, or from the connections to a Unix domain socket at
+  <socket path>, and answered as they're solved (see SolverService); the percentiles of the answers' times are written
+  to stderr at the end.
+* With --count, the solutions are counted (up to <max>, 0 for no limit; 2 if it's omitted, which checks that the
+  solution is unique) rather than just found; the count always runs on one thread per puzzle.
+* With --format, the boards are output in that format (see BoardWriter); the default is 'pretty', or 'compact' in batch
+  mode.
+* With --stats, the search's counters and the time of each phase are written after the result; in batch mode they're
+  written per puzzle as JSON lines, to <file> if it's given and otherwise to stderr.
+* With --randomize, the backtracking engine breaks ties between cells and orders the values at random, reproducibly
+  for a given <seed> (0 if it's omitted). With --restarts, it also restarts its search from the root each time a run
+  has visited its limit of nodes, starting from <count> (see SudokuSolver::SetRestarts); restarts imply --randomize.
+* With --portfolio, each puzzle is solved by racing the strategies (a comma-separated list; see
+  PortfolioSolver::ParseStrategies) against each other, one thread each, and taking the first answer; it replaces
+  --engine and --propagate, and the threads of a single puzzle's search.
+* With --time-limit and --max-nodes, the search of each puzzle gives up once it has taken that long or visited that
+  many nodes (see SearchBudget); batch mode then outputs "budget exceeded" for the puzzle, and moves on.
+* With --cache, the puzzles of a batch are solved through a cache of up to <entries> solutions (100000 if it's
+  omitted), keyed by the puzzles' canonical forms; with --cache-file, the cache is also loaded from <file> (if it
+  exists) and saved to it at the end. The cache isn't used with --count. Service mode uses the cache in the same way.
+* With --pack, the puzzles of the file (or of stdin) are converted into a packed corpus, written to <packed file>.
+* With --shard, batch mode only solves the <index>-th (counting from 0) of <count> equal slices of a packed corpus, so
+  that several workers can share it without each reading all of it.
 */
 int main(int argc, char* argv[])
 {
-    if (argc == 1)
+    // The puzzle file, and whether or not it holds a batch of puzzles.
+    const char* l_file = nullptr;
+    bool l_is_batch = false;
+
+    // Whether or not the puzzles are answered as a service, and the path of its socket (nullptr for stdin/stdout).
+    bool l_is_serving = false;
+    const char* l_path_socket = nullptr;
+
+    // The engine used to solve the sudoku.
+    SudokuBoard::Engine l_engine = SudokuBoard::Engine::BackTracking;
+
+    // The techniques applied by the backtracking engine, and whether they're applied at every step of the search.
+    unsigned int l_techniques = SudokuSolver::S_NAKED_SINGLES | SudokuSolver::S_HIDDEN_SINGLES;
+    bool l_propagate_at_nodes = true;
+
+    // Whether or not the backtracking engine's choices are random, and their seed; and the restart rule, and the node
+    // limit of the first run.
+    bool l_is_random = false;
+    unsigned long long l_seed_search = 0;
+    SudokuSolver::Restarts l_restarts = SudokuSolver::Restarts::None;
+    unsigned long long l_nodes_first_run = SudokuSolver::S_NODES_FIRST_RUN;
+
+    // The strategies raced by the portfolio (none if it's off).
+    std::vector<PortfolioSolver::Strategy> l_strategies;
+
+    // The number of threads (0 for one per hardware thread), whether it was given, and the order of the output of batch
+    // mode.
+    unsigned int l_num_threads = 0;
+    bool l_is_threads_given = false;
+    BatchSolver::OutputOrder l_output_order = BatchSolver::OutputOrder::Input;
+
+    // The format of the output boards, if it was given.
+    bool l_is_format_given = false;
+    BoardWriter::Format l_output_format = BoardWriter::Format::Pretty;
+
+    // Whether or not the solutions are counted, and the number at which the count stops.
+    bool l_is_counting = false;
+    unsigned long long l_max_solutions = 2;
+
+    // Whether or not the statistics are shown, and the file that batch mode writes them to (nullptr for stderr).
+    bool l_is_showing_stats = false;
+    const char* l_file_stats = nullptr;
+
+    // The time limit (in seconds) and the greatest number of nodes of each search (0 for none).
+    double l_seconds_limit = 0.0;
+    unsigned long long l_max_nodes = 0;
+
+    // The number of entries of batch mode's cache (0 for none), and the file that it's loaded from and saved to.
+    std::size_t l_size_cache = 0;
+    const char* l_file_cache = nullptr;
+
+    // The packed corpus that the puzzles are converted into (nullptr if they aren't).
+    const char* l_file_packed = nullptr;
+
+    // The slice of a packed corpus that batch mode solves, and the number of slices (0 to solve all of it).
+    unsigned int l_index_shard = 0;
+    unsigned int l_num_shards = 0;
+
+    // The number of puzzles to generate (if generating), and the generator's settings.
+    bool l_is_generating = false;
+    unsigned long long l_num_to_generate = 0;
+    PuzzleGenerator l_generator;
+    l_generator.Seed(std::random_device()());
+
+    // Parse the file and the options.
+    for (int i = 1; i < argc; ++i)
+    {
+        if (argv[i][0] != '-' || std::strcmp(argv[i], "-") == 0)
+        {
+            l_file = argv[i];
+        }
+        else if (std::strcmp(argv[i], "--batch") == 0)
+        {
+            l_is_batch = true;
+        }
+        else if (std::strcmp(argv[i], "--serve") == 0)
+        {
+            l_is_serving = true;
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--serve"))
+        {
+            l_is_serving = true;
+            l_path_socket = l_value;
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--engine"))
+        {
+            if (std::strcmp(l_value, "backtracking") == 0)
+            { l_engine = SudokuBoard::Engine::BackTracking; }
+            else if (std::strcmp(l_value, "dlx") == 0)
+            { l_engine = SudokuBoard::Engine::DancingLinks; }
+            else
+            {
+                std::cout << "Unknown engine '" << l_value << "'; expected 'backtracking' or 'dlx'.\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--propagate"))
+        {
+            if (!ParseTechniques(l_value, l_techniques))
+            {
+                std::cout << "Unknown technique in '" << l_value << "' (see README).\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "--propagate-root-only") == 0)
+        {
+            l_propagate_at_nodes = false;
+        }
+        else if (std::strcmp(argv[i], "--randomize") == 0)
+        {
+            l_is_random = true;
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--randomize"))
+        {
+            l_is_random = true;
+            l_seed_search = std::strtoull(l_value, nullptr, 10);
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--restarts"))
+        {
+            if (std::strcmp(l_value, "none") == 0)
+            { l_restarts = SudokuSolver::Restarts::None; }
+            else if (std::strcmp(l_value, "luby") == 0)
+            { l_restarts = SudokuSolver::Restarts::Luby; }
+            else if (std::strcmp(l_value, "geometric") == 0)
+            { l_restarts = SudokuSolver::Restarts::Geometric; }
+            else
+            {
+                std::cout << "Unknown restart rule '" << l_value << "'; expected 'none', 'luby' or 'geometric'.\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--restart-nodes"))
+        {
+            l_nodes_first_run = std::strtoull(l_value, nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--portfolio") == 0)
+        {
+            PortfolioSolver::ParseStrategies(PortfolioSolver::S_STRATEGIES_DEFAULT, l_strategies);
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--portfolio"))
+        {
+            if (!PortfolioSolver::ParseStrategies(l_value, l_strategies))
+            {
+                std::cout << "Unknown strategies '" << l_value << "'; expected a comma-separated list of 'backtracking', "
+                          << "'row-major', 'most-empty-peers', 'propagation', 'restarts', 'dlx' or 'all'.\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--threads"))
+        {
+            l_num_threads = static_cast<unsigned int>(std::strtoul(l_value, nullptr, 10));
+            l_is_threads_given = true;
+        }
+        else if (std::strcmp(argv[i], "--count") == 0)
+        {
+            l_is_counting = true;
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--count"))
+        {
+            l_is_counting = true;
+            l_max_solutions = std::strtoull(l_value, nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--stats") == 0)
+        {
+            l_is_showing_stats = true;
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--stats"))
+        {
+            l_is_showing_stats = true;
+            l_file_stats = l_value;
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--format"))
+        {
+            if (!BoardWriter::ParseFormat(l_value, l_output_format))
+            {
+                std::cout << "Unknown format '" << l_value << "'; expected 'pretty', 'compact' or 'raw'.\n";
+                return EXIT_FAILURE;
+            }
+
+            l_is_format_given = true;
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--time-limit"))
+        {
+            l_seconds_limit = std::strtod(l_value, nullptr);
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--max-nodes"))
+        {
+            l_max_nodes = std::strtoull(l_value, nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--completion-order") == 0)
+        {
+            l_output_order = BatchSolver::OutputOrder::Completion;
+        }
+        else if (std::strcmp(argv[i], "--cache") == 0)
+        {
+            l_size_cache = S_SIZE_CACHE_DEFAULT;
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--cache"))
+        {
+            l_size_cache = static_cast<std::size_t>(std::strtoull(l_value, nullptr, 10));
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--cache-file"))
+        {
+            l_file_cache = l_value;
+
+            if (l_size_cache == 0)
+            { l_size_cache = S_SIZE_CACHE_DEFAULT; }
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--pack"))
+        {
+            l_file_packed = l_value;
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--shard"))
+        {
+            char* l_end = nullptr;
+            l_index_shard = static_cast<unsigned int>(std::strtoul(l_value, &l_end, 10));
+            l_num_shards = *l_end == '/' ? static_cast<unsigned int>(std::strtoul(l_end + 1, nullptr, 10)) : 0;
+
+            if (l_index_shard >= l_num_shards)
+            {
+                std::cout << "Invalid shard '" << l_value << "'; expected e.g. '0/4'.\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--generate"))
+        {
+            l_is_generating = true;
+            l_num_to_generate = std::strtoull(l_value, nullptr, 10);
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--box"))
+        {
+            char* l_end = nullptr;
+            unsigned long l_width_box = std::strtoul(l_value, &l_end, 10);
+            unsigned long l_height_box = *l_end == 'x' ? std::strtoul(l_end + 1, nullptr, 10) : 0;
+
+            if (!l_generator.SetDimensions(static_cast<unsigned int>(l_width_box), static_cast<unsigned int>(l_height_box)))
+            {
+                std::cout << "Unsupported box dimensions '" << l_value << "'; expected e.g. '3x3'.\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--clues"))
+        {
+            l_generator.SetTargetClues(static_cast<unsigned int>(std::strtoul(l_value, nullptr, 10)));
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--symmetry"))
+        {
+            if (std::strcmp(l_value, "none") == 0)
+            { l_generator.SetSymmetry(PuzzleGenerator::Symmetry::None); }
+            else if (std::strcmp(l_value, "rotational") == 0)
+            { l_generator.SetSymmetry(PuzzleGenerator::Symmetry::Rotational); }
+            else if (std::strcmp(l_value, "mirror") == 0)
+            { l_generator.SetSymmetry(PuzzleGenerator::Symmetry::Mirror); }
+            else if (std::strcmp(l_value, "diagonal") == 0)
+            { l_generator.SetSymmetry(PuzzleGenerator::Symmetry::Diagonal); }
+            else
+            {
+                std::cout << "Unknown symmetry '" << l_value << "'; expected 'none', 'rotational', 'mirror' or 'diagonal'.\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--seed"))
+        {
+            l_generator.Seed(std::strtoull(l_value, nullptr, 10));
+        }
+        else
+        {
+            std::cout << "Unknown option '" << argv[i] << "' (see README).\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (l_is_showing_stats && !SolverStats::S_IS_ENABLED)
+    {
+        std::cout << "The statistics were compiled out of this build (SUDOKU_NO_STATS).\n";
+        return EXIT_FAILURE;
+    }
+
+    // The settings used to solve the sudoku(s).
+    SudokuBoard l_settings;
+    l_settings.SetEngine(l_engine);
+    l_settings.SetPropagation(l_techniques, l_propagate_at_nodes);
+    l_settings.SetRandomization(l_is_random || l_restarts != SudokuSolver::Restarts::None, l_seed_search);
+    l_settings.SetRestarts(l_restarts, l_nodes_first_run);
+    l_settings.SetPortfolio(l_strategies);
+    l_settings.SetTiming(l_is_showing_stats);
+    l_settings.GetBudget().SetTimeLimit(l_seconds_limit);
+    l_settings.GetBudget().SetMaxNodes(l_max_nodes);
+
+    if (l_is_generating)
+    { return RunGenerate(l_num_to_generate, l_generator, l_num_threads); }
+
+    if (l_is_serving)
+    { return RunService(l_path_socket, l_settings, l_num_threads, l_size_cache, l_file_cache); }
+
+    if (l_file_packed != nullptr)
+    { return RunPack(l_file, l_file_packed); }
+
+    if (l_is_batch)
+    {
+        return RunBatch(l_file, l_settings, l_num_threads, l_output_order,
+                        l_is_format_given ? l_output_format : BoardWriter::Format::Compact, l_is_counting,
+                        l_max_solutions, l_is_showing_stats, l_file_stats, l_size_cache, l_file_cache, l_index_shard,
+                        l_num_shards);
+    }
+
+    if (l_file == nullptr)
     {
         std::cout << "No sudoku file was specified. Please run the program again with a command line parameter that corresponds to a sudoku file (see README).\n";
         return EXIT_FAILURE;
     }
 
-    // Create the sudoku.
-    SudokuBoard l_sudoku(argv[1]);
+    // Times the parse and print phases, the board timing the others.
+    PhaseTimer l_timer(l_is_showing_stats);
+
+    // Create the sudoku, reporting a file that can't be opened or is malformed.
+    std::unique_ptr<SudokuBoard> l_board;
+
+    try
+    {
+        l_board.reset(new SudokuBoard(l_file));
+    }
+    catch (const std::runtime_error& l_exception)
+    {
+        std::cout << l_exception.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    SudokuBoard& l_sudoku = *l_board;
+    l_sudoku.GetStats().seconds_parse = l_timer.Lap();
+    l_sudoku.CopySettings(l_settings);
+    l_sudoku.SetNumThreads(l_is_threads_given ? l_num_threads : 1);
+
+    BoardWriter l_writer(l_output_format);
 
     // Output the (unsolved) sudoku.
-    std::cout << "Unsolved:\n" 
-              << l_sudoku;
+    std::cout << "Unsolved:\n";
+    l_writer.Write(std::cout, l_sudoku);
+
+    // Solve the sudoku, or count its solutions, if it's valid.
+    bool l_is_valid = l_sudoku.IsValid();
+    SudokuBoard::Result l_result = SudokuBoard::Result::Unsolvable;
+    unsigned long long l_num_solutions = 0;
+
+    if (l_is_valid && l_is_counting)
+    {
+        l_num_solutions = l_sudoku.CountSolutions(l_max_solutions);
+        l_result = l_sudoku.GetBudget().GetLimitReached() != SearchBudget::Limit::None
+                   ? SudokuBoard::Result::OutOfBudget
+                   : l_num_solutions != 0 ? SudokuBoard::Result::Solved : SudokuBoard::Result::Unsolvable;
+    }
+    else if (l_is_valid)
+    { l_result = l_sudoku.TrySolve(); }
+
+    l_timer.Lap();
+
+    bool l_is_solved = l_result == SudokuBoard::Result::Solved;
 
-    if (!l_sudoku.IsValid()) // If the sudoku isn't valid.
+    if (!l_is_valid) // If the sudoku isn't valid.
     {
         std::cout << "\nThe given sudoku does not adhere to the rules of sudoku.\n";
     }
-    else if (l_sudoku.Solve()) // If the sudoku was successfully solved.
+    else if (l_result == SudokuBoard::Result::OutOfBudget) // If the search was stopped by --time-limit or --max-nodes.
     {
-        // Output the (solved) sudoku.
-        std::cout << "\nSolved:\n"
-                  << l_sudoku;
+        std::cout << "\nThe search was stopped by its budget (time or node limit) before it finished.\n";
+    }
+    else if (l_is_solved && l_is_counting)
+    {
+        std::cout << "\nThe given sudoku has " << (l_num_solutions == l_max_solutions ? "at least " : "")
+                  << l_num_solutions << (l_num_solutions == 1 ? " solution" : " solutions") << "; the first is:\n";
+        l_writer.Write(std::cout, l_sudoku);
+    }
+    else if (l_is_solved) // If the sudoku was successfully solved.
+    {
+        // Output the (solved) sudoku, and the strategy that solved it if there was a portfolio.
+        std::cout << "\nSolved:\n";
+        l_writer.Write(std::cout, l_sudoku);
+
+        if (l_sudoku.GetStats().strategy != nullptr)
+        { std::cout << "\nThe '" << l_sudoku.GetStats().strategy << "' strategy answered first.\n"; }
     }
     else // If the sudoku couldn't be solved.
     {
         std::cout << "\nThe given sudoku has no solution.\n";
     }
 
+    if (l_is_showing_stats)
+    {
+        l_sudoku.GetStats().seconds_print = l_timer.Lap();
+
+        std::cout << "\nStatistics:\n";
+        l_sudoku.GetStats().WriteText(std::cout);
+    }
+
     return EXIT_SUCCESS;
 }
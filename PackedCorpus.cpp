@@ -0,0 +1,274 @@
+#include"PackedCorpus.h"
+
+#include<cstring>
+#include<fstream>
+#include<iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PACKED_CORPUS_MMAP
+#endif
+
+#ifdef PACKED_CORPUS_MMAP
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+#endif
+
+
+const char PackedCorpus::S_MAGIC[8] = { 'S', 'U', 'D', 'O', 'P', 'A', 'K', '1' };
+
+
+PackedCorpus::PackedCorpus()
+    : f_mapping(nullptr), f_size_mapping(0), f_records(nullptr), f_width_box(0), f_height_box(0), f_size_grid(0),
+      f_num_bits_per_cell(0), f_size_record(0), f_num_puzzles(0)
+{
+}
+
+PackedCorpus::~PackedCorpus()
+{
+    Close();
+}
+
+/*
+* Notes:
+    (a). As in InputBuffer::Open, only a non-empty regular file is mapped; anything else is read into memory.
+    (b). The puzzles are loaded wherever the readers want them, rather than in order, so the kernel isn't advised to
+         read ahead.
+*/
+bool PackedCorpus::Open(const char* p_file, std::string& p_error)
+{
+    Close();
+
+    p_error.clear();
+
+    // (a).
+#ifdef PACKED_CORPUS_MMAP
+    int l_descriptor = open(p_file, O_RDONLY);
+
+    if (l_descriptor < 0)
+    { return false; }
+
+    struct stat l_status;
+
+    if (fstat(l_descriptor, &l_status) == 0 && S_ISREG(l_status.st_mode) && l_status.st_size > 0)
+    {
+        std::size_t l_size = static_cast<std::size_t>(l_status.st_size);
+        void* l_mapping = mmap(nullptr, l_size, PROT_READ, MAP_PRIVATE, l_descriptor, 0);
+
+        if (l_mapping != MAP_FAILED)
+        {
+            close(l_descriptor);
+
+            f_mapping = l_mapping;
+            f_size_mapping = l_size;
+
+            // (b).
+            if (!ParseHeader(static_cast<const unsigned char*>(l_mapping), l_size, p_error))
+            {
+                Close();
+                return false;
+            }
+
+            return true;
+        }
+    }
+
+    close(l_descriptor);
+#endif
+
+    std::ifstream l_file(p_file, std::ios::binary);
+
+    if (!l_file.is_open())
+    { return false; }
+
+    f_contents.assign(std::istreambuf_iterator<char>(l_file), std::istreambuf_iterator<char>());
+
+    if (!ParseHeader(f_contents.data(), f_contents.size(), p_error))
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void PackedCorpus::Close()
+{
+#ifdef PACKED_CORPUS_MMAP
+    if (f_mapping != nullptr)
+    { munmap(f_mapping, f_size_mapping); }
+#endif
+
+    f_mapping = nullptr;
+    f_size_mapping = 0;
+    f_contents.clear();
+    f_contents.shrink_to_fit();
+    f_records = nullptr;
+    f_width_box = f_height_box = f_size_grid = 0;
+    f_num_bits_per_cell = 0;
+    f_size_record = 0;
+    f_num_puzzles = 0;
+}
+
+bool PackedCorpus::IsOpen() const
+{
+    return f_records != nullptr;
+}
+
+unsigned int PackedCorpus::GetWidthBox() const
+{
+    return f_width_box;
+}
+
+unsigned int PackedCorpus::GetHeightBox() const
+{
+    return f_height_box;
+}
+
+unsigned long long PackedCorpus::GetNumPuzzles() const
+{
+    return f_num_puzzles;
+}
+
+/*
+* Notes:
+    (a). The bits are taken a byte at a time into l_bits, which always holds at least one whole cell when one is
+         extracted (a cell has at most 8 bits).
+*/
+bool PackedCorpus::Load(unsigned long long p_index, SudokuBoard& p_board) const
+{
+    p_board.SetDimensions(f_width_box, f_height_box);
+
+    const unsigned char* l_record = f_records + p_index * f_size_record;
+    unsigned int l_mask_cell = (1U << f_num_bits_per_cell) - 1;
+
+    unsigned int l_bits = 0;
+    unsigned int l_num_bits = 0;
+
+    for (unsigned int row = 0; row < f_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < f_size_grid; ++col)
+        {
+            // (a).
+            if (l_num_bits < f_num_bits_per_cell)
+            {
+                l_bits |= static_cast<unsigned int>(*l_record++) << l_num_bits;
+                l_num_bits += 8;
+            }
+
+            unsigned int l_value = l_bits & l_mask_cell;
+            l_bits >>= f_num_bits_per_cell;
+            l_num_bits -= f_num_bits_per_cell;
+
+            if (l_value > f_size_grid)
+            { return false; }
+
+            p_board.SetValue(row, col, l_value);
+        }
+
+    }
+
+    return true;
+}
+
+/*
+* Notes:
+    (a). Only a regular file is looked at, since reading the first bytes of anything else (e.g. a pipe such as
+         /dev/stdin) would consume them.
+*/
+bool PackedCorpus::IsPackedFile(const char* p_file)
+{
+    // (a).
+#ifdef PACKED_CORPUS_MMAP
+    struct stat l_status;
+
+    if (stat(p_file, &l_status) != 0 || !S_ISREG(l_status.st_mode))
+    { return false; }
+#endif
+
+    std::ifstream l_file(p_file, std::ios::binary);
+    char l_magic[sizeof(S_MAGIC)];
+
+    return l_file.read(l_magic, sizeof(l_magic)) && std::memcmp(l_magic, S_MAGIC, sizeof(S_MAGIC)) == 0;
+}
+
+unsigned int PackedCorpus::GetNumBitsPerCell(unsigned int p_size_grid)
+{
+    unsigned int l_num_bits = 1;
+
+    for (; (1U << l_num_bits) <= p_size_grid; ++l_num_bits);
+
+    return l_num_bits;
+}
+
+std::size_t PackedCorpus::GetSizeRecord(unsigned int p_size_grid)
+{
+    std::size_t l_num_bits = static_cast<std::size_t>(p_size_grid) * p_size_grid * GetNumBitsPerCell(p_size_grid);
+
+    return (l_num_bits + 7) / 8;
+}
+
+unsigned long long PackedCorpus::ReadInteger(const unsigned char* p_bytes, unsigned int p_num_bytes)
+{
+    unsigned long long l_value = 0;
+
+    for (unsigned int i = p_num_bytes; i-- > 0; )
+    { l_value = (l_value << 8) | p_bytes[i]; }
+
+    return l_value;
+}
+
+
+/*
+* Notes:
+    (a). The size of a record is implied by the dimensions; it's stored so that a corpus written with other
+         dimensions or another packing is rejected rather than misread.
+    (b). A corpus that's longer than its records (e.g. one whose writer was interrupted before it could update the
+         count) is read up to the count of its header.
+*/
+bool PackedCorpus::ParseHeader(const unsigned char* p_contents, std::size_t p_size, std::string& p_error)
+{
+    if (p_size < S_SIZE_HEADER || std::memcmp(p_contents, S_MAGIC, sizeof(S_MAGIC)) != 0)
+    {
+        p_error = "not a packed corpus";
+        return false;
+    }
+
+    unsigned int l_width_box = static_cast<unsigned int>(ReadInteger(p_contents + 8, 4));
+    unsigned int l_height_box = static_cast<unsigned int>(ReadInteger(p_contents + 12, 4));
+    std::size_t l_size_record = static_cast<std::size_t>(ReadInteger(p_contents + 16, 4));
+    unsigned long long l_num_puzzles = ReadInteger(p_contents + 20, 8);
+
+    if (!SudokuBoard::AreDimensionsSupported(l_width_box, l_height_box))
+    {
+        p_error = "invalid box dimensions";
+        return false;
+    }
+
+    unsigned int l_size_grid = l_width_box * l_height_box;
+
+    // (a).
+    if (l_size_record != GetSizeRecord(l_size_grid))
+    {
+        p_error = "the size of a record doesn't match the box dimensions";
+        return false;
+    }
+
+    // (b).
+    if (l_num_puzzles > (p_size - S_SIZE_HEADER) / l_size_record)
+    {
+        p_error = "the file is shorter than its puzzles";
+        return false;
+    }
+
+    f_records = p_contents + S_SIZE_HEADER;
+    f_width_box = l_width_box;
+    f_height_box = l_height_box;
+    f_size_grid = l_size_grid;
+    f_num_bits_per_cell = GetNumBitsPerCell(l_size_grid);
+    f_size_record = l_size_record;
+    f_num_puzzles = l_num_puzzles;
+
+    return true;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include<cstddef>
+#include<string>
+#include<vector>
+
+#include"SudokuBoard.h"
+
+
+/*
+* A corpus of puzzles in the packed binary format, which is read in place: the file is memory-mapped where the
+  platform allows it (and otherwise read into memory whole), and any puzzle can be loaded by its number without
+  reading those before it, e.g. so that each of several workers can take its own slice of a large corpus.
+* The format (written by PackedCorpusWriter):
+    (1). A header of S_SIZE_HEADER bytes: the magic S_MAGIC, then the width and height of the boxes, the size of a
+         record in bytes and the number of puzzles, as little-endian integers of 4, 4, 4 and 8 bytes.
+    (2). The puzzles, one record each, in order. A record holds the cells in row-major order, each in the fewest bits
+         that hold the greatest value of the grid (see GetNumBitsPerCell; e.g. 4 for a 9x9 grid, 5 for 16x16 and
+         25x25), packed from the lowest bit of the first byte upwards. A record is padded to a whole number of bytes.
+* All of the puzzles of a corpus have the dimensions of the header, so every record has the same size and the offset
+  of puzzle #k is S_SIZE_HEADER plus k records: the index is implicit, and costs no space.
+*/
+class PackedCorpus
+{
+
+private:
+
+    // The mapping of the file (nullptr if there's none), and its size in bytes.
+    void* f_mapping;
+    std::size_t f_size_mapping;
+
+    // The contents of the file, when it's read rather than mapped.
+    std::vector<unsigned char> f_contents;
+
+    // The first record, or nullptr if no corpus is open.
+    const unsigned char* f_records;
+
+    // The dimensions of the boxes, and the size of the grid.
+    unsigned int f_width_box;
+    unsigned int f_height_box;
+    unsigned int f_size_grid;
+
+    // The number of bits per cell, the size of a record in bytes, and the number of puzzles.
+    unsigned int f_num_bits_per_cell;
+    std::size_t f_size_record;
+    unsigned long long f_num_puzzles;
+
+
+public:
+
+    // The first bytes of a packed corpus.
+    static const char S_MAGIC[8];
+
+    // The size of the header in bytes.
+    static const std::size_t S_SIZE_HEADER = 28;
+
+
+    PackedCorpus();
+
+    PackedCorpus(const PackedCorpus&) = delete;
+    PackedCorpus& operator=(const PackedCorpus&) = delete;
+
+    ~PackedCorpus();
+
+    /*
+    * Opens the packed corpus p_file, closing any that was open.
+    * Returns false, leaving no corpus open, if the file can't be opened or is malformed; in the latter case
+      p_error describes the problem (it's left empty if the file can't be opened).
+    */
+    bool Open(const char* p_file, std::string& p_error);
+
+    /*
+    * Closes the corpus, if one is open.
+    */
+    void Close();
+
+    bool IsOpen() const;
+
+    unsigned int GetWidthBox() const;
+    unsigned int GetHeightBox() const;
+    unsigned long long GetNumPuzzles() const;
+
+    /*
+    * Loads puzzle #p_index (counting from 0; it must be less than GetNumPuzzles) into p_board, resizing it if
+      necessary. Returns false if the record holds a value greater than the size of the grid.
+    */
+    bool Load(unsigned long long p_index, SudokuBoard& p_board) const;
+
+    /*
+    * Returns whether or not the file p_file begins with S_MAGIC, i.e. should be read as a packed corpus.
+    */
+    static bool IsPackedFile(const char* p_file);
+
+    /*
+    * Returns the number of bits in which each cell of a grid of p_size_grid by p_size_grid cells is stored.
+    */
+    static unsigned int GetNumBitsPerCell(unsigned int p_size_grid);
+
+    /*
+    * Returns the size in bytes of the record of a grid of p_size_grid by p_size_grid cells.
+    */
+    static std::size_t GetSizeRecord(unsigned int p_size_grid);
+
+    /*
+    * Returns the little-endian integer of p_num_bytes bytes at p_bytes.
+    */
+    static unsigned long long ReadInteger(const unsigned char* p_bytes, unsigned int p_num_bytes);
+
+
+private:
+
+    /* Auxiliary of Open
+    * Checks the header of the contents [p_contents, p_contents + p_size) and takes the dimensions and the records
+      from it. Returns false, having described the problem in p_error, if they're malformed.
+    */
+    bool ParseHeader(const unsigned char* p_contents, std::size_t p_size, std::string& p_error);
+
+};
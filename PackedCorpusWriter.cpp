@@ -0,0 +1,134 @@
+#include"PackedCorpusWriter.h"
+
+#include<cstring>
+
+
+PackedCorpusWriter::PackedCorpusWriter()
+    : f_width_box(0), f_height_box(0), f_size_grid(0), f_num_bits_per_cell(0), f_size_record(0), f_num_puzzles(0)
+{
+}
+
+PackedCorpusWriter::~PackedCorpusWriter()
+{
+    Close();
+}
+
+/*
+* Notes:
+    (a). The header is written with no puzzles, so that a corpus whose writer is interrupted is read as empty rather
+         than misread (see Close).
+*/
+bool PackedCorpusWriter::Create(const char* p_file, unsigned int p_width_box, unsigned int p_height_box)
+{
+    Close();
+
+    if (!SudokuBoard::AreDimensionsSupported(p_width_box, p_height_box))
+    { return false; }
+
+    f_file.open(p_file, std::ios::binary | std::ios::trunc);
+
+    if (!f_file.is_open())
+    { return false; }
+
+    f_width_box = p_width_box;
+    f_height_box = p_height_box;
+    f_size_grid = p_width_box * p_height_box;
+    f_num_bits_per_cell = PackedCorpus::GetNumBitsPerCell(f_size_grid);
+    f_size_record = PackedCorpus::GetSizeRecord(f_size_grid);
+    f_num_puzzles = 0;
+
+    // (a).
+    unsigned char l_header[PackedCorpus::S_SIZE_HEADER];
+
+    std::memcpy(l_header, PackedCorpus::S_MAGIC, sizeof(PackedCorpus::S_MAGIC));
+    WriteInteger(l_header + 8, f_width_box, 4);
+    WriteInteger(l_header + 12, f_height_box, 4);
+    WriteInteger(l_header + 16, f_size_record, 4);
+    WriteInteger(l_header + 20, 0, 8);
+
+    f_buffer.assign(l_header, l_header + sizeof(l_header));
+    f_buffer.reserve(S_SIZE_BUFFER + f_size_record);
+
+    return true;
+}
+
+/*
+* Notes:
+    (a). The bits of the cells are gathered in l_bits and written a byte at a time, as PackedCorpus::Load takes them.
+*/
+bool PackedCorpusWriter::Write(const SudokuBoard& p_board)
+{
+    if (p_board.GetWidthBox() != f_width_box || p_board.GetHeightBox() != f_height_box)
+    { return false; }
+
+    const CompactGrid& l_grid = p_board.GetGrid();
+    unsigned int l_num_cells = f_size_grid * f_size_grid;
+
+    // (a).
+    unsigned int l_bits = 0;
+    unsigned int l_num_bits = 0;
+
+    for (unsigned int i = 0; i < l_num_cells; ++i)
+    {
+        l_bits |= static_cast<unsigned int>(l_grid[i]) << l_num_bits;
+        l_num_bits += f_num_bits_per_cell;
+
+        for (; l_num_bits >= 8; l_num_bits -= 8, l_bits >>= 8)
+        { f_buffer.push_back(static_cast<unsigned char>(l_bits)); }
+    }
+
+    if (l_num_bits != 0)
+    { f_buffer.push_back(static_cast<unsigned char>(l_bits)); }
+
+    ++f_num_puzzles;
+
+    if (f_buffer.size() >= S_SIZE_BUFFER)
+    {
+        f_file.write(reinterpret_cast<const char*>(f_buffer.data()), f_buffer.size());
+        f_buffer.clear();
+    }
+
+    return true;
+}
+
+/*
+* Notes:
+    (a). The number of puzzles is only written once all of their records have been, so that a corpus is never read
+         past the end of what was written.
+*/
+bool PackedCorpusWriter::Close()
+{
+    if (!f_file.is_open())
+    { return true; }
+
+    f_file.write(reinterpret_cast<const char*>(f_buffer.data()), f_buffer.size());
+    f_buffer.clear();
+
+    // (a).
+    unsigned char l_num_puzzles[8];
+    WriteInteger(l_num_puzzles, f_num_puzzles, 8);
+
+    f_file.seekp(20);
+    f_file.write(reinterpret_cast<const char*>(l_num_puzzles), sizeof(l_num_puzzles));
+    f_file.close();
+
+    return !f_file.fail();
+}
+
+unsigned long long PackedCorpusWriter::GetNumPuzzles() const
+{
+    return f_num_puzzles;
+}
+
+unsigned long long PackedCorpusWriter::GetSize() const
+{
+    return PackedCorpus::S_SIZE_HEADER + f_num_puzzles * f_size_record;
+}
+
+
+void PackedCorpusWriter::WriteInteger(unsigned char* p_bytes, unsigned long long p_value, unsigned int p_num_bytes)
+{
+    for (unsigned int i = 0; i < p_num_bytes; ++i, p_value >>= 8)
+    { p_bytes[i] = static_cast<unsigned char>(p_value); }
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include<cstddef>
+#include<fstream>
+#include<vector>
+
+#include"PackedCorpus.h"
+#include"SudokuBoard.h"
+
+
+/*
+* Writes a corpus of puzzles in the packed binary format (see PackedCorpus), e.g. to convert a corpus of the text
+  formats of PuzzleReader.
+* The records are gathered into a large buffer, which is written in one call whenever it fills; the number of
+  puzzles, which isn't known until the end, is written into the header by Close.
+*/
+class PackedCorpusWriter
+{
+
+private:
+
+    // The file being written.
+    std::ofstream f_file;
+
+    // The records that haven't been written yet.
+    std::vector<unsigned char> f_buffer;
+
+    // The dimensions of the boxes, and the size of the grid.
+    unsigned int f_width_box;
+    unsigned int f_height_box;
+    unsigned int f_size_grid;
+
+    // The number of bits per cell, the size of a record in bytes, and the number of puzzles written so far.
+    unsigned int f_num_bits_per_cell;
+    std::size_t f_size_record;
+    unsigned long long f_num_puzzles;
+
+
+    // The size of the buffer at which it's written to the file.
+    static const std::size_t S_SIZE_BUFFER = 1 << 20;
+
+
+public:
+
+    PackedCorpusWriter();
+
+    PackedCorpusWriter(const PackedCorpusWriter&) = delete;
+    PackedCorpusWriter& operator=(const PackedCorpusWriter&) = delete;
+
+    /*
+    * Closes the file, if it's still open (see Close).
+    */
+    ~PackedCorpusWriter();
+
+    /*
+    * Creates (or truncates) the file p_file for a corpus of puzzles whose boxes are p_width_box by p_height_box
+      cells, closing any file that was being written.
+    * Returns false if the file can't be created or the dimensions aren't supported (see SudokuBoard::SetDimensions).
+    */
+    bool Create(const char* p_file, unsigned int p_width_box, unsigned int p_height_box);
+
+    /*
+    * Appends the grid of p_board to the corpus. Returns false if the board's dimensions aren't those of the corpus.
+    */
+    bool Write(const SudokuBoard& p_board);
+
+    /*
+    * Writes the records that remain in the buffer and the number of puzzles, and closes the file. Returns false if
+      any of the file couldn't be written.
+    */
+    bool Close();
+
+    unsigned long long GetNumPuzzles() const;
+
+    /*
+    * Returns the number of bytes of the corpus written so far, including those still in the buffer.
+    */
+    unsigned long long GetSize() const;
+
+
+private:
+
+    /* Auxiliary of Create, Close
+    * Writes p_value to p_bytes as a little-endian integer of p_num_bytes bytes.
+    */
+    static void WriteInteger(unsigned char* p_bytes, unsigned long long p_value, unsigned int p_num_bytes);
+
+};
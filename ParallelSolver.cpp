@@ -0,0 +1,152 @@
+#include"ParallelSolver.h"
+
+
+ParallelSolver::ParallelSolver(unsigned int p_num_threads)
+    : f_pool(p_num_threads), f_is_wide(false), f_num_busy(0), f_num_queued(0), f_is_solved(false),
+      f_index_winner(0), f_stats()
+{
+    for (unsigned int i = 0; i < f_pool.GetNumThreads(); ++i)
+    {
+        f_solvers.emplace_back(new SudokuSolver());
+    }
+
+}
+
+unsigned int ParallelSolver::GetNumThreads() const
+{
+    return f_pool.GetNumThreads();
+}
+
+bool ParallelSolver::Solve(const SudokuSolver& p_solver)
+{
+    f_is_wide = false;
+
+    return Search(f_solvers, p_solver);
+}
+
+bool ParallelSolver::Solve(const WideSudokuSolver& p_solver)
+{
+    if (f_solvers_wide.empty())
+    {
+        for (unsigned int i = 0; i < f_pool.GetNumThreads(); ++i)
+        {
+            f_solvers_wide.emplace_back(new WideSudokuSolver());
+        }
+
+    }
+
+    f_is_wide = true;
+
+    return Search(f_solvers_wide, p_solver);
+}
+
+void ParallelSolver::Store(CompactGrid& p_grid) const
+{
+    if (f_is_wide)
+    { f_solvers_wide[f_index_winner]->Store(p_grid); }
+    else
+    { f_solvers[f_index_winner]->Store(p_grid); }
+}
+
+const SolverStats& ParallelSolver::GetStats() const
+{
+    return f_stats;
+}
+
+
+/* Auxiliary of Solve
+
+* Notes:
+    (a). BeginSearch is called once, and its result copied to every thread's solver, so that the decisions of a
+         branch can be replayed by any of them. The copies' counters are cleared so that BeginSearch's work is only
+         counted once.
+    (b). The whole tree is submitted as a single branch; the thread that takes it then hands branches over to the
+         others as they become idle.
+*/
+template <typename Solver>
+bool ParallelSolver::Search(std::vector<std::unique_ptr<Solver>>& p_solvers, const Solver& p_solver)
+{
+    // (a).
+    *p_solvers[0] = p_solver;
+
+    if (!p_solvers[0]->BeginSearch())
+    {
+        f_stats = p_solvers[0]->GetStats();
+        return false;
+    }
+
+    for (unsigned int i = 0; i < p_solvers.size(); ++i)
+    {
+        if (i != 0)
+        {
+            *p_solvers[i] = *p_solvers[0];
+            p_solvers[i]->ClearStats();
+        }
+
+        p_solvers[i]->SetSplitter(this);
+        p_solvers[i]->SetCancelFlag(&f_is_solved);
+    }
+
+    f_is_solved = false;
+
+    // (b).
+    SubmitBranch(std::vector<SudokuSolver::Decision>());
+
+    f_pool.WaitIdle();
+
+    f_stats.ClearSearch();
+
+    for (const std::unique_ptr<Solver>& l_solver : p_solvers)
+    {
+        f_stats.AddSearch(l_solver->GetStats());
+    }
+
+    return f_is_solved;
+}
+
+/*
+* Notes:
+    (a). A branch that's still queued when a solution is found is skipped.
+    (b). Only the first thread to find a solution is recorded as the winner; setting f_is_solved also cancels the
+         searches of the other threads.
+*/
+void ParallelSolver::SubmitBranch(const std::vector<SudokuSolver::Decision>& p_path)
+{
+    ++f_num_queued;
+
+    f_pool.Submit([this, p_path](unsigned int p_worker)
+    {
+        ++f_num_busy;
+        --f_num_queued;
+
+        // (a).
+        if (!f_is_solved && (f_is_wide ? f_solvers_wide[p_worker]->SearchFrom(p_path)
+                                       : f_solvers[p_worker]->SearchFrom(p_path)))
+        {
+            // (b).
+            bool l_expected = false;
+
+            if (f_is_solved.compare_exchange_strong(l_expected, true))
+            { f_index_winner = p_worker; }
+        }
+
+        --f_num_busy;
+    });
+}
+
+/*
+* Notes:
+    (a). Branches are wanted while there are fewer busy threads and queued branches than threads: i.e. while some
+         thread would otherwise be idle.
+*/
+bool ParallelSolver::IsWanted(unsigned int p_depth)
+{
+    // (a).
+    return p_depth <= S_MAX_DEPTH_SPLIT && !f_is_solved.load(std::memory_order_relaxed) &&
+           f_num_busy + f_num_queued < static_cast<int>(f_pool.GetNumThreads());
+}
+
+void ParallelSolver::Donate(const std::vector<SudokuSolver::Decision>& p_path)
+{
+    SubmitBranch(p_path);
+}
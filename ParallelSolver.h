@@ -0,0 +1,101 @@
+#pragma once
+
+#include<atomic>
+#include<memory>
+#include<vector>
+
+#include"CompactGrid.h"
+#include"SudokuSolver.h"
+#include"WorkStealingPool.h"
+
+
+/*
+* Solves a single grid by searching its tree on several threads at once.
+* Each thread has its own copy of the SudokuSolver (or of the WideSudokuSolver, for a grid of more digits than a
+  SudokuSolver can hold). The search starts on one thread; whenever a thread is idle, the
+  busy threads hand over the unexplored branches of their shallow nodes (see SudokuSolver::Splitter), which the idle
+  threads then pick up (or steal) from the pool's queues. Once any thread finds a solution, the others are cancelled.
+*/
+class ParallelSolver : private SudokuSolver::Splitter
+{
+
+private:
+
+    // The threads that run the search.
+    WorkStealingPool f_pool;
+
+    // The solver of each thread, and its wide counterpart, which is only created by the first search that needs it.
+    std::vector<std::unique_ptr<SudokuSolver>> f_solvers;
+    std::vector<std::unique_ptr<WideSudokuSolver>> f_solvers_wide;
+
+    // Whether the current (or last) search uses f_solvers_wide rather than f_solvers.
+    bool f_is_wide;
+
+    // The number of threads that are currently searching a branch, and the number of branches waiting in the pool.
+    std::atomic<int> f_num_busy;
+    std::atomic<int> f_num_queued;
+
+    // Set once a solution has been found, which cancels the search on every thread.
+    std::atomic<bool> f_is_solved;
+
+    // The index of the thread whose solver holds the solution.
+    unsigned int f_index_winner;
+
+    // The counters of the last search, summed over the threads.
+    SolverStats f_stats;
+
+
+    // The maximum depth (number of decisions) at which branches are handed over; deeper branches are likely to be
+    // too small to be worth the cost of replaying their decisions on another thread.
+    static const unsigned int S_MAX_DEPTH_SPLIT = 16;
+
+
+public:
+
+    /*
+    * Creates the solver with p_num_threads threads (0 for one per hardware thread).
+    */
+    ParallelSolver(unsigned int p_num_threads);
+
+    unsigned int GetNumThreads() const;
+
+    /*
+    * Solves the grid that's loaded into p_solver (see SudokuSolver::Load), using its settings and its budget (see
+      SudokuSolver::SetBudget), whose nodes the threads spend together. p_solver itself is left unchanged. Returns
+      whether or not a solution was found.
+    */
+    bool Solve(const SudokuSolver& p_solver);
+    bool Solve(const WideSudokuSolver& p_solver);
+
+    /*
+    * Copies the solution found by the last successful call to Solve into the given grid.
+    */
+    void Store(CompactGrid& p_grid) const;
+
+    /*
+    * Returns the counters of the last call to Solve, summed over the threads (the depth being the greatest of any
+      thread). The branches that were handed over are replayed by the thread that takes them, so their placements are
+      counted again.
+    */
+    const SolverStats& GetStats() const;
+
+
+private:
+
+    /* Auxiliary of Solve
+    * Solves the grid that's loaded into p_solver with the threads' solvers p_solvers (of the same type), as Solve
+      does.
+    */
+    template <typename Solver>
+    bool Search(std::vector<std::unique_ptr<Solver>>& p_solvers, const Solver& p_solver);
+
+    /* Auxiliary of Solve, Donate
+    * Submits the task of searching the branch reached by the given decisions.
+    */
+    void SubmitBranch(const std::vector<SudokuSolver::Decision>& p_path);
+
+    // The implementation of SudokuSolver::Splitter.
+    bool IsWanted(unsigned int p_depth) override;
+    void Donate(const std::vector<SudokuSolver::Decision>& p_path) override;
+
+};
@@ -0,0 +1,262 @@
+#include"PortfolioSolver.h"
+
+#include<cstring>
+#include<iterator>
+
+
+const char* const PortfolioSolver::S_STRATEGIES_DEFAULT = "backtracking,row-major,propagation,dlx";
+
+
+// The strategies that can be named (see ParseStrategies).
+static const PortfolioSolver::Strategy S_STRATEGIES[] =
+{
+    { "backtracking", false, SudokuSolver::Branching::MostConstrained, SudokuSolver::TieBreak::LowestIndex,
+      SudokuSolver::S_NAKED_SINGLES | SudokuSolver::S_HIDDEN_SINGLES, SudokuSolver::Restarts::None },
+    { "row-major", false, SudokuSolver::Branching::RowMajor, SudokuSolver::TieBreak::LowestIndex,
+      SudokuSolver::S_PROPAGATE_NONE, SudokuSolver::Restarts::None },
+    { "most-empty-peers", false, SudokuSolver::Branching::MostConstrained, SudokuSolver::TieBreak::MostEmptyPeers,
+      SudokuSolver::S_NAKED_SINGLES | SudokuSolver::S_HIDDEN_SINGLES, SudokuSolver::Restarts::None },
+    { "propagation", false, SudokuSolver::Branching::MostConstrained, SudokuSolver::TieBreak::LowestIndex,
+      SudokuSolver::S_PROPAGATE_ALL, SudokuSolver::Restarts::None },
+    { "restarts", false, SudokuSolver::Branching::MostConstrained, SudokuSolver::TieBreak::LowestIndex,
+      SudokuSolver::S_NAKED_SINGLES | SudokuSolver::S_HIDDEN_SINGLES, SudokuSolver::Restarts::Luby },
+    { "dlx", true, SudokuSolver::Branching::MostConstrained, SudokuSolver::TieBreak::LowestIndex,
+      SudokuSolver::S_PROPAGATE_NONE, SudokuSolver::Restarts::None }
+};
+
+
+PortfolioSolver::PortfolioSolver(const std::vector<Strategy>& p_strategies)
+    : f_index_winner(-1), f_stats()
+{
+    for (const Strategy& l_strategy : p_strategies)
+    {
+        f_entries.emplace_back(new Entry());
+
+        Entry& l_entry = *f_entries.back();
+        l_entry.strategy = l_strategy;
+        l_entry.solver.SetBranching(l_strategy.branching, l_strategy.tie_break);
+        l_entry.solver.SetPropagation(l_strategy.techniques);
+        l_entry.solver.SetRandomization(l_strategy.restarts != SudokuSolver::Restarts::None);
+        l_entry.solver.SetRestarts(l_strategy.restarts);
+        l_entry.solver_wide.CopySettings(l_entry.solver);
+        l_entry.is_solved = false;
+    }
+
+}
+
+std::vector<PortfolioSolver::Strategy> PortfolioSolver::GetStrategies() const
+{
+    std::vector<Strategy> l_strategies;
+
+    for (const std::unique_ptr<Entry>& l_entry : f_entries)
+    {
+        l_strategies.push_back(l_entry->strategy);
+    }
+
+    return l_strategies;
+}
+
+/*
+* Notes:
+    (a). The budgets are started before any strategy runs, so that a winner can't cancel a budget that's then
+         restarted.
+    (b). The first strategy to finish is the winner, whether it found a solution or showed that there's none; it
+         cancels the others, which give up at their next check of their budgets.
+*/
+bool PortfolioSolver::Solve(const CompactGrid& p_grid, unsigned int p_width_box, unsigned int p_height_box,
+                            const SearchBudget& p_budget)
+{
+    if (!f_pool)
+    { f_pool.reset(new WorkStealingPool(static_cast<unsigned int>(f_entries.size()))); }
+
+    // (a).
+    for (const std::unique_ptr<Entry>& l_entry : f_entries)
+    {
+        l_entry->budget.CopyLimits(p_budget);
+        l_entry->budget.Start();
+        l_entry->is_solved = false;
+    }
+
+    f_index_winner = -1;
+
+    for (unsigned int i = 0; i < f_entries.size(); ++i)
+    {
+        f_pool->Submit([this, i, &p_grid, p_width_box, p_height_box](unsigned int)
+        {
+            if (!Run(*f_entries[i], p_grid, p_width_box, p_height_box))
+            { return; }
+
+            // (b).
+            int l_expected = -1;
+
+            if (!f_index_winner.compare_exchange_strong(l_expected, static_cast<int>(i)))
+            { return; }
+
+            for (unsigned int j = 0; j < f_entries.size(); ++j)
+            {
+                if (j != i)
+                { f_entries[j]->budget.Cancel(); }
+            }
+
+        });
+    }
+
+    f_pool->WaitIdle();
+
+    const Strategy* l_winner = GetWinner();
+
+    f_stats.ClearSearch();
+
+    if (l_winner != nullptr)
+    {
+        f_stats.AddSearch(f_entries[f_index_winner]->stats);
+        f_stats.strategy = l_winner->name;
+    }
+    else
+    {
+        for (const std::unique_ptr<Entry>& l_entry : f_entries)
+        {
+            f_stats.AddSearch(l_entry->stats);
+        }
+
+    }
+
+    return l_winner != nullptr && f_entries[f_index_winner]->is_solved;
+}
+
+const PortfolioSolver::Strategy* PortfolioSolver::GetWinner() const
+{
+    int l_index_winner = f_index_winner;
+
+    return l_index_winner >= 0 ? &f_entries[l_index_winner]->strategy : nullptr;
+}
+
+void PortfolioSolver::Store(CompactGrid& p_grid) const
+{
+    const Entry& l_entry = *f_entries[f_index_winner];
+
+    if (l_entry.strategy.is_dancing_links)
+    { l_entry.solver_dlx.Store(p_grid); }
+    else if (p_grid.GetSize() > SudokuSolver::S_NUM_DIGITS_MAX)
+    { l_entry.solver_wide.Store(p_grid); }
+    else if (l_entry.solver_fixed)
+    { l_entry.solver_fixed->Store(p_grid); }
+    else
+    { l_entry.solver.Store(p_grid); }
+}
+
+const SolverStats& PortfolioSolver::GetStats() const
+{
+    return f_stats;
+}
+
+/*
+* Notes:
+    (a). The names are matched as in the parsing of the techniques in Main.
+*/
+bool PortfolioSolver::ParseStrategies(const char* p_list, std::vector<Strategy>& p_strategies)
+{
+    p_strategies.clear();
+
+    while (*p_list != '\0')
+    {
+        std::size_t l_length = std::strcspn(p_list, ",");
+
+        bool l_is_found = false;
+
+        // (a).
+        if (l_length == 3 && std::strncmp(p_list, "all", 3) == 0)
+        {
+            p_strategies.insert(p_strategies.end(), std::begin(S_STRATEGIES), std::end(S_STRATEGIES));
+            l_is_found = true;
+        }
+
+        for (const Strategy& l_strategy : S_STRATEGIES)
+        {
+            if (std::strlen(l_strategy.name) == l_length && std::strncmp(p_list, l_strategy.name, l_length) == 0)
+            {
+                p_strategies.push_back(l_strategy);
+                l_is_found = true;
+            }
+        }
+
+        if (!l_is_found)
+        { return false; }
+
+        p_list += l_length;
+
+        if (*p_list == ',')
+        { ++p_list; }
+    }
+
+    return !p_strategies.empty();
+}
+
+
+/* Auxiliary of Solve
+
+* Notes:
+    (a). As in SudokuBoard::UseFixedSizeSolver, the specialisation is (re)created when the dimensions change; it's
+         nullptr if there's none for them.
+    (b). Loading the grid also checks it against the rules of sudoku; a grid that violates them has no solution, which
+         is an answer like any other.
+    (c). The search is always metered, even if the budget has no limits, so that it can be cancelled.
+*/
+bool PortfolioSolver::Run(Entry& p_entry, const CompactGrid& p_grid, unsigned int p_width_box,
+                          unsigned int p_height_box)
+{
+    p_entry.stats.ClearSearch();
+
+    // (a).
+    if (!p_entry.strategy.is_dancing_links && p_entry.solver.HasDefaultSettings() &&
+        (!p_entry.solver_fixed || p_entry.solver_fixed->GetWidthBox() != p_width_box ||
+         p_entry.solver_fixed->GetHeightBox() != p_height_box))
+    { p_entry.solver_fixed = FixedSizeSolverBase::Create(p_width_box, p_height_box); }
+
+    if (p_entry.strategy.is_dancing_links)
+    {
+        // (b).
+        if (!p_entry.solver_dlx.Load(p_grid, p_width_box, p_height_box))
+        { return true; }
+
+        // (c).
+        p_entry.solver_dlx.SetBudget(&p_entry.budget);
+        p_entry.is_solved = p_entry.solver_dlx.Solve();
+        p_entry.stats = p_entry.solver_dlx.GetStats();
+    }
+    else if (p_width_box * p_height_box > SudokuSolver::S_NUM_DIGITS_MAX)
+    {
+        // (b).
+        if (!p_entry.solver_wide.Load(p_grid, p_width_box, p_height_box))
+        { return true; }
+
+        // (c).
+        p_entry.solver_wide.SetBudget(&p_entry.budget);
+        p_entry.is_solved = p_entry.solver_wide.Solve();
+        p_entry.stats = p_entry.solver_wide.GetStats();
+    }
+    else if (p_entry.solver_fixed)
+    {
+        // (b).
+        if (!p_entry.solver_fixed->Load(p_grid))
+        { return true; }
+
+        // (c).
+        p_entry.solver_fixed->SetBudget(&p_entry.budget);
+        p_entry.is_solved = p_entry.solver_fixed->Solve();
+        p_entry.stats = p_entry.solver_fixed->GetStats();
+    }
+    else
+    {
+        // (b).
+        if (!p_entry.solver.Load(p_grid, p_width_box, p_height_box))
+        { return true; }
+
+        // (c).
+        p_entry.solver.SetBudget(&p_entry.budget);
+        p_entry.is_solved = p_entry.solver.Solve();
+        p_entry.stats = p_entry.solver.GetStats();
+    }
+
+    return p_entry.is_solved || p_entry.budget.GetLimitReached() == SearchBudget::Limit::None;
+}
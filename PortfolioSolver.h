@@ -0,0 +1,148 @@
+#pragma once
+
+#include<atomic>
+#include<memory>
+#include<vector>
+
+#include"CompactGrid.h"
+#include"DancingLinksSolver.h"
+#include"FixedSizeSolver.h"
+#include"SearchBudget.h"
+#include"SolverStats.h"
+#include"SudokuSolver.h"
+#include"WorkStealingPool.h"
+
+
+/*
+* Solves a single grid by racing several strategies (engines and settings of the search) against each other, each on
+  its own thread, and taking the answer of whichever finishes first; the others are then cancelled.
+* Different puzzles favour different strategies, and a strategy that happens to choose badly early on can take orders
+  of magnitude longer than another on the same grid. Racing them bounds the time by that of the fastest strategy,
+  at the cost of running all of them until it finishes.
+* Each strategy keeps its engine from one grid to the next, and searches within a budget of its own, which has the
+  limits of the budget passed to Solve (so e.g. a node limit applies to each strategy separately); the winner cancels
+  the others through their budgets (see SearchBudget::Cancel).
+*/
+class PortfolioSolver
+{
+
+public:
+
+    // A strategy: the engine, and the settings of the BackTracking engine.
+    struct Strategy
+    {
+        // The name of the strategy (see ParseStrategies).
+        const char* name;
+
+        // Whether the search uses Algorithm X (DancingLinksSolver); otherwise it backtracks (SudokuSolver).
+        bool is_dancing_links;
+
+        // The settings of the BackTracking engine (see SudokuSolver::SetBranching and SetPropagation). With the
+        // defaults, the engine's specialisation for the dimensions of the grid is used if there is one.
+        SudokuSolver::Branching branching;
+        SudokuSolver::TieBreak tie_break;
+        unsigned int techniques;
+
+        // The restart rule of the BackTracking engine, whose choices are then random (see SudokuSolver::SetRestarts).
+        SudokuSolver::Restarts restarts;
+    };
+
+
+private:
+
+    // A strategy, its engines and the state of its last search.
+    struct Entry
+    {
+        Strategy strategy;
+
+        // The engines; only the one used by the strategy is loaded. The specialisation is created by Run when the
+        // dimensions change, and only if the strategy uses the default settings of the BackTracking engine. The wide
+        // engine, which has the settings of solver, is for grids with more digits than solver can hold.
+        SudokuSolver solver;
+        WideSudokuSolver solver_wide;
+        DancingLinksSolver solver_dlx;
+        std::unique_ptr<FixedSizeSolverBase> solver_fixed;
+
+        // The budget of the strategy's search.
+        SearchBudget budget;
+
+        // Whether or not the last search found a solution, and its counters.
+        bool is_solved;
+        SolverStats stats;
+    };
+
+    // The strategies, in the order in which they were given.
+    std::vector<std::unique_ptr<Entry>> f_entries;
+
+    // The threads that run the strategies, one per strategy; created by the first call to Solve.
+    std::unique_ptr<WorkStealingPool> f_pool;
+
+    // The index of the strategy that answered the last call to Solve, or -1 if none did.
+    std::atomic<int> f_index_winner;
+
+    // The counters of the last search (see GetStats).
+    SolverStats f_stats;
+
+
+public:
+
+    /*
+    * Creates the solver with the given strategies, which mustn't be empty.
+    */
+    PortfolioSolver(const std::vector<Strategy>& p_strategies);
+
+    PortfolioSolver(const PortfolioSolver&) = delete;
+    PortfolioSolver& operator=(const PortfolioSolver&) = delete;
+
+    std::vector<Strategy> GetStrategies() const;
+
+    /*
+    * Races the strategies on p_grid, each within a budget with the limits of p_budget (which isn't itself spent).
+    * Returns whether or not a solution was found. Otherwise the grid has no solution (or violates the rules of sudoku)
+      if a strategy finished its search, and the strategies all ran out of budget if none did (see GetWinner).
+    */
+    bool Solve(const CompactGrid& p_grid, unsigned int p_width_box, unsigned int p_height_box,
+               const SearchBudget& p_budget);
+
+    /*
+    * Returns the strategy that answered the last call to Solve, or nullptr if every strategy ran out of budget.
+    */
+    const Strategy* GetWinner() const;
+
+    /*
+    * Copies the solution found by the last successful call to Solve into the given grid.
+    */
+    void Store(CompactGrid& p_grid) const;
+
+    /*
+    * Returns the counters of the last call to Solve: those of the winner's search, naming it as the strategy, or, if
+      there was no winner, those of all of the searches summed.
+    */
+    const SolverStats& GetStats() const;
+
+    /*
+    * Assigns to p_strategies the strategies named in the comma-separated list p_list (e.g. "backtracking,dlx"); the
+      name 'all' stands for every strategy. The strategies are:
+        - "backtracking": the BackTracking engine with its default settings;
+        - "row-major": plain backtracking, over the empty cells in row-major order and without propagation;
+        - "most-empty-peers": as "backtracking", but breaking ties between cells by their number of empty peers;
+        - "propagation": as "backtracking", but applying every technique at every node;
+        - "restarts": as "backtracking", but with random choices and restarts on the Luby sequence;
+        - "dlx": the DancingLinks engine.
+    * Returns false if any of the names aren't recognised, or the list is empty.
+    */
+    static bool ParseStrategies(const char* p_list, std::vector<Strategy>& p_strategies);
+
+    // The strategies raced when none are given: a list for ParseStrategies.
+    static const char* const S_STRATEGIES_DEFAULT;
+
+
+private:
+
+    /* Auxiliary of Solve
+    * Searches p_grid with the strategy of p_entry, whose budget has been started, recording whether it found a
+      solution. Returns false if it ran out of budget (or was cancelled) before it could tell.
+    */
+    bool Run(Entry& p_entry, const CompactGrid& p_grid, unsigned int p_width_box, unsigned int p_height_box);
+
+};
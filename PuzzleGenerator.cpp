@@ -0,0 +1,445 @@
+#include"PuzzleGenerator.h"
+
+#include<algorithm>
+#include<atomic>
+#include<memory>
+#include<sstream>
+#include<string>
+
+#include"BitUtils.h"
+#include"BoardWriter.h"
+#include"PuzzleReader.h"
+#include"WorkStealingPool.h"
+
+
+PuzzleGenerator::PuzzleGenerator()
+    : f_width_box(0), f_height_box(0), f_size_grid(0), f_target_clues(0), f_symmetry(Symmetry::None), f_seed(0)
+{
+    SetDimensions(3, 3);
+}
+
+bool PuzzleGenerator::SetDimensions(unsigned int p_width_box, unsigned int p_height_box)
+{
+    if (!f_board.SetDimensions(p_width_box, p_height_box))
+    { return false; }
+
+    if (p_width_box != f_width_box || p_height_box != f_height_box)
+    {
+        f_width_box = p_width_box;
+        f_height_box = p_height_box;
+        f_size_grid = f_width_box * f_height_box;
+
+        f_solution.resize(f_size_grid * f_size_grid);
+        f_puzzle.resize(f_size_grid * f_size_grid);
+
+        BuildGroups();
+    }
+
+    return true;
+}
+
+unsigned int PuzzleGenerator::GetWidthBox() const
+{
+    return f_width_box;
+}
+
+unsigned int PuzzleGenerator::GetHeightBox() const
+{
+    return f_height_box;
+}
+
+void PuzzleGenerator::SetTargetClues(unsigned int p_target_clues)
+{
+    f_target_clues = p_target_clues;
+}
+
+void PuzzleGenerator::SetSymmetry(Symmetry p_symmetry)
+{
+    if (p_symmetry != f_symmetry)
+    {
+        f_symmetry = p_symmetry;
+        BuildGroups();
+    }
+
+}
+
+void PuzzleGenerator::Seed(unsigned long long p_seed)
+{
+    f_seed = p_seed;
+    f_random.seed(p_seed);
+}
+
+void PuzzleGenerator::CopySettings(const PuzzleGenerator& p_other)
+{
+    SetDimensions(p_other.f_width_box, p_other.f_height_box);
+    SetTargetClues(p_other.f_target_clues);
+    SetSymmetry(p_other.f_symmetry);
+    Seed(p_other.f_seed);
+}
+
+unsigned int PuzzleGenerator::Generate(SudokuBoard& p_puzzle)
+{
+    FillGrid();
+
+    unsigned int l_num_clues = RemoveClues();
+
+    p_puzzle.SetDimensions(f_width_box, f_height_box);
+
+    for (unsigned int cell = 0; cell < f_puzzle.size(); ++cell)
+    {
+        p_puzzle.SetValue(cell / f_size_grid, cell % f_size_grid, f_puzzle[cell]);
+    }
+
+    return l_num_clues;
+}
+
+/*
+* Notes:
+    (a). As in BatchSolver::RunParallel, the puzzles are made in blocks, whose tasks the pool distributes among its
+         workers; each worker has its own generator, and each puzzle's text is stored until its block is written.
+*/
+unsigned long long PuzzleGenerator::GenerateBatch(unsigned long long p_num_puzzles, unsigned int p_num_threads,
+                                                  std::ostream& p_output)
+{
+    WorkStealingPool l_pool(p_num_threads);
+
+    // The generator and puzzle of each worker.
+    std::vector<std::unique_ptr<PuzzleGenerator>> l_generators;
+    std::vector<std::unique_ptr<SudokuBoard>> l_puzzles;
+
+    for (unsigned int i = 0; i < l_pool.GetNumThreads(); ++i)
+    {
+        l_generators.emplace_back(new PuzzleGenerator());
+        l_generators.back()->CopySettings(*this);
+        l_puzzles.emplace_back(new SudokuBoard());
+    }
+
+    std::vector<std::string> l_results(S_SIZE_BLOCK);
+    std::atomic<unsigned long long> l_num_clues(0);
+
+    // (a).
+    for (unsigned long long l_first = 0; l_first < p_num_puzzles; l_first += S_SIZE_BLOCK)
+    {
+        unsigned int l_size_block = static_cast<unsigned int>(std::min<unsigned long long>(S_SIZE_BLOCK,
+                                                                                           p_num_puzzles - l_first));
+
+        for (unsigned int l_begin = 0; l_begin < l_size_block; l_begin += S_SIZE_TASK)
+        {
+            unsigned int l_end = std::min(l_begin + S_SIZE_TASK, l_size_block);
+
+            l_pool.Submit([&, l_first, l_begin, l_end](unsigned int p_worker)
+            {
+                PuzzleGenerator& l_generator = *l_generators[p_worker];
+                SudokuBoard& l_puzzle = *l_puzzles[p_worker];
+
+                std::ostringstream l_buffer;
+
+                for (unsigned int i = l_begin; i < l_end; ++i)
+                {
+                    l_generator.SeedForIndex(l_first + i);
+                    l_num_clues += l_generator.Generate(l_puzzle);
+
+                    l_buffer.str(std::string());
+                    WritePuzzle(l_buffer, l_puzzle);
+                    l_results[i] = l_buffer.str();
+                }
+
+            });
+        }
+
+        l_pool.WaitIdle();
+
+        for (unsigned int i = 0; i < l_size_block; ++i)
+        {
+            p_output << l_results[i];
+        }
+
+    }
+
+    p_output.flush();
+
+    return l_num_clues;
+}
+
+/*
+* Notes:
+    (a). The dimensions are written first, unless the one-line format implies them (see
+         PuzzleReader::GetBoxDimensions), which it can only do for a grid of at most 35 digits.
+*/
+void PuzzleGenerator::WritePuzzle(std::ostream& p_output, const SudokuBoard& p_puzzle)
+{
+    unsigned int l_size_grid = p_puzzle.GetSizeGrid();
+    unsigned int l_width_box = 0;
+    unsigned int l_height_box = 0;
+
+    // (a).
+    bool l_is_one_line = l_size_grid <= 35 && PuzzleReader::GetBoxDimensions(l_size_grid, l_width_box, l_height_box) &&
+                         l_width_box == p_puzzle.GetWidthBox() && l_height_box == p_puzzle.GetHeightBox();
+
+    std::string l_text;
+    BoardWriter::Render(l_text, p_puzzle, l_is_one_line ? BoardWriter::Format::Compact : BoardWriter::Format::Raw);
+
+    p_output.write(l_text.data(), l_text.size());
+}
+
+
+/* Auxiliary of Generate
+
+* Notes:
+    (a). The boxes on the diagonal of the grid of boxes share no row or column, so each can be filled with its own
+         random permutation of the digits without conflict. The solver then completes the grid; in the rare case that
+         it can't, new permutations are tried.
+    (b). The solver's completion is deterministic, so the grid is shuffled further by permuting the bands (the rows
+         of boxes) and the rows within each band, and likewise the stacks (the columns of boxes) and the columns within
+         each stack, which keeps it solved.
+*/
+void PuzzleGenerator::FillGrid()
+{
+    std::vector<unsigned int> l_digits(f_size_grid);
+
+    for (unsigned int i = 0; i < f_size_grid; ++i)
+    {
+        l_digits[i] = i + 1;
+    }
+
+    // (a).
+    do
+    {
+        f_board.EmptyBoard();
+
+        for (unsigned int box = 0; box < std::min(f_width_box, f_height_box); ++box)
+        {
+            std::shuffle(l_digits.begin(), l_digits.end(), f_random);
+
+            for (unsigned int i = 0; i < f_size_grid; ++i)
+            {
+                f_board.SetValue(box * f_height_box + i / f_width_box, box * f_width_box + i % f_width_box, l_digits[i]);
+            }
+
+        }
+
+    } while (!f_board.Solve());
+
+    // (b).
+    std::vector<unsigned int> l_rows(f_size_grid);
+    std::vector<unsigned int> l_cols(f_size_grid);
+
+    // Assigns to p_order a random order of p_num_groups groups of p_size_group consecutive lines, with the lines of
+    // each group also in a random order.
+    auto l_shuffle_lines = [&](std::vector<unsigned int>& p_order, unsigned int p_num_groups, unsigned int p_size_group)
+    {
+        std::vector<unsigned int> l_groups(p_num_groups);
+
+        for (unsigned int i = 0; i < p_num_groups; ++i)
+        {
+            l_groups[i] = i;
+        }
+
+        std::shuffle(l_groups.begin(), l_groups.end(), f_random);
+
+        for (unsigned int i = 0; i < p_num_groups; ++i)
+        {
+            for (unsigned int j = 0; j < p_size_group; ++j)
+            {
+                p_order[i * p_size_group + j] = l_groups[i] * p_size_group + j;
+            }
+
+            std::shuffle(p_order.begin() + i * p_size_group, p_order.begin() + (i + 1) * p_size_group, f_random);
+        }
+
+    };
+
+    l_shuffle_lines(l_rows, f_width_box, f_height_box);
+    l_shuffle_lines(l_cols, f_height_box, f_width_box);
+
+    for (unsigned int row = 0; row < f_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < f_size_grid; ++col)
+        {
+            f_solution[row * f_size_grid + col] = f_board.GetValue(l_rows[row], l_cols[col]);
+        }
+
+    }
+
+}
+
+/* Auxiliary of Generate
+
+* Notes:
+    (a). A group is skipped if removing it would take the puzzle below the target, though a smaller group that comes
+         later may still be removed.
+    (b). The removal of a group keeps the solution unique if each of its cells is then forced by the clues of its
+         peers (which is cheap to check, and is usually the case while there are many clues); otherwise the puzzle is
+         searched for a solution other than f_solution.
+*/
+unsigned int PuzzleGenerator::RemoveClues()
+{
+    f_puzzle = f_solution;
+
+    unsigned int l_num_clues = static_cast<unsigned int>(f_puzzle.size());
+
+    // The order is reset first, so that it only depends on the state of f_random.
+    for (unsigned int i = 0; i < f_group_order.size(); ++i)
+    {
+        f_group_order[i] = i;
+    }
+
+    std::shuffle(f_group_order.begin(), f_group_order.end(), f_random);
+
+    for (unsigned int l_group : f_group_order)
+    {
+        unsigned int l_size_group = f_group_begin[l_group + 1] - f_group_begin[l_group];
+
+        // (a).
+        if (l_num_clues < f_target_clues + l_size_group)
+        { continue; }
+
+        for (unsigned int i = f_group_begin[l_group]; i < f_group_begin[l_group + 1]; ++i)
+        {
+            f_puzzle[f_group_cells[i]] = S_VALUE_EMPTY_CELL;
+        }
+
+        // (b).
+        if (IsGroupForced(l_group) || !HasOtherSolution(l_group))
+        {
+            l_num_clues -= l_size_group;
+            continue;
+        }
+
+        for (unsigned int i = f_group_begin[l_group]; i < f_group_begin[l_group + 1]; ++i)
+        {
+            f_puzzle[f_group_cells[i]] = f_solution[f_group_cells[i]];
+        }
+
+    }
+
+    return l_num_clues;
+}
+
+bool PuzzleGenerator::IsGroupForced(unsigned int p_group) const
+{
+    for (unsigned int i = f_group_begin[p_group]; i < f_group_begin[p_group + 1]; ++i)
+    {
+        if (CountBits(GetCandidates(f_group_cells[i])) != 1)
+        { return false; }
+    }
+
+    return true;
+}
+
+/*
+* Notes:
+    (a). A solution other than f_solution differs from it in at least one of the group's cells (as the other cells are
+         clues). The first cell in which it differs is tried with each of its other candidates in turn, with the cells
+         of the group before it restored to their values in f_solution; each trial is a search for any solution,
+         which stops as soon as one is found.
+    (b). Solve leaves the board unchanged when it fails, so the puzzle only needs to be copied to it once.
+*/
+bool PuzzleGenerator::HasOtherSolution(unsigned int p_group)
+{
+    // (b).
+    for (unsigned int cell = 0; cell < f_puzzle.size(); ++cell)
+    {
+        f_board.SetValue(cell / f_size_grid, cell % f_size_grid, f_puzzle[cell]);
+    }
+
+    // (a).
+    for (unsigned int i = f_group_begin[p_group]; i < f_group_begin[p_group + 1]; ++i)
+    {
+        unsigned int l_cell = f_group_cells[i];
+        unsigned int l_value = f_solution[l_cell];
+
+        Mask l_others = GetCandidates(l_cell) & ~(Mask(1) << (l_value - 1));
+
+        for (; l_others != 0; l_others &= l_others - 1)
+        {
+            f_board.SetValue(l_cell / f_size_grid, l_cell % f_size_grid, IndexLowestBit(l_others) + 1);
+
+            if (f_board.Solve())
+            { return true; }
+        }
+
+        f_board.SetValue(l_cell / f_size_grid, l_cell % f_size_grid, l_value);
+    }
+
+    return false;
+}
+
+PuzzleGenerator::Mask PuzzleGenerator::GetCandidates(unsigned int p_cell) const
+{
+    unsigned int l_row = p_cell / f_size_grid;
+    unsigned int l_col = p_cell % f_size_grid;
+    unsigned int l_row_min_box = l_row - l_row % f_height_box;
+    unsigned int l_col_min_box = l_col - l_col % f_width_box;
+
+    // The digits of the clues of the cell's peers, in bits 0 to f_size_grid - 1 (empty cells set the highest bit,
+    // which is beyond the digits of any grid, instead).
+    const unsigned int l_index_bit_max = WideSudokuSolver::S_NUM_DIGITS_MAX - 1;
+    Mask l_used = 0;
+
+    for (unsigned int i = 0; i < f_size_grid; ++i)
+    {
+        unsigned int l_cell_box = (l_row_min_box + i / f_width_box) * f_size_grid + l_col_min_box + i % f_width_box;
+
+        l_used |= Mask(1) << ((f_puzzle[l_row * f_size_grid + i] - 1) & l_index_bit_max);
+        l_used |= Mask(1) << ((f_puzzle[i * f_size_grid + l_col] - 1) & l_index_bit_max);
+        l_used |= Mask(1) << ((f_puzzle[l_cell_box] - 1) & l_index_bit_max);
+    }
+
+    return (~Mask(0) >> (WideSudokuSolver::S_NUM_DIGITS_MAX - f_size_grid)) & ~l_used;
+}
+
+/*
+* Notes:
+    (a). Each of the symmetries is an involution (its own inverse), so the group of a cell is the cell and its image;
+         the group is recorded once, from whichever of its cells comes first.
+*/
+void PuzzleGenerator::BuildGroups()
+{
+    unsigned int l_num_cells = f_size_grid * f_size_grid;
+
+    f_group_cells.clear();
+    f_group_begin.clear();
+    f_group_order.clear();
+
+    // (a).
+    for (unsigned int cell = 0; cell < l_num_cells; ++cell)
+    {
+        unsigned int l_image = GetImage(cell);
+
+        if (l_image < cell)
+        { continue; }
+
+        f_group_order.push_back(0);
+        f_group_begin.push_back(static_cast<unsigned int>(f_group_cells.size()));
+        f_group_cells.push_back(cell);
+
+        if (l_image != cell)
+        { f_group_cells.push_back(l_image); }
+    }
+
+    f_group_begin.push_back(static_cast<unsigned int>(f_group_cells.size()));
+}
+
+unsigned int PuzzleGenerator::GetImage(unsigned int p_cell) const
+{
+    unsigned int l_row = p_cell / f_size_grid;
+    unsigned int l_col = p_cell % f_size_grid;
+
+    switch (f_symmetry)
+    {
+    case Symmetry::Rotational: return (f_size_grid - 1 - l_row) * f_size_grid + (f_size_grid - 1 - l_col);
+    case Symmetry::Mirror: return l_row * f_size_grid + (f_size_grid - 1 - l_col);
+    case Symmetry::Diagonal: return l_col * f_size_grid + l_row;
+    default: return p_cell;
+    }
+
+}
+
+void PuzzleGenerator::SeedForIndex(unsigned long long p_index)
+{
+    std::seed_seq l_seed_seq{ static_cast<unsigned int>(f_seed), static_cast<unsigned int>(f_seed >> 32),
+                              static_cast<unsigned int>(p_index), static_cast<unsigned int>(p_index >> 32) };
+
+    f_random.seed(l_seed_seq);
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include<iostream>
+#include<random>
+#include<vector>
+
+#include"SudokuBoard.h"
+
+
+/*
+* Generates puzzles that have exactly one solution, for any of the box dimensions that SudokuBoard supports.
+* A puzzle is made by filling a grid at random (see FillGrid) and then removing its clues in a random order, each
+  removal being kept only if the solution is still unique (see RemoveClues). The removal stops at a target number of
+  clues, if one is set, and can keep the pattern of the clues symmetrical.
+* The puzzles of GenerateBatch depend only on the seed and the settings, not on the number of threads.
+*/
+class PuzzleGenerator
+{
+
+public:
+
+    // The symmetry of the pattern of clues: a clue is only removed along with its images under the symmetry.
+    enum class Symmetry
+    {
+        // Any pattern.
+        None,
+
+        // The pattern is unchanged by a rotation of the grid through 180 degrees.
+        Rotational,
+
+        // The pattern is unchanged by a reflection of the grid in its vertical centre line.
+        Mirror,
+
+        // The pattern is unchanged by a reflection of the grid in its main (top-left to bottom-right) diagonal.
+        Diagonal
+    };
+
+
+private:
+
+    // A set of digits, as in the BackTracking engine; wide enough for the digits of any grid of SudokuBoard.
+    typedef WideSudokuSolver::Mask Mask;
+
+    // The width of a box in the grid.
+    unsigned int f_width_box;
+
+    // The height of a box in the grid.
+    unsigned int f_height_box;
+
+    // The dimension (width/height) of the grid.
+    unsigned int f_size_grid;
+
+    // The number of clues at which the removal stops (0 to remove as many as possible).
+    unsigned int f_target_clues;
+
+    // The symmetry of the pattern of clues.
+    Symmetry f_symmetry;
+
+    // The seed of GenerateBatch, from which the random numbers of each of its puzzles are derived.
+    unsigned long long f_seed;
+
+    // The source of the random choices.
+    std::mt19937_64 f_random;
+
+    // The board on which the full grid is solved and the uniqueness of the puzzle is checked.
+    SudokuBoard f_board;
+
+    // The full grid and the puzzle that's being made from it, indexed by row * f_size_grid + col.
+    std::vector<unsigned int> f_solution;
+    std::vector<unsigned int> f_puzzle;
+
+    // The cells that are removed together (a cell and its images under f_symmetry), and the order in which the groups
+    // are tried; the cells of group g are at indexes f_group_begin[g] to f_group_begin[g + 1] - 1 of f_group_cells.
+    std::vector<unsigned int> f_group_cells;
+    std::vector<unsigned int> f_group_begin;
+    std::vector<unsigned int> f_group_order;
+
+    // The number of puzzles that GenerateBatch makes in one go, and the number in each task.
+    static const unsigned int S_SIZE_BLOCK = 1024;
+    static const unsigned int S_SIZE_TASK = 4;
+
+    // The value used for empty cells in the grid.
+    static const unsigned int S_VALUE_EMPTY_CELL = 0;
+
+
+public:
+
+    PuzzleGenerator();
+
+    /*
+    * Sets the dimensions of the boxes of the puzzles; the default is 3x3.
+    * Returns false, leaving the generator unchanged, if SudokuBoard doesn't support them.
+    */
+    bool SetDimensions(unsigned int p_width_box, unsigned int p_height_box);
+
+    unsigned int GetWidthBox() const;
+
+    unsigned int GetHeightBox() const;
+
+    /*
+    * Sets the number of clues at which the removal stops; the default, 0, removes as many as possible.
+    * The target isn't always reached, as the puzzle may have no clue left whose removal keeps the solution unique.
+    * For grids larger than 16x16, a target of around half of the cells is advisable: the searches that check the
+      removals get much slower as the puzzle nears a minimal one.
+    */
+    void SetTargetClues(unsigned int p_target_clues);
+
+    /*
+    * Sets the symmetry of the pattern of clues; the default is None.
+    */
+    void SetSymmetry(Symmetry p_symmetry);
+
+    /*
+    * Seeds the random choices of Generate and GenerateBatch.
+    */
+    void Seed(unsigned long long p_seed);
+
+    /*
+    * Copies the settings (dimensions, target, symmetry and seed) of p_other.
+    */
+    void CopySettings(const PuzzleGenerator& p_other);
+
+    /*
+    * Generates a puzzle into p_puzzle, whose dimensions are set to the generator's, and returns its number of clues.
+    */
+    unsigned int Generate(SudokuBoard& p_puzzle);
+
+    /*
+    * Generates p_num_puzzles puzzles on p_num_threads threads (0 for one per hardware thread), writing them to
+      p_output in the format that BatchSolver reads (see WritePuzzle). Returns the total number of clues.
+    * The i-th puzzle (from 0) is generated from the seed and i alone, so the output is the same for any number of
+      threads.
+    */
+    unsigned long long GenerateBatch(unsigned long long p_num_puzzles, unsigned int p_num_threads,
+                                     std::ostream& p_output);
+
+    /*
+    * Writes p_puzzle in the one-line format (see PuzzleReader), or, if its dimensions can't be inferred from that
+      format, in the format of the example files.
+    */
+    static void WritePuzzle(std::ostream& p_output, const SudokuBoard& p_puzzle);
+
+
+private:
+
+    /* Auxiliary of Generate
+    * Fills f_solution with a random solved grid.
+    */
+    void FillGrid();
+
+    /* Auxiliary of Generate
+    * Sets f_puzzle to f_solution and removes as many of its clues as it can (down to f_target_clues) while keeping
+      its solution unique. Returns the number of clues that are left.
+    */
+    unsigned int RemoveClues();
+
+    /* Auxiliary of RemoveClues
+    * Returns whether or not every cell of the group p_group is empty in f_puzzle and has exactly one candidate given
+      the clues of its row, column and box, in which case the group's clues can be removed without a search.
+    */
+    bool IsGroupForced(unsigned int p_group) const;
+
+    /* Auxiliary of RemoveClues
+    * Returns whether or not f_puzzle, from which the clues of the group p_group have just been removed, has a
+      solution other than f_solution.
+    * This is faster than counting the solutions (see SudokuBoard::CountSolutions), which would find f_solution again
+      before searching the rest of the tree for another; here the branches that lead to f_solution aren't searched.
+    */
+    bool HasOtherSolution(unsigned int p_group);
+
+    /* Auxiliary of IsGroupForced, HasOtherSolution
+    * Returns the digits that aren't the value of a clue of f_puzzle in p_cell's row, column or box.
+    */
+    Mask GetCandidates(unsigned int p_cell) const;
+
+    /* Auxiliary of SetDimensions, SetSymmetry
+    * Divides the cells into the groups of f_group_cells according to f_symmetry.
+    */
+    void BuildGroups();
+
+    /* Auxiliary of BuildGroups
+    * Returns the image of p_cell under f_symmetry.
+    */
+    unsigned int GetImage(unsigned int p_cell) const;
+
+    /* Auxiliary of GenerateBatch
+    * Reseeds f_random for the p_index-th puzzle of a batch.
+    */
+    void SeedForIndex(unsigned long long p_index);
+
+};
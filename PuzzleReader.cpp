@@ -0,0 +1,286 @@
+#include"PuzzleReader.h"
+
+#include<algorithm>
+#include<climits>
+
+
+PuzzleReader::PuzzleReader()
+    : f_line_start(nullptr), f_line(nullptr), f_line_end(nullptr), f_num_lines(0),
+      f_index_corpus(0), f_end_corpus(0)
+{
+}
+
+PuzzleReader::PuzzleReader(std::istream& p_input, bool p_is_by_line)
+    : f_input(p_input, p_is_by_line), f_line_start(nullptr), f_line(nullptr), f_line_end(nullptr), f_num_lines(0),
+      f_index_corpus(0), f_end_corpus(0)
+{
+}
+
+bool PuzzleReader::Open(const char* p_file)
+{
+    f_num_lines = 0;
+    f_error.clear();
+
+    f_corpus.Close();
+    f_index_corpus = f_end_corpus = 0;
+
+    if (!PackedCorpus::IsPackedFile(p_file))
+    { return f_input.Open(p_file); }
+
+    if (!f_corpus.Open(p_file, f_error))
+    { return false; }
+
+    f_end_corpus = f_corpus.GetNumPuzzles();
+
+    return true;
+}
+
+bool PuzzleReader::SelectShard(unsigned int p_index, unsigned int p_num_shards)
+{
+    if (!f_corpus.IsOpen() || p_index >= p_num_shards)
+    { return false; }
+
+    unsigned long long l_num_puzzles = f_corpus.GetNumPuzzles();
+
+    f_index_corpus = l_num_puzzles * p_index / p_num_shards;
+    f_end_corpus = l_num_puzzles * (p_index + 1) / p_num_shards;
+
+    return true;
+}
+
+/*
+* Notes:
+    (a). A line consisting of exactly two whole numbers is the first line of format (1); a line without any blanks
+         is a puzzle of format (2).
+*/
+bool PuzzleReader::Read(SudokuBoard& p_board)
+{
+    f_error.clear();
+
+    if (f_corpus.IsOpen())
+    { return ReadPacked(p_board); }
+
+    if (!ReadContentLine())
+    { return false; }
+
+    // (a).
+    const char* l_text = f_line;
+    unsigned int l_width_box;
+    unsigned int l_height_box;
+
+    if (ScanNumber(l_text, l_width_box) && l_text != f_line_end && IsBlank(*l_text))
+    {
+        for (; IsBlank(*l_text); ++l_text);
+
+        if (ScanNumber(l_text, l_height_box) && l_text == f_line_end)
+        { return ReadDimensionsFormat(p_board, l_width_box, l_height_box); }
+    }
+
+    if (std::find_if(f_line, f_line_end, IsBlank) == f_line_end)
+    { return ReadOneLineFormat(p_board); }
+
+    return Fail("unrecognised puzzle format", f_line);
+}
+
+bool PuzzleReader::ReadLine(const char* p_begin, const char* p_end, SudokuBoard& p_board)
+{
+    f_error.clear();
+    ++f_num_lines;
+
+    f_line_start = p_begin;
+    f_line_end = p_end;
+
+    // Leave out the trailing and leading blanks.
+    for (; f_line_end != f_line_start && IsBlank(f_line_end[-1]); --f_line_end);
+    for (f_line = f_line_start; f_line != f_line_end && IsBlank(*f_line); ++f_line);
+
+    if (f_line == f_line_end || *f_line == '#')
+    { return false; }
+
+    if (std::find_if(f_line, f_line_end, IsBlank) != f_line_end)
+    { return Fail("unrecognised puzzle format", f_line); }
+
+    return ReadOneLineFormat(p_board);
+}
+
+const std::string& PuzzleReader::GetError() const
+{
+    return f_error;
+}
+
+bool PuzzleReader::GetBoxDimensions(unsigned int p_size_grid, unsigned int& p_width_box, unsigned int& p_height_box)
+{
+    for (unsigned int width = 1; width <= p_size_grid; ++width)
+    {
+        if (p_size_grid % width != 0 || width * width < p_size_grid)
+        { continue; }
+
+        p_width_box = width;
+        p_height_box = p_size_grid / width;
+
+        return p_height_box >= 2;
+    }
+
+    return false;
+}
+
+char PuzzleReader::ToChar(unsigned int p_value)
+{
+    if (p_value == 0)
+    { return '.'; }
+
+    return p_value <= 9 ? static_cast<char>('0' + p_value) : static_cast<char>('A' + (p_value - 10));
+}
+
+
+bool PuzzleReader::ReadContentLine()
+{
+    while (f_input.NextLine(f_line_start, f_line_end))
+    {
+        ++f_num_lines;
+
+        // Leave out the trailing and leading blanks.
+        for (; f_line_end != f_line_start && IsBlank(f_line_end[-1]); --f_line_end);
+        for (f_line = f_line_start; f_line != f_line_end && IsBlank(*f_line); ++f_line);
+
+        if (f_line != f_line_end && *f_line != '#')
+        { return true; }
+    }
+
+    return false;
+}
+
+bool PuzzleReader::ScanNumber(const char*& p_text, unsigned int& p_value) const
+{
+    const char* l_start = p_text;
+    unsigned long long l_value = 0;
+
+    for (; p_text != f_line_end && *p_text >= '0' && *p_text <= '9'; ++p_text)
+    {
+        l_value = std::min<unsigned long long>(l_value * 10 + (*p_text - '0'), UINT_MAX);
+    }
+
+    p_value = static_cast<unsigned int>(l_value);
+
+    return p_text != l_start;
+}
+
+bool PuzzleReader::IsBlank(char p_char)
+{
+    return p_char == ' ' || p_char == '\t' || p_char == '\r';
+}
+
+/*
+* Notes:
+    (a). The values may be spread over any number of lines; blank lines (such as those that separate rows of boxes
+         in the example files) are skipped.
+*/
+bool PuzzleReader::ReadDimensionsFormat(SudokuBoard& p_board, unsigned int p_width_box, unsigned int p_height_box)
+{
+    if (!p_board.SetDimensions(p_width_box, p_height_box))
+    { return Fail("invalid box dimensions", f_line); }
+
+    unsigned int l_size_grid = p_board.GetSizeGrid();
+    unsigned int l_num_cells = l_size_grid * l_size_grid;
+
+    // (a).
+    for (unsigned int l_num_read = 0; l_num_read < l_num_cells; )
+    {
+        if (!ReadContentLine())
+        { return Fail("unexpected end of input in the middle of a puzzle", nullptr); }
+
+        const char* l_text = f_line;
+
+        while (l_text != f_line_end)
+        {
+            const char* l_start = l_text;
+            unsigned int l_value;
+
+            if (!ScanNumber(l_text, l_value) || (l_text != f_line_end && !IsBlank(*l_text)))
+            { return Fail("expected a whole number", l_text); }
+
+            if (l_value > l_size_grid)
+            { return Fail("value out of range", l_start); }
+
+            if (l_num_read == l_num_cells)
+            { return Fail("too many values for the puzzle's dimensions", l_start); }
+
+            p_board.SetValue(l_num_read / l_size_grid, l_num_read % l_size_grid, l_value);
+            ++l_num_read;
+
+            for (; l_text != f_line_end && IsBlank(*l_text); ++l_text);
+        }
+
+    }
+
+    return true;
+}
+
+bool PuzzleReader::ReadOneLineFormat(SudokuBoard& p_board)
+{
+    std::size_t l_length = f_line_end - f_line;
+
+    unsigned int l_size_grid = 0;
+    while ((l_size_grid + 1) * (l_size_grid + 1) <= l_length)
+    { ++l_size_grid; }
+
+    unsigned int l_width_box;
+    unsigned int l_height_box;
+
+    if (l_size_grid * l_size_grid != l_length ||
+        !GetBoxDimensions(l_size_grid, l_width_box, l_height_box) ||
+        !p_board.SetDimensions(l_width_box, l_height_box))
+    { return Fail("the length of the line doesn't correspond to a supported grid size", f_line); }
+
+    for (unsigned int i = 0; i < l_length; ++i)
+    {
+        char l_char = f_line[i];
+        unsigned int l_value;
+
+        if (l_char == '.' || l_char == '0')
+        { l_value = 0; }
+        else if (l_char >= '1' && l_char <= '9')
+        { l_value = l_char - '0'; }
+        else if (l_char >= 'A' && l_char <= 'Z')
+        { l_value = 10 + (l_char - 'A'); }
+        else if (l_char >= 'a' && l_char <= 'z')
+        { l_value = 10 + (l_char - 'a'); }
+        else
+        { return Fail("unexpected character", f_line + i); }
+
+        if (l_value > l_size_grid)
+        { return Fail("value out of range", f_line + i); }
+
+        p_board.SetValue(i / l_size_grid, i % l_size_grid, l_value);
+    }
+
+    return true;
+}
+
+bool PuzzleReader::ReadPacked(SudokuBoard& p_board)
+{
+    if (f_index_corpus == f_end_corpus)
+    { return false; }
+
+    if (!f_corpus.Load(f_index_corpus, p_board))
+    {
+        f_error = "puzzle " + std::to_string(f_index_corpus) + " of the packed corpus: value out of range";
+        return false;
+    }
+
+    ++f_index_corpus;
+
+    return true;
+}
+
+bool PuzzleReader::Fail(const char* p_message, const char* p_position)
+{
+    f_error = "line " + std::to_string(f_num_lines);
+
+    if (p_position != nullptr)
+    { f_error += ", column " + std::to_string(p_position - f_line_start + 1); }
+
+    f_error += std::string(": ") + p_message;
+
+    return false;
+}
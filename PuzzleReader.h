@@ -0,0 +1,155 @@
+#pragma once
+
+#include<iostream>
+#include<string>
+
+#include"InputBuffer.h"
+#include"PackedCorpus.h"
+#include"SudokuBoard.h"
+
+
+/*
+* Reads a sequence of sudoku puzzles from a stream, one at a time, into a SudokuBoard.
+* Two formats are accepted, and may be mixed within the same stream:
+    (1). The format of the example files: a line holding the width and height of the boxes, followed by the values of
+         the grid's cells (0 for empty), separated by whitespace and spread over any number of lines.
+    (2). The one-line format: the grid's cells in row-major order on a single line, with no separators. Empty cells
+         are '.' or '0', the digits 1 to 9 are '1' to '9', and the digits from 10 upwards are 'A', 'B', ... (or
+         lowercase). The dimensions of the boxes are inferred from the length of the line (see GetBoxDimensions).
+* Blank lines, and lines beginning with '#', are skipped.
+* A file opened by Open may instead be a packed corpus (see PackedCorpus), whose puzzles are then loaded in order,
+  or only those of a slice of it (see SelectShard).
+* The input is scanned in place, one line at a time (see InputBuffer), by a hand-written scanner rather than by the
+  formatted extraction of iostreams; an error gives the line and column at which it was found.
+*/
+class PuzzleReader
+{
+
+private:
+
+    // The input that the puzzles are read from.
+    InputBuffer f_input;
+
+    // The line that's currently being parsed: its first character (from which columns are counted), and the bounds
+    // of its content once leading and trailing blanks are left out.
+    const char* f_line_start;
+    const char* f_line;
+    const char* f_line_end;
+
+    // The number of lines that have been read from f_input.
+    unsigned int f_num_lines;
+
+    // A description of the problem that stopped the last call to Read, or an empty string.
+    std::string f_error;
+
+    // The packed corpus opened by Open, if the file is one; and the numbers of the next puzzle to be loaded from it
+    // and of the puzzle at which to stop.
+    PackedCorpus f_corpus;
+    unsigned long long f_index_corpus;
+    unsigned long long f_end_corpus;
+
+
+public:
+
+    /*
+    * Creates a reader of nothing, to be opened with Open.
+    */
+    PuzzleReader();
+
+    /*
+    * Creates a reader of p_input, which is read in large blocks; so it may be read further than the last puzzle that
+      was read from it. If p_is_by_line is true, it's instead read one line at a time, so that nothing past the last
+      line of the last puzzle is taken from it (see InputBuffer).
+    */
+    PuzzleReader(std::istream& p_input, bool p_is_by_line = false);
+
+    /*
+    * Reads the puzzles of the file p_file from now on, mapping it into memory if possible (see InputBuffer); a packed
+      corpus is recognised by its first bytes.
+    * Returns false if the file can't be opened, or is a malformed packed corpus (in which case GetError describes the
+      problem).
+    */
+    bool Open(const char* p_file);
+
+    /*
+    * Restricts the puzzles that are read from the packed corpus opened by Open to the p_index-th of p_num_shards
+      slices of it (counting from 0), which are as equal in size as possible; the slice is found without reading the
+      puzzles before it. E.g. shard 1 of 4 of a corpus of 10 puzzles is puzzles #2 to #4
+      (counting from 0).
+    * Returns false if no packed corpus is open, or p_index isn't less than p_num_shards.
+    */
+    bool SelectShard(unsigned int p_index, unsigned int p_num_shards);
+
+    /*
+    * Reads the next puzzle into p_board, resizing it if necessary.
+    * Returns false if there are no more puzzles or if the input is malformed; in the latter case GetError returns a
+      description of the problem.
+    */
+    bool Read(SudokuBoard& p_board);
+
+    /*
+    * Parses the line [p_begin, p_end) (without its '\n') as a puzzle of the one-line format into p_board, counting it
+      as the next line of the input (for the line numbers of GetError); e.g. for lines received one at a time.
+    * Returns false if the line holds no puzzle (it's blank or a comment) or isn't a well-formed puzzle; in the latter
+      case GetError describes the problem.
+    */
+    bool ReadLine(const char* p_begin, const char* p_end, SudokuBoard& p_board);
+
+    /*
+    * Returns a description of the problem that stopped the last call to Read, or an empty string if it stopped
+      because the end of the input was reached. The description starts with the line number and, where the problem
+      is at a character, its column (e.g. "line 3, column 17: value out of range"); for a packed corpus, it starts
+      with the number of the puzzle instead.
+    */
+    const std::string& GetError() const;
+
+    /*
+    * Assigns to p_width_box and p_height_box the dimensions of the boxes of a grid of p_size_grid by p_size_grid
+      cells, as assumed by the one-line format: the narrowest box that's at least as wide as it is tall (e.g. 3x2 for
+      a 6x6 grid, 4x3 for a 12x12 grid). Returns false if there's no such box of at least two rows.
+    */
+    static bool GetBoxDimensions(unsigned int p_size_grid, unsigned int& p_width_box, unsigned int& p_height_box);
+
+    /*
+    * Returns the character that represents p_value in the one-line format.
+    */
+    static char ToChar(unsigned int p_value);
+
+
+private:
+
+    /* Auxiliary of Read
+    * Reads lines into f_line until one that isn't blank or a comment is found; returns false at the end of the input.
+    */
+    bool ReadContentLine();
+
+    /* Auxiliary of Read, ReadDimensionsFormat
+    * Scans the whole number at p_text (up to f_line_end) into p_value, leaving p_text after its last digit; values
+      too large for an unsigned int are clamped. Returns false if there's no digit at p_text.
+    */
+    bool ScanNumber(const char*& p_text, unsigned int& p_value) const;
+
+    /* Auxiliary of Read, ReadLine, ReadContentLine, ReadDimensionsFormat
+    * Returns whether or not p_char is a blank: a space, a tab, or the '\r' of a Windows line ending.
+    */
+    static bool IsBlank(char p_char);
+
+    /* Auxiliary of Read, ReadLine
+    * Parse f_line as the first line of a puzzle of format (1) or (2) respectively.
+    */
+    bool ReadDimensionsFormat(SudokuBoard& p_board, unsigned int p_width_box, unsigned int p_height_box);
+    bool ReadOneLineFormat(SudokuBoard& p_board);
+
+    /* Auxiliary of Read
+    * Loads the next puzzle of the packed corpus into p_board; returns false at the end of the corpus (or of its
+      shard), or if the puzzle is malformed.
+    */
+    bool ReadPacked(SudokuBoard& p_board);
+
+    /* Auxiliary of Read, ReadLine, ReadDimensionsFormat, ReadOneLineFormat
+    * Sets f_error to p_message, prefixed by the current line number and, unless p_position is nullptr, the column of
+      p_position in the current line; returns false.
+    */
+    bool Fail(const char* p_message, const char* p_position);
+
+};
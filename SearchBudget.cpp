@@ -0,0 +1,122 @@
+#include"SearchBudget.h"
+
+#include<algorithm>
+
+
+SearchBudget::SearchBudget()
+    : f_seconds_limit(0.0), f_max_nodes(0), f_cancel(nullptr), f_num_nodes(0),
+      f_limit_reached(static_cast<int>(Limit::None))
+{
+}
+
+void SearchBudget::SetTimeLimit(double p_seconds)
+{
+    f_seconds_limit = std::max(p_seconds, 0.0);
+}
+
+void SearchBudget::SetMaxNodes(unsigned long long p_max_nodes)
+{
+    f_max_nodes = p_max_nodes;
+}
+
+void SearchBudget::SetCancelFlag(const std::atomic<bool>* p_cancel)
+{
+    f_cancel = p_cancel;
+}
+
+void SearchBudget::CopyLimits(const SearchBudget& p_other)
+{
+    f_seconds_limit = p_other.f_seconds_limit;
+    f_max_nodes = p_other.f_max_nodes;
+    f_cancel = p_other.f_cancel;
+}
+
+bool SearchBudget::IsLimited() const
+{
+    return f_seconds_limit > 0.0 || f_max_nodes != 0 || f_cancel != nullptr;
+}
+
+void SearchBudget::Start()
+{
+    f_num_nodes = 0;
+    f_limit_reached = static_cast<int>(Limit::None);
+
+    if (f_seconds_limit > 0.0)
+    {
+        f_deadline = std::chrono::steady_clock::now() +
+                     std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(f_seconds_limit));
+    }
+
+}
+
+void SearchBudget::Cancel()
+{
+    Stop(Limit::Cancelled);
+}
+
+SearchBudget::Limit SearchBudget::GetLimitReached() const
+{
+    return static_cast<Limit>(f_limit_reached.load(std::memory_order_relaxed));
+}
+
+unsigned long long SearchBudget::GetNumNodes() const
+{
+    return f_num_nodes.load(std::memory_order_relaxed);
+}
+
+
+/* Auxiliary of Meter::Refill
+
+* Notes:
+    (a). Once any thread has reached a limit, the others give up at their next check.
+    (b). The clock is only read once per batch, which is what makes the time limit cheap.
+*/
+bool SearchBudget::Spend(unsigned long long p_num_nodes, unsigned long long& p_size_batch)
+{
+    unsigned long long l_num_nodes = f_num_nodes.fetch_add(p_num_nodes, std::memory_order_relaxed) + p_num_nodes;
+
+    // (a).
+    if (GetLimitReached() != Limit::None)
+    { return false; }
+
+    if (f_max_nodes != 0 && l_num_nodes > f_max_nodes)
+    { return Stop(Limit::Nodes); }
+
+    if (f_cancel != nullptr && f_cancel->load(std::memory_order_relaxed))
+    { return Stop(Limit::Cancelled); }
+
+    // (b).
+    if (f_seconds_limit > 0.0 && std::chrono::steady_clock::now() >= f_deadline)
+    { return Stop(Limit::Time); }
+
+    p_size_batch = GetSizeBatch(l_num_nodes);
+
+    return true;
+}
+
+/* Auxiliary of Meter::Start, Spend
+
+* Notes:
+    (a). The node limit is only checked at the end of a batch, so the batch ends at the first node beyond it; as
+         Spend has just checked that p_num_nodes is within the limit, the batch has at least one node.
+*/
+unsigned long long SearchBudget::GetSizeBatch(unsigned long long p_num_nodes) const
+{
+    // (a).
+    if (f_max_nodes != 0)
+    { return std::min<unsigned long long>(S_NODES_PER_CHECK, f_max_nodes + 1 - p_num_nodes); }
+
+    return S_NODES_PER_CHECK;
+}
+
+/* Auxiliary of Spend, Cancel
+*/
+bool SearchBudget::Stop(Limit p_limit)
+{
+    int l_expected = static_cast<int>(Limit::None);
+
+    f_limit_reached.compare_exchange_strong(l_expected, static_cast<int>(p_limit));
+
+    return false;
+}
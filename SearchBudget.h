@@ -0,0 +1,201 @@
+#pragma once
+
+#include<atomic>
+#include<chrono>
+
+
+/*
+* The limits of a search: a wall-clock time limit, a greatest number of nodes, and a flag by which another thread
+  can cancel it (see SudokuBoard::GetBudget). A search that reaches any of them gives up, and the budget records
+  which one it reached.
+* The engines count their nodes with a Meter, which only consults the budget once per batch of nodes (at most
+  S_NODES_PER_CHECK), so that the limits cost a decrement per node. The node limit is exact for a search on one
+  thread; the time limit and the flag are noticed within a batch.
+* A budget can be shared by the threads of one search (see ParallelSolver), whose nodes then count towards the same
+  limit; each thread has its own Meter.
+*/
+class SearchBudget
+{
+
+public:
+
+    // The limit that stopped a search.
+    enum class Limit
+    {
+        None,
+        Time,
+        Nodes,
+        Cancelled
+    };
+
+    /*
+    * The counter through which an engine spends the nodes of its search. It's copied along with the engine, e.g. to
+      the threads of a parallel search.
+    */
+    class Meter
+    {
+
+    private:
+
+        // The budget, or nullptr if the search is unlimited.
+        SearchBudget* f_budget;
+
+        // The size of the current batch of nodes, and the number of them that are left.
+        unsigned long long f_size_batch;
+        unsigned long long f_num_left;
+
+
+    public:
+
+        Meter()
+            : f_budget(nullptr), f_size_batch(0), f_num_left(0)
+        {
+        }
+
+        /*
+        * Starts spending p_budget (nullptr for none), which must have been started (see SearchBudget::Start).
+        */
+        void Start(SearchBudget* p_budget)
+        {
+            f_budget = p_budget;
+            f_size_batch = f_num_left = p_budget != nullptr ? p_budget->GetSizeBatch(0) : 0;
+        }
+
+        /*
+        * Counts a node of the search. Returns false if the budget has run out, in which case the search must give up
+          (and every later call also returns false).
+        */
+        bool Tick()
+        {
+            return f_budget == nullptr || --f_num_left != 0 || Refill();
+        }
+
+        /*
+        * Returns whether or not Tick has returned false; for searches that give up by unwinding their recursion.
+        */
+        bool IsExhausted() const
+        {
+            return f_budget != nullptr && f_size_batch == 0;
+        }
+
+
+    private:
+
+        /* Auxiliary of Tick
+        * Spends the batch that has been used up, and starts the next one if the budget allows; otherwise the batch
+          is left empty, so that every later Tick comes back here (and fails again).
+        */
+        bool Refill()
+        {
+            if (!f_budget->Spend(f_size_batch, f_size_batch))
+            {
+                f_size_batch = 0;
+                f_num_left = 1;
+                return false;
+            }
+
+            f_num_left = f_size_batch;
+
+            return true;
+        }
+
+    };
+
+
+private:
+
+    // The time limit in seconds (0 for none), and the time at which the current search reaches it.
+    double f_seconds_limit;
+    std::chrono::steady_clock::time_point f_deadline;
+
+    // The greatest number of nodes (0 for no limit).
+    unsigned long long f_max_nodes;
+
+    // The flag which, once set, cancels the search; or nullptr.
+    const std::atomic<bool>* f_cancel;
+
+    // The number of nodes spent by the current search, and the limit that it reached (a Limit).
+    std::atomic<unsigned long long> f_num_nodes;
+    std::atomic<int> f_limit_reached;
+
+
+    // The greatest number of nodes between two checks of the limits.
+    static const unsigned int S_NODES_PER_CHECK = 64;
+
+
+public:
+
+    SearchBudget();
+
+    SearchBudget(const SearchBudget&) = delete;
+    SearchBudget& operator=(const SearchBudget&) = delete;
+
+    /*
+    * Sets the time that each search may take, in seconds (0, the default, for no limit).
+    */
+    void SetTimeLimit(double p_seconds);
+
+    /*
+    * Sets the number of nodes that each search may visit (0, the default, for no limit).
+    */
+    void SetMaxNodes(unsigned long long p_max_nodes);
+
+    /*
+    * Sets the flag which, once set (e.g. by another thread), cancels the search (nullptr, the default, for none). The
+      flag isn't cleared by the budget.
+    */
+    void SetCancelFlag(const std::atomic<bool>* p_cancel);
+
+    /*
+    * Copies the limits (but not the state of the search) of p_other.
+    */
+    void CopyLimits(const SearchBudget& p_other);
+
+    /*
+    * Returns whether or not any limit is set; a search without limits needn't be metered at all.
+    */
+    bool IsLimited() const;
+
+    /*
+    * Starts a search: clears its count of nodes and the limit reached, and starts its time.
+    */
+    void Start();
+
+    /*
+    * Stops the current search (e.g. from another thread) as its cancel flag would: it gives up at its next check of
+      the budget, which records Limit::Cancelled, unless it has already reached another limit.
+    */
+    void Cancel();
+
+    /*
+    * Returns the limit that stopped the current (or last) search, or Limit::None if it wasn't stopped.
+    */
+    Limit GetLimitReached() const;
+
+    /*
+    * Returns the number of nodes spent by the current (or last) search, as counted in batches; a search on one thread
+      may have visited up to S_NODES_PER_CHECK more.
+    */
+    unsigned long long GetNumNodes() const;
+
+
+private:
+
+    /* Auxiliary of Meter::Refill
+    * Adds p_num_nodes to the nodes spent and checks the limits. Returns false if one has been reached (by this or
+      another thread); otherwise assigns the size of the next batch to p_size_batch.
+    */
+    bool Spend(unsigned long long p_num_nodes, unsigned long long& p_size_batch);
+
+    /* Auxiliary of Meter::Start, Spend
+    * Returns the size of the batch that follows p_num_nodes spent nodes: S_NODES_PER_CHECK, or fewer, so that the
+      batch ends at the node that exceeds the node limit.
+    */
+    unsigned long long GetSizeBatch(unsigned long long p_num_nodes) const;
+
+    /* Auxiliary of Spend, Cancel
+    * Records p_limit as the limit reached, unless another was reached first; returns false.
+    */
+    bool Stop(Limit p_limit);
+
+};
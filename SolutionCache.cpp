@@ -0,0 +1,257 @@
+#include"SolutionCache.h"
+
+#include<chrono>
+#include<cstring>
+#include<fstream>
+
+
+const char SolutionCache::S_MAGIC[8] = { 'S', 'U', 'D', 'O', 'C', 'A', 'C', '1' };
+
+
+std::size_t SolutionCache::HashKey::operator()(const std::string& p_key) const
+{
+    return static_cast<std::size_t>(CanonicalForm::Hash(p_key));
+}
+
+SolutionCache::SolutionCache(std::size_t p_capacity)
+    : f_capacity(p_capacity), f_counters{ 0, 0, 0, 0.0, 0.0 }
+{
+}
+
+/*
+* Notes:
+    (a). The cache is only locked to look up and insert entries; computing the form, searching and transforming the
+         solution are done outside of the lock, so that the threads sharing the cache don't wait on each other.
+    (b). The board's statistics would otherwise be those of its previous search.
+    (c). A search stopped by the budget says nothing about the puzzle.
+*/
+SudokuBoard::Result SolutionCache::Solve(SudokuBoard& p_board, CanonicalForm& p_form)
+{
+    std::chrono::steady_clock::time_point l_start = std::chrono::steady_clock::now();
+
+    bool l_has_form = p_form.Compute(p_board);
+
+    double l_seconds_canonical = std::chrono::duration<double>(std::chrono::steady_clock::now() - l_start).count();
+
+    Entry l_entry;
+    bool l_is_hit = false;
+
+    // (a).
+    {
+        std::lock_guard<std::mutex> l_lock(f_mutex);
+
+        f_counters.seconds_canonical += l_seconds_canonical;
+
+        if (!l_has_form)
+        { ++f_counters.num_skipped; }
+        else
+        {
+            ++f_counters.num_lookups;
+            l_is_hit = Find(p_form.GetKey(), l_entry);
+
+            if (l_is_hit)
+            {
+                ++f_counters.num_hits;
+                f_counters.seconds_saved += l_entry.seconds;
+            }
+        }
+
+    }
+
+    if (!l_has_form)
+    { return p_board.TrySolve(); }
+
+    if (l_is_hit)
+    {
+        // (b).
+        p_board.GetStats().ClearSearch();
+
+        if (l_entry.solution.empty())
+        { return SudokuBoard::Result::Unsolvable; }
+
+        SudokuBoard::Snapshot l_snapshot;
+        p_board.TakeSnapshot(l_snapshot);
+
+        p_form.FromCanonical(l_entry.solution, l_snapshot.grid);
+        p_board.RestoreSnapshot(l_snapshot);
+
+        return SudokuBoard::Result::Solved;
+    }
+
+    l_start = std::chrono::steady_clock::now();
+
+    SudokuBoard::Result l_result = p_board.TrySolve();
+
+    // (c).
+    if (l_result == SudokuBoard::Result::OutOfBudget)
+    { return l_result; }
+
+    l_entry.key = p_form.GetKey();
+    l_entry.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - l_start).count();
+
+    if (l_result == SudokuBoard::Result::Solved)
+    { p_form.ToCanonical(p_board.GetGrid(), l_entry.solution); }
+
+    // (a).
+    {
+        std::lock_guard<std::mutex> l_lock(f_mutex);
+        Insert(std::move(l_entry));
+    }
+
+    return l_result;
+}
+
+SolutionCache::Counters SolutionCache::GetCounters() const
+{
+    std::lock_guard<std::mutex> l_lock(f_mutex);
+
+    return f_counters;
+}
+
+std::size_t SolutionCache::GetSize() const
+{
+    std::lock_guard<std::mutex> l_lock(f_mutex);
+
+    return f_entries.size();
+}
+
+/*
+* Notes:
+    (a). Each entry is its key (the dimensions of the boxes and the canonical cells), a byte that's 1 if it has a
+         solution, the canonical cells of the solution (if it has one), and the time taken to solve it (a double).
+    (b). Every cell must be a digit of the grid (or empty, for the cells of the key).
+*/
+bool SolutionCache::Load(const char* p_file)
+{
+    std::ifstream l_file(p_file, std::ios::binary);
+
+    if (!l_file.is_open())
+    { return false; }
+
+    char l_magic[sizeof(S_MAGIC)];
+
+    if (!l_file.read(l_magic, sizeof(l_magic)) || std::memcmp(l_magic, S_MAGIC, sizeof(S_MAGIC)) != 0)
+    { return false; }
+
+    std::lock_guard<std::mutex> l_lock(f_mutex);
+
+    while (l_file.peek() != std::char_traits<char>::eof())
+    {
+        // (a).
+        Entry l_entry;
+        char l_dimensions[2];
+        char l_has_solution;
+
+        if (!l_file.read(l_dimensions, 2))
+        { return false; }
+
+        unsigned int l_size_grid = static_cast<unsigned char>(l_dimensions[0]) *
+                                   static_cast<unsigned char>(l_dimensions[1]);
+
+        if (l_size_grid == 0 || l_size_grid > CompactGrid::S_MAX_VALUE)
+        { return false; }
+
+        l_entry.key.assign(l_dimensions, 2);
+        l_entry.key.resize(2 + l_size_grid * l_size_grid);
+
+        if (!l_file.read(&l_entry.key[2], l_size_grid * l_size_grid) || !l_file.get(l_has_solution))
+        { return false; }
+
+        if (l_has_solution != 0)
+        {
+            l_entry.solution.resize(l_size_grid * l_size_grid);
+
+            if (!l_file.read(&l_entry.solution[0], l_entry.solution.size()))
+            { return false; }
+        }
+
+        if (!l_file.read(reinterpret_cast<char*>(&l_entry.seconds), sizeof(l_entry.seconds)))
+        { return false; }
+
+        // (b).
+        for (std::size_t i = 2; i < l_entry.key.size(); ++i)
+        {
+            if (static_cast<unsigned char>(l_entry.key[i]) > l_size_grid)
+            { return false; }
+        }
+
+        for (char l_cell : l_entry.solution)
+        {
+            if (l_cell == 0 || static_cast<unsigned char>(l_cell) > l_size_grid)
+            { return false; }
+        }
+
+        Insert(std::move(l_entry));
+    }
+
+    return true;
+}
+
+/*
+* Notes:
+    (a). The entries are written from the least to the most recently used, so that loading them restores their order.
+*/
+bool SolutionCache::Save(const char* p_file) const
+{
+    std::ofstream l_file(p_file, std::ios::binary | std::ios::trunc);
+
+    if (!l_file.is_open())
+    { return false; }
+
+    l_file.write(S_MAGIC, sizeof(S_MAGIC));
+
+    std::lock_guard<std::mutex> l_lock(f_mutex);
+
+    // (a).
+    for (auto l_entry = f_entries.rbegin(); l_entry != f_entries.rend(); ++l_entry)
+    {
+        l_file.write(l_entry->key.data(), l_entry->key.size());
+        l_file.put(l_entry->solution.empty() ? 0 : 1);
+        l_file.write(l_entry->solution.data(), l_entry->solution.size());
+        l_file.write(reinterpret_cast<const char*>(&l_entry->seconds), sizeof(l_entry->seconds));
+    }
+
+    l_file.close();
+
+    return !l_file.fail();
+}
+
+
+/* Auxiliary of Solve
+*/
+bool SolutionCache::Find(const std::string& p_key, Entry& p_entry)
+{
+    auto l_found = f_index.find(p_key);
+
+    if (l_found == f_index.end())
+    { return false; }
+
+    f_entries.splice(f_entries.begin(), f_entries, l_found->second);
+    p_entry = *l_found->second;
+
+    return true;
+}
+
+/* Auxiliary of Solve, Load
+*/
+void SolutionCache::Insert(Entry&& p_entry)
+{
+    if (f_capacity == 0)
+    { return; }
+
+    auto l_found = f_index.find(p_entry.key);
+
+    if (l_found != f_index.end())
+    {
+        f_entries.erase(l_found->second);
+        f_index.erase(l_found);
+    }
+    else if (f_entries.size() == f_capacity)
+    {
+        f_index.erase(f_entries.back().key);
+        f_entries.pop_back();
+    }
+
+    f_entries.push_front(std::move(p_entry));
+    f_index.emplace(f_entries.front().key, f_entries.begin());
+}
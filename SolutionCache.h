@@ -0,0 +1,124 @@
+#pragma once
+
+#include<list>
+#include<mutex>
+#include<string>
+#include<unordered_map>
+
+#include"CanonicalForm.h"
+#include"SudokuBoard.h"
+
+
+/*
+* A bounded cache of the results of solving puzzles, keyed by their canonical forms (see CanonicalForm), so that a
+  puzzle equivalent to one that has already been solved is answered by transforming the cached solution rather than
+  by searching again. Puzzles without a solution (including invalid ones) are cached as such; puzzles whose search
+  ran out of budget aren't cached, as the next search may have more.
+* Once the cache holds its capacity of entries, the least recently used entry is evicted to make room for a new one.
+* The entries can be saved to a file and loaded from it, so that the cache persists from one run to the next.
+* The cache can be shared by several threads; each needs its own CanonicalForm.
+*/
+class SolutionCache
+{
+
+public:
+
+    // The counters of the cache's use since it was created.
+    struct Counters
+    {
+        // The number of puzzles solved through the cache, and the number of those answered from it.
+        unsigned long long num_lookups;
+        unsigned long long num_hits;
+
+        // The number of puzzles that had no canonical form (see CanonicalForm::S_MAX_CANDIDATES), and so were
+        // solved without the cache.
+        unsigned long long num_skipped;
+
+        // The time spent computing canonical forms, and the time that the hits would have spent searching (as
+        // measured when their entries were solved), in seconds.
+        double seconds_canonical;
+        double seconds_saved;
+    };
+
+
+private:
+
+    // An entry: the canonical form of a puzzle, the canonical cells of its solution (empty if it has none), and the
+    // time taken to solve it, in seconds.
+    struct Entry
+    {
+        std::string key;
+        std::string solution;
+        double seconds;
+    };
+
+    // Hashes a canonical form with CanonicalForm::Hash.
+    struct HashKey
+    {
+        std::size_t operator()(const std::string& p_key) const;
+    };
+
+    // The greatest number of entries.
+    std::size_t f_capacity;
+
+    // The entries, from the most to the least recently used, and the entry of each canonical form.
+    std::list<Entry> f_entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator, HashKey> f_index;
+
+    Counters f_counters;
+
+    // Guards the above.
+    mutable std::mutex f_mutex;
+
+
+    // The first bytes of a file written by Save.
+    static const char S_MAGIC[8];
+
+
+public:
+
+    SolutionCache(std::size_t p_capacity);
+
+    SolutionCache(const SolutionCache&) = delete;
+    SolutionCache& operator=(const SolutionCache&) = delete;
+
+    /*
+    * Solves p_board as SudokuBoard::TrySolve would, using p_form to compute its canonical form: if an equivalent
+      puzzle is cached, the board is given its transformed solution (or left unchanged, if it has none) without
+      searching, and the statistics of its search are cleared; otherwise the board is solved and the result cached,
+      unless the search was stopped by the board's budget.
+    */
+    SudokuBoard::Result Solve(SudokuBoard& p_board, CanonicalForm& p_form);
+
+    Counters GetCounters() const;
+
+    std::size_t GetSize() const;
+
+    /*
+    * Adds the entries of the file p_file (written by Save) to the cache, as if they were its most recently used.
+      Returns false if the file can't be opened or is malformed (in which case the entries before the malformed one
+      are still added).
+    */
+    bool Load(const char* p_file);
+
+    /*
+    * Writes the entries to the file p_file. Returns false if it can't be written.
+    */
+    bool Save(const char* p_file) const;
+
+
+private:
+
+    /* Auxiliary of Solve
+    * Assigns a copy of the entry of p_key to p_entry and makes it the most recently used. Returns false if there's
+      none. f_mutex must be held.
+    */
+    bool Find(const std::string& p_key, Entry& p_entry);
+
+    /* Auxiliary of Solve, Load
+    * Adds (or replaces) the entry of p_entry.key as the most recently used, evicting the least recently used entry if
+      the cache is full. f_mutex must be held.
+    */
+    void Insert(Entry&& p_entry);
+
+};
@@ -0,0 +1,635 @@
+#include"SolverService.h"
+
+#include<cstring>
+#include<sstream>
+
+#include"BoardWriter.h"
+#include"PuzzleReader.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SOLVER_SERVICE_SOCKETS
+#endif
+
+#ifdef SOLVER_SERVICE_SOCKETS
+#include<cerrno>
+#include<sys/socket.h>
+#include<sys/un.h>
+#include<unistd.h>
+#endif
+
+
+const unsigned int SolverService::S_SIZES_WARM[][2] = { { 3, 3 }, { 4, 4 }, { 5, 5 } };
+
+
+/*
+* Notes:
+    (a). The workers take the requests first in, first out (rather than from a WorkStealingPool, whose workers take
+         their newest task first), so that no request waits behind the ones read after it.
+*/
+SolverService::SolverService(const SudokuBoard& p_settings, unsigned int p_num_threads)
+    : f_cache(nullptr), f_is_stopping(false), f_is_shutting_down(false)
+{
+    f_settings.CopySettings(p_settings);
+
+    if (p_num_threads == 0)
+    { p_num_threads = std::thread::hardware_concurrency(); }
+
+    if (p_num_threads == 0)
+    { p_num_threads = 1; }
+
+    f_boards.resize(p_num_threads);
+    f_forms.resize(p_num_threads);
+
+    for (unsigned int i = 0; i < p_num_threads; ++i)
+    {
+        for (const auto& l_size : S_SIZES_WARM)
+        {
+            GetBoard(i, l_size[0], l_size[1]);
+        }
+
+    }
+
+    // (a).
+    for (unsigned int i = 0; i < p_num_threads; ++i)
+    {
+        f_workers.emplace_back(&SolverService::RunWorker, this, i);
+    }
+
+}
+
+SolverService::~SolverService()
+{
+    {
+        std::lock_guard<std::mutex> l_lock(f_mutex_requests);
+        f_is_stopping = true;
+    }
+
+    f_cv_requests.notify_all();
+
+    for (std::thread& l_worker : f_workers)
+    {
+        l_worker.join();
+    }
+
+}
+
+void SolverService::SetCache(SolutionCache* p_cache)
+{
+    f_cache = p_cache;
+}
+
+void SolverService::Serve(std::istream& p_input, std::ostream& p_output)
+{
+    Connection l_connection;
+
+    l_connection.write = [&p_output](const std::string& p_text)
+    {
+        p_output.write(p_text.data(), p_text.size());
+        p_output.flush();
+    };
+
+    ServeConnection(l_connection, [&p_input](std::string& p_line)
+    { return static_cast<bool>(std::getline(p_input, p_line)); });
+}
+
+#ifdef SOLVER_SERVICE_SOCKETS
+
+/*
+* Notes:
+    (a). A file left at the path (e.g. by a service that was killed) would make bind fail.
+    (b). StopAccepting connects to the socket to wake accept up; that connection is closed without being served.
+    (c). The clients are served on threads of their own, which are joined before returning, so that the socket isn't
+         closed (nor the service destroyed) under them. Those that have ended are joined as connections arrive, so
+         that a long-running server doesn't accumulate them.
+*/
+bool SolverService::ServeSocket(const char* p_path, std::string& p_error)
+{
+    sockaddr_un l_address;
+    std::memset(&l_address, 0, sizeof(l_address));
+    l_address.sun_family = AF_UNIX;
+
+    if (std::strlen(p_path) >= sizeof(l_address.sun_path))
+    {
+        p_error = "the path is too long for a socket";
+        return false;
+    }
+
+    std::strcpy(l_address.sun_path, p_path);
+
+    int l_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (l_socket < 0)
+    {
+        p_error = std::strerror(errno);
+        return false;
+    }
+
+    // (a).
+    ::unlink(p_path);
+
+    if (::bind(l_socket, reinterpret_cast<const sockaddr*>(&l_address), sizeof(l_address)) != 0 ||
+        ::listen(l_socket, SOMAXCONN) != 0)
+    {
+        p_error = std::strerror(errno);
+        ::close(l_socket);
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> l_lock(f_mutex_clients);
+        f_path = p_path;
+        f_is_shutting_down = false;
+    }
+
+    p_error.clear();
+
+    while (true)
+    {
+        int l_client = ::accept(l_socket, nullptr, nullptr);
+
+        if (l_client < 0 && (errno == EINTR || errno == ECONNABORTED))
+        { continue; }
+
+        if (l_client < 0)
+        {
+            p_error = std::strerror(errno);
+            break;
+        }
+
+        // (b).
+        if (f_is_shutting_down)
+        {
+            ::close(l_client);
+            break;
+        }
+
+        // (c).
+        JoinClients(false);
+        f_clients.emplace_back(&SolverService::ServeClient, this, l_client);
+    }
+
+    {
+        std::lock_guard<std::mutex> l_lock(f_mutex_clients);
+        f_path.clear();
+    }
+
+    // (c).
+    JoinClients(true);
+
+    ::close(l_socket);
+    ::unlink(p_path);
+
+    return p_error.empty();
+}
+
+#else
+
+bool SolverService::ServeSocket(const char* p_path, std::string& p_error)
+{
+    p_error = "this platform doesn't have Unix domain sockets";
+    return false;
+}
+
+#endif
+
+void SolverService::WriteLatencies(std::ostream& p_output) const
+{
+    std::lock_guard<std::mutex> l_lock(f_mutex_latencies);
+
+    p_output << "requests=" << f_latencies.GetCount() << " mean_us=" << f_latencies.GetMean()
+             << " p50_us=" << f_latencies.GetPercentile(0.5) << " p90_us=" << f_latencies.GetPercentile(0.9)
+             << " p99_us=" << f_latencies.GetPercentile(0.99) << " p999_us=" << f_latencies.GetPercentile(0.999)
+             << " max_us=" << f_latencies.GetMax();
+}
+
+
+/* Auxiliary of Serve, ServeSocket
+* Notes:
+    (a). Every line is given to the reader, so that the line numbers of its errors count all the lines of the
+         connection; the commands are recognised once it has failed, since none of them is a well-formed puzzle.
+    (b). Only the puzzle's cells are handed to the workers; l_board is reused from request to request.
+    (c). The answers to malformed lines and commands are numbered like those to puzzles, so that they're written in
+         the order of the requests.
+    (d). The statistics are read once the requests before the command have been answered, so that they count them.
+    (e). The requests are only limited by the answers that are still to be written, so that a client that stops
+         reading stops having its requests read, rather than having its answers pile up.
+*/
+void SolverService::ServeConnection(Connection& p_connection, const std::function<bool(std::string&)>& p_read_line)
+{
+    std::thread l_writer(&SolverService::WriteAnswers, this, std::ref(p_connection));
+
+    PuzzleReader l_reader;
+    SudokuBoard l_board;
+    std::string l_line;
+
+    while (p_read_line(l_line))
+    {
+        std::chrono::steady_clock::time_point l_start = std::chrono::steady_clock::now();
+
+        // (a).
+        bool l_is_puzzle = l_reader.ReadLine(l_line.data(), l_line.data() + l_line.size(), l_board);
+
+        if (!l_is_puzzle && l_reader.GetError().empty())
+        { continue; }
+
+        std::size_t l_begin = l_line.find_first_not_of(" \t\r");
+        std::size_t l_length = l_line.find_last_not_of(" \t\r") + 1 - l_begin;
+
+        bool l_is_quit = !l_is_puzzle && l_line.compare(l_begin, l_length, "quit") == 0;
+        bool l_is_shutdown = !l_is_puzzle && l_line.compare(l_begin, l_length, "shutdown") == 0;
+
+        if (l_is_quit || l_is_shutdown)
+        {
+            if (l_is_shutdown)
+            { StopAccepting(); }
+
+            break;
+        }
+
+        unsigned long long l_id;
+
+        // (e).
+        {
+            std::unique_lock<std::mutex> l_lock(p_connection.mutex);
+
+            p_connection.cv_answered.wait(l_lock, [&p_connection]()
+            { return p_connection.num_requests - p_connection.num_written < S_MAX_WAITING; });
+
+            l_id = p_connection.num_requests++;
+        }
+
+        if (l_is_puzzle)
+        {
+            // (b).
+            Request l_request{ &p_connection, l_id, SudokuBoard::Snapshot(), l_start };
+            l_board.TakeSnapshot(l_request.puzzle);
+
+            {
+                std::lock_guard<std::mutex> l_lock(f_mutex_requests);
+                f_requests.push_back(std::move(l_request));
+            }
+
+            f_cv_requests.notify_one();
+        }
+        else if (l_line.compare(l_begin, l_length, "stats") == 0)
+        {
+            // (d).
+            {
+                std::unique_lock<std::mutex> l_lock(p_connection.mutex);
+
+                p_connection.cv_answered.wait(l_lock, [&p_connection, l_id]()
+                { return p_connection.num_answered == l_id; });
+            }
+
+            // (c).
+            std::ostringstream l_stats;
+            l_stats << "stats ";
+            WriteLatencies(l_stats);
+            l_stats << '\n';
+
+            Answer(p_connection, l_id, l_stats.str());
+        }
+        else
+        {
+            // (c).
+            Answer(p_connection, l_id, "error " + l_reader.GetError() + '\n');
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> l_lock(p_connection.mutex);
+
+        p_connection.cv_answered.wait(l_lock, [&p_connection]()
+        { return p_connection.num_written == p_connection.num_requests; });
+
+        p_connection.is_ending = true;
+    }
+
+    p_connection.cv_text.notify_one();
+    l_writer.join();
+}
+
+/* Auxiliary of ServeConnection, RunWorker
+* Notes:
+    (a). The answers that are ready are added to those that the writer hasn't taken yet, so that it writes them
+         together and the client's stream is flushed once rather than after each of them.
+*/
+void SolverService::Answer(Connection& p_connection, unsigned long long p_id, std::string&& p_answer)
+{
+    std::lock_guard<std::mutex> l_lock(p_connection.mutex);
+
+    if (p_id != p_connection.num_answered)
+    {
+        p_connection.answers_waiting.emplace(p_id, std::move(p_answer));
+        return;
+    }
+
+    // (a).
+    p_connection.text += p_answer;
+    ++p_connection.num_answered;
+
+    for (auto l_next = p_connection.answers_waiting.begin();
+         l_next != p_connection.answers_waiting.end() && l_next->first == p_connection.num_answered;
+         l_next = p_connection.answers_waiting.erase(l_next))
+    {
+        p_connection.text += l_next->second;
+        ++p_connection.num_answered;
+    }
+
+    p_connection.cv_text.notify_one();
+    p_connection.cv_answered.notify_all();
+}
+
+/* Auxiliary of ServeConnection
+* Notes:
+    (a). The text is taken out of the connection and written without the lock, which a write to a client that isn't
+         reading can hold up indefinitely; meanwhile the workers go on queueing answers behind it.
+*/
+void SolverService::WriteAnswers(Connection& p_connection)
+{
+    std::string l_text;
+    std::unique_lock<std::mutex> l_lock(p_connection.mutex);
+
+    while (true)
+    {
+        p_connection.cv_text.wait(l_lock, [&p_connection]()
+        { return !p_connection.text.empty() || p_connection.is_ending; });
+
+        if (p_connection.text.empty())
+        { return; }
+
+        // (a).
+        l_text.swap(p_connection.text);
+        unsigned long long l_num_answered = p_connection.num_answered;
+
+        l_lock.unlock();
+        p_connection.write(l_text);
+        l_text.clear();
+        l_lock.lock();
+
+        p_connection.num_written = l_num_answered;
+        p_connection.cv_answered.notify_all();
+    }
+}
+
+/* Auxiliary of SolverService
+* Notes:
+    (a). TrySolve fails for both invalid and unsolvable puzzles; IsValid is only called to tell them apart once the
+         failure has happened (as in BatchSolver). A puzzle whose search ran out of budget is neither.
+    (b). The time of the answer includes the time that the request waited for a worker.
+*/
+void SolverService::RunWorker(unsigned int p_worker)
+{
+    Request l_request;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> l_lock(f_mutex_requests);
+
+            f_cv_requests.wait(l_lock, [this]() { return !f_requests.empty() || f_is_stopping; });
+
+            if (f_requests.empty())
+            { return; }
+
+            l_request = std::move(f_requests.front());
+            f_requests.pop_front();
+        }
+
+        SudokuBoard& l_board = GetBoard(p_worker, l_request.puzzle.width_box, l_request.puzzle.height_box);
+        l_board.RestoreSnapshot(l_request.puzzle);
+
+        std::chrono::steady_clock::time_point l_start_solve = std::chrono::steady_clock::now();
+
+        SudokuBoard::Result l_result =
+            f_cache != nullptr ? f_cache->Solve(l_board, f_forms[p_worker]) : l_board.TrySolve();
+
+        // (a).
+        const char* l_status = l_result == SudokuBoard::Result::Solved ? "solved" :
+                               l_result == SudokuBoard::Result::OutOfBudget ? "budget-exceeded" :
+                               l_board.IsValid() ? "unsolvable" : "invalid";
+
+        std::chrono::steady_clock::time_point l_end = std::chrono::steady_clock::now();
+
+        // (b).
+        unsigned long long l_solve_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(l_end - l_start_solve).count();
+        unsigned long long l_total_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(l_end - l_request.start).count();
+
+        {
+            std::lock_guard<std::mutex> l_lock(f_mutex_latencies);
+            f_latencies.Add(l_total_us);
+        }
+
+        std::string l_answer = l_status;
+        l_answer += ' ';
+        l_answer += std::to_string(l_solve_us);
+        l_answer += ' ';
+        l_answer += std::to_string(l_total_us);
+
+        if (l_result == SudokuBoard::Result::Solved)
+        {
+            l_answer += ' ';
+            BoardWriter::Render(l_answer, l_board, BoardWriter::Format::Compact);
+        }
+        else
+        { l_answer += '\n'; }
+
+        Answer(*l_request.connection, l_request.id, std::move(l_answer));
+    }
+}
+
+/* Auxiliary of SolverService, RunWorker
+* Notes:
+    (a). Solving a puzzle has the engines allocate their storage for the size of the grid (and Solve create the
+         specialisation for it, if there is one), so that the first request of that size doesn't pay for it. The
+         puzzle is a valid complete grid with its first row emptied, which propagation alone solves.
+*/
+SudokuBoard& SolverService::GetBoard(unsigned int p_worker, unsigned int p_width_box, unsigned int p_height_box)
+{
+    std::unique_ptr<SudokuBoard>& l_board = f_boards[p_worker][std::make_pair(p_width_box, p_height_box)];
+
+    if (l_board)
+    { return *l_board; }
+
+    l_board.reset(new SudokuBoard(p_width_box, p_height_box));
+    l_board->CopySettings(f_settings);
+
+    // (a).
+    unsigned int l_size_grid = p_width_box * p_height_box;
+
+    for (unsigned int row = 1; row < l_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < l_size_grid; ++col)
+        {
+            l_board->SetValue(row, col,
+                              ((row % p_height_box) * p_width_box + row / p_height_box + col) % l_size_grid + 1);
+        }
+
+    }
+
+    l_board->Solve();
+
+    return *l_board;
+}
+
+#ifdef SOLVER_SERVICE_SOCKETS
+
+/* Auxiliary of ServeSocket
+* Notes:
+    (a). A client that has gone away mustn't raise SIGPIPE, which would end the process; the write just fails.
+    (b). The lines are split out of the blocks read from the socket in place; the text that's been consumed is only
+         dropped before the next read.
+*/
+void SolverService::ServeClient(int p_socket)
+{
+    // (a).
+#ifdef MSG_NOSIGNAL
+    const int l_flags_send = MSG_NOSIGNAL;
+#else
+    const int l_flags_send = 0;
+#endif
+
+#ifdef SO_NOSIGPIPE
+    int l_option = 1;
+    ::setsockopt(p_socket, SOL_SOCKET, SO_NOSIGPIPE, &l_option, sizeof(l_option));
+#endif
+
+    Connection l_connection;
+
+    l_connection.write = [p_socket, l_flags_send](const std::string& p_text)
+    {
+        for (std::size_t l_sent = 0; l_sent < p_text.size();)
+        {
+            ssize_t l_size = ::send(p_socket, p_text.data() + l_sent, p_text.size() - l_sent, l_flags_send);
+
+            if (l_size < 0 && errno == EINTR)
+            { continue; }
+
+            if (l_size <= 0)
+            { return; }
+
+            l_sent += static_cast<std::size_t>(l_size);
+        }
+    };
+
+    // (b).
+    std::string l_input;
+    std::size_t l_position = 0;
+    char l_block[1 << 16];
+
+    ServeConnection(l_connection, [&](std::string& p_line)
+    {
+        while (true)
+        {
+            std::size_t l_newline = l_input.find('\n', l_position);
+
+            if (l_newline != std::string::npos)
+            {
+                p_line.assign(l_input, l_position, l_newline - l_position);
+                l_position = l_newline + 1;
+                return true;
+            }
+
+            l_input.erase(0, l_position);
+            l_position = 0;
+
+            ssize_t l_size = ::read(p_socket, l_block, sizeof(l_block));
+
+            if (l_size < 0 && errno == EINTR)
+            { continue; }
+
+            if (l_size <= 0)
+            {
+                // The last line may not end with '\n'.
+                p_line.swap(l_input);
+                l_input.clear();
+                return !p_line.empty();
+            }
+
+            l_input.append(l_block, static_cast<std::size_t>(l_size));
+        }
+    });
+
+    ::close(p_socket);
+
+    std::lock_guard<std::mutex> l_lock(f_mutex_clients);
+    f_clients_ended.push_back(std::this_thread::get_id());
+}
+
+void SolverService::JoinClients(bool p_is_all)
+{
+    if (p_is_all)
+    {
+        for (std::thread& l_client : f_clients)
+        { l_client.join(); }
+
+        f_clients.clear();
+    }
+
+    std::vector<std::thread::id> l_ended;
+
+    {
+        std::lock_guard<std::mutex> l_lock(f_mutex_clients);
+        l_ended.swap(f_clients_ended);
+    }
+
+    for (const std::thread::id& l_id : l_ended)
+    {
+        for (std::size_t i = 0; i < f_clients.size(); ++i)
+        {
+            if (f_clients[i].get_id() != l_id)
+            { continue; }
+
+            f_clients[i].join();
+            f_clients[i] = std::move(f_clients.back());
+            f_clients.pop_back();
+            break;
+        }
+
+    }
+
+}
+
+/* Auxiliary of ServeConnection
+*/
+void SolverService::StopAccepting()
+{
+    std::lock_guard<std::mutex> l_lock(f_mutex_clients);
+
+    if (f_path.empty() || f_is_shutting_down)
+    { return; }
+
+    f_is_shutting_down = true;
+
+    sockaddr_un l_address;
+    std::memset(&l_address, 0, sizeof(l_address));
+    l_address.sun_family = AF_UNIX;
+    std::strcpy(l_address.sun_path, f_path.c_str());
+
+    int l_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (l_socket >= 0)
+    {
+        ::connect(l_socket, reinterpret_cast<const sockaddr*>(&l_address), sizeof(l_address));
+        ::close(l_socket);
+    }
+
+}
+
+#else
+
+void SolverService::ServeClient(int p_socket)
+{
+}
+
+void SolverService::JoinClients(bool p_is_all)
+{
+}
+
+void SolverService::StopAccepting()
+{
+}
+
+#endif
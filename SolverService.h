@@ -0,0 +1,217 @@
+#pragma once
+
+#include<atomic>
+#include<chrono>
+#include<condition_variable>
+#include<deque>
+#include<functional>
+#include<iostream>
+#include<map>
+#include<memory>
+#include<mutex>
+#include<string>
+#include<thread>
+#include<utility>
+#include<vector>
+
+#include"CanonicalForm.h"
+#include"LatencyHistogram.h"
+#include"SolutionCache.h"
+#include"SudokuBoard.h"
+
+
+/*
+* A long-running solver that answers requests over a line protocol, either on a pair of streams (e.g. stdin and
+  stdout) or on the connections to a Unix domain socket (where the platform has them).
+* Each request is a line holding a puzzle in the one-line format (see PuzzleReader), and is answered by one line:
+    - "solved <solve_us> <total_us> <solution>", with the solution in the one-line format (or, for grids of more than
+      35 digits, its values separated by spaces; see BoardWriter);
+    - "unsolvable <solve_us> <total_us>", if the puzzle adheres to the rules of sudoku but cannot be solved;
+    - "invalid <solve_us> <total_us>", if the puzzle's pre-filled cells violate the rules of sudoku;
+    - "budget-exceeded <solve_us> <total_us>", if the search was stopped by the budget of the boards (see
+      SudokuBoard::GetBudget; the workers' boards copy the settings, budget included), e.g. by a time limit;
+    - "error <message>", if the line isn't a well-formed puzzle (the message gives its line and column).
+  <solve_us> is the time taken to solve the puzzle and <total_us> the time from the request being read to its answer
+  being ready, both in microseconds.
+* A few lines are commands rather than puzzles:
+    - "stats" is answered, once the requests before it have been, by "stats " followed by the number of puzzles
+      answered so far (by all connections) and the percentiles of their total times (see WriteLatencies);
+    - "quit" ends the connection (or the stream) once the requests before it have been answered;
+    - "shutdown" also stops the socket server from accepting connections, so that ServeSocket returns once the
+      connections that are open have ended.
+  Blank lines, and lines beginning with '#', are skipped without an answer.
+* Requests can be pipelined: a client can send any number of them without waiting, and they're solved in parallel,
+  but the answers are always written in the order of the requests of each connection.
+* The puzzles are solved by a fixed set of worker threads, each of which keeps a board per size of grid, so that its
+  engines' storage is allocated once and then reused (see SudokuBoard). The workers only queue their answers; each
+  connection has a thread of its own that writes them, so that a client that's slow to read holds up no worker. The
+  boards of the common sizes are created and warmed up when the service is created; those of other sizes on their
+  first request.
+*/
+class SolverService
+{
+
+private:
+
+    // The state of a connection (or of the pair of streams): the function that writes (and flushes) text to the
+    // client, which only its writer thread calls; the number of requests that have been read, answered and whose
+    // answers have been written; the answers that are waiting for those of earlier requests (by request number); the
+    // answers that are ready to be written, in order; and whether or not the writer should exit once they have been.
+    struct Connection
+    {
+        std::function<void(const std::string&)> write;
+
+        unsigned long long num_requests = 0;
+        unsigned long long num_answered = 0;
+        unsigned long long num_written = 0;
+        std::map<unsigned long long, std::string> answers_waiting;
+        std::string text;
+        bool is_ending = false;
+
+        // The condition variables are notified when answers are ready or written, and when text has been added to
+        // (or the connection is ending), respectively.
+        std::mutex mutex;
+        std::condition_variable cv_answered;
+        std::condition_variable cv_text;
+    };
+
+    // A request waiting to be solved: its connection and number, the puzzle, and the time it was read.
+    struct Request
+    {
+        Connection* connection;
+        unsigned long long id;
+        SudokuBoard::Snapshot puzzle;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // The board whose settings the workers' boards copy.
+    SudokuBoard f_settings;
+
+    // The cache that the puzzles are solved through, or nullptr if there's none.
+    SolutionCache* f_cache;
+
+    // The boards of each worker, by the dimensions of their boxes, and the canonical form of each worker (for the
+    // cache).
+    std::vector<std::map<std::pair<unsigned int, unsigned int>, std::unique_ptr<SudokuBoard>>> f_boards;
+    std::vector<CanonicalForm> f_forms;
+
+    // The requests waiting to be solved, first in first out, and whether or not the workers should exit.
+    std::deque<Request> f_requests;
+    bool f_is_stopping;
+    std::mutex f_mutex_requests;
+    std::condition_variable f_cv_requests;
+
+    // The total times of the puzzles answered, in microseconds.
+    LatencyHistogram f_latencies;
+    mutable std::mutex f_mutex_latencies;
+
+    // The path of ServeSocket's socket (empty if it isn't listening), whether or not a client has asked for it to
+    // stop, the threads that serve the connections (which only ServeSocket's thread touches), and the ids of those
+    // that have ended but not yet been joined.
+    std::string f_path;
+    std::atomic<bool> f_is_shutting_down;
+    std::vector<std::thread> f_clients;
+    std::vector<std::thread::id> f_clients_ended;
+    std::mutex f_mutex_clients;
+
+    std::vector<std::thread> f_workers;
+
+
+    // The dimensions of the boxes of the boards that each worker creates in advance.
+    static const unsigned int S_SIZES_WARM[][2];
+
+    // The greatest number of requests of a connection whose answers can be waiting to be written; beyond it, the
+    // connection's next request isn't read until an answer has been written.
+    static const unsigned int S_MAX_WAITING = 1024;
+
+
+public:
+
+    /*
+    * Creates the service with p_num_threads workers (0 for one per hardware thread), whose boards copy the settings
+      of p_settings (see SudokuBoard::CopySettings).
+    */
+    SolverService(const SudokuBoard& p_settings, unsigned int p_num_threads);
+
+    /*
+    * Waits for the workers to finish the requests that have been read, and joins them.
+    */
+    ~SolverService();
+
+    SolverService(const SolverService&) = delete;
+    SolverService& operator=(const SolverService&) = delete;
+
+    /*
+    * Sets the cache that the puzzles are solved through (nullptr, the default, for none); it's shared by the workers.
+    */
+    void SetCache(SolutionCache* p_cache);
+
+    /*
+    * Answers the requests read from p_input on p_output, flushing it after each write of the answers, until the end of
+      p_input or a "quit" or "shutdown" command; returns once every request that was read has been answered.
+    */
+    void Serve(std::istream& p_input, std::ostream& p_output);
+
+    /*
+    * Listens on the Unix domain socket at p_path (replacing any file there), answering the requests of each
+      connection on a thread of its own, until a client sends "shutdown"; returns once the connections have ended.
+    * Returns false, assigning a description of the problem to p_error, if the socket can't be created or the
+      platform doesn't have Unix domain sockets.
+    */
+    bool ServeSocket(const char* p_path, std::string& p_error);
+
+    /*
+    * Writes the number of puzzles answered so far and the percentiles of their total times (e.g.
+      'requests=120 mean_us=48.5 p50_us=41 p90_us=77 p99_us=151 p999_us=303 max_us=310'), without a newline.
+    */
+    void WriteLatencies(std::ostream& p_output) const;
+
+
+private:
+
+    /* Auxiliary of Serve, ServeSocket
+    * Reads the requests of p_connection with p_read_line (which returns false at the end of the input), until the end
+      or a command to stop, and waits for them to be answered.
+    */
+    void ServeConnection(Connection& p_connection, const std::function<bool(std::string&)>& p_read_line);
+
+    /* Auxiliary of ServeConnection, RunWorker
+    * Queues p_answer, the answer to the request numbered p_id, to be written once the earlier requests have been
+      answered.
+    */
+    void Answer(Connection& p_connection, unsigned long long p_id, std::string&& p_answer);
+
+    /* Auxiliary of ServeConnection
+    * The loop run by the writer thread of p_connection: writes the answers as they're queued by Answer, until the
+      connection is ending and they've all been written.
+    */
+    void WriteAnswers(Connection& p_connection);
+
+    /* Auxiliary of SolverService
+    * The loop run by each worker: solves the requests and answers them.
+    */
+    void RunWorker(unsigned int p_worker);
+
+    /* Auxiliary of SolverService, RunWorker
+    * Returns the board of the worker p_worker for boxes of p_width_box by p_height_box, creating and warming it up if
+      it doesn't have one yet.
+    */
+    SudokuBoard& GetBoard(unsigned int p_worker, unsigned int p_width_box, unsigned int p_height_box);
+
+    /* Auxiliary of ServeSocket
+    * Serves the connection whose socket is p_socket, and closes it.
+    */
+    void ServeClient(int p_socket);
+
+    /* Auxiliary of ServeSocket
+    * Joins the threads of the connections that have ended (or, if p_is_all is true, of every connection, waiting for
+      those that are still open).
+    */
+    void JoinClients(bool p_is_all);
+
+    /* Auxiliary of ServeConnection
+    * Makes ServeSocket stop accepting connections, if it's listening.
+    */
+    void StopAccepting();
+
+};
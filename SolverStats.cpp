@@ -0,0 +1,84 @@
+#include"SolverStats.h"
+
+#include<algorithm>
+
+
+// The names of the techniques, in the order of SolverStats::deductions; as they're written by WriteJson.
+static const char* const S_NAMES_TECHNIQUES[SolverStats::S_NUM_TECHNIQUES] =
+{
+    "naked_singles", "hidden_singles", "locked_candidates", "naked_pairs", "hidden_pairs"
+};
+
+
+void SolverStats::ClearSearch()
+{
+    strategy = nullptr;
+    nodes = 0;
+    backtracks = 0;
+    max_depth = 0;
+    restarts = 0;
+    placements = 0;
+
+    std::fill(deductions, deductions + S_NUM_TECHNIQUES, 0);
+}
+
+void SolverStats::AddSearch(const SolverStats& p_other)
+{
+    nodes += p_other.nodes;
+    backtracks += p_other.backtracks;
+    max_depth = std::max(max_depth, p_other.max_depth);
+    restarts += p_other.restarts;
+    placements += p_other.placements;
+
+    for (unsigned int i = 0; i < S_NUM_TECHNIQUES; ++i)
+    {
+        deductions[i] += p_other.deductions[i];
+    }
+
+}
+
+/*
+* Notes:
+    (a). The times are written in milliseconds, which suit the times that people read.
+*/
+void SolverStats::WriteText(std::ostream& p_output) const
+{
+    if (strategy != nullptr)
+    { p_output << "  strategy: " << strategy << '\n'; }
+
+    p_output << "  nodes: " << nodes << "\n  backtracks: " << backtracks << "\n  max depth: " << max_depth
+             << "\n  restarts: " << restarts << "\n  placements: " << placements << '\n';
+
+    for (unsigned int i = 0; i < S_NUM_TECHNIQUES; ++i)
+    {
+        p_output << "  " << S_NAMES_TECHNIQUES[i] << ": " << deductions[i] << '\n';
+    }
+
+    // (a).
+    p_output << "  time (ms): parse " << seconds_parse * 1e3 << ", validate " << seconds_validate * 1e3 << ", solve "
+             << seconds_solve * 1e3 << ", print " << seconds_print * 1e3 << '\n';
+}
+
+/*
+* Notes:
+    (a). The times are written in microseconds, as whole numbers, which is precise enough for a single puzzle.
+*/
+void SolverStats::WriteJson(std::ostream& p_output) const
+{
+    if (strategy != nullptr)
+    { p_output << "\"strategy\": \"" << strategy << "\", "; }
+
+    p_output << "\"nodes\": " << nodes << ", \"backtracks\": " << backtracks << ", \"max_depth\": " << max_depth
+             << ", \"restarts\": " << restarts << ", \"placements\": " << placements;
+
+    for (unsigned int i = 0; i < S_NUM_TECHNIQUES; ++i)
+    {
+        p_output << ", \"" << S_NAMES_TECHNIQUES[i] << "\": " << deductions[i];
+    }
+
+    // (a).
+    p_output << ", \"parse_us\": " << static_cast<unsigned long long>(seconds_parse * 1e6)
+             << ", \"validate_us\": " << static_cast<unsigned long long>(seconds_validate * 1e6)
+             << ", \"solve_us\": " << static_cast<unsigned long long>(seconds_solve * 1e6)
+             << ", \"print_us\": " << static_cast<unsigned long long>(seconds_print * 1e6);
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include<chrono>
+#include<iostream>
+
+
+/*
+* The statistics are collected unless SUDOKU_NO_STATS is defined when compiling, in which case the engines' counters
+  and the timing of the phases are compiled out, leaving the search exactly as it would be without them (and the
+  statistics always 0).
+* The engines update their counters through SUDOKU_STAT, which compiles to nothing when they're compiled out; the
+  statement is still seen by the compiler (without being evaluated), so that the variables that only it uses don't
+  become unused.
+*/
+#ifdef SUDOKU_NO_STATS
+#define SUDOKU_STAT(p_statement) do { if (false) { p_statement; } } while (0)
+#else
+#define SUDOKU_STAT(p_statement) p_statement
+#endif
+
+
+/*
+* The statistics of a search for the solution(s) of one grid, and the time taken by each phase of dealing with it.
+* The engines fill in the counters of their searches; SudokuBoard gathers them and times the phases that it runs
+  (validate and solve), while its caller can record the others (parse and print).
+*/
+struct SolverStats
+{
+    // Whether or not the statistics are compiled in (see SUDOKU_NO_STATS).
+#ifdef SUDOKU_NO_STATS
+    static const bool S_IS_ENABLED = false;
+#else
+    static const bool S_IS_ENABLED = true;
+#endif
+
+    // The number of logical techniques that deductions are counted for; the index of each is the bit of its flag in
+    // SudokuSolver (e.g. 2 for S_LOCKED_CANDIDATES).
+    static const unsigned int S_NUM_TECHNIQUES = 5;
+
+    // The name of the strategy whose search answered, when a portfolio raced several (see PortfolioSolver); otherwise
+    // nullptr. The counters are then those of that strategy's search.
+    const char* strategy;
+
+    // The number of nodes of the search tree that were visited, including the root.
+    unsigned long long nodes;
+
+    // The number of dead ends: the nodes at which the search found a contradiction, and so had to go back.
+    unsigned long long backtracks;
+
+    // The greatest number of decisions (branches taken) on the path from the root to a node.
+    unsigned long long max_depth;
+
+    // The number of times that the search gave up on a run and started again from the root (see
+    // SudokuSolver::SetRestarts).
+    unsigned long long restarts;
+
+    // The number of values placed by the search, whether chosen or forced by propagation (not the pre-filled cells).
+    unsigned long long placements;
+
+    // For each technique, the number of values that it placed (naked and hidden singles) or of candidates that it
+    // eliminated (the others).
+    unsigned long long deductions[S_NUM_TECHNIQUES];
+
+    // The wall-clock time of each phase, in seconds: reading the puzzle, checking its pre-filled cells, searching for
+    // the solution(s) and writing the result. A phase that wasn't timed is 0.
+    double seconds_parse;
+    double seconds_validate;
+    double seconds_solve;
+    double seconds_print;
+
+    /*
+    * Sets the counters of the search (but not the times) to 0, and the strategy to nullptr.
+    */
+    void ClearSearch();
+
+    /*
+    * Adds the counters of p_other's search to these (taking the greater of the two depths); used to combine the
+      searches of several threads.
+    */
+    void AddSearch(const SolverStats& p_other);
+
+    /*
+    * Writes the statistics as indented 'name: value' lines, for people.
+    */
+    void WriteText(std::ostream& p_output) const;
+
+    /*
+    * Writes the statistics as the members of a JSON object (e.g. '"nodes": 12, ...'), without the enclosing braces,
+      so that the caller can add members of its own.
+    */
+    void WriteJson(std::ostream& p_output) const;
+
+};
+
+
+/*
+* Measures the phases of a task one after another: each call to Lap returns the time since the previous call (or since
+  the timer was created), in seconds.
+* If the timer is created with timing off (or the statistics are compiled out), the clock is never read and Lap
+  returns 0.
+*/
+class PhaseTimer
+{
+
+private:
+
+    // Whether or not the phases are being timed.
+    bool f_is_timing;
+
+    // The time of the previous lap.
+    std::chrono::steady_clock::time_point f_last;
+
+
+public:
+
+    PhaseTimer(bool p_is_timing)
+        : f_is_timing(p_is_timing && SolverStats::S_IS_ENABLED)
+    {
+        if (f_is_timing)
+        { f_last = std::chrono::steady_clock::now(); }
+    }
+
+    double Lap()
+    {
+        if (!f_is_timing)
+        { return 0.0; }
+
+        std::chrono::steady_clock::time_point l_now = std::chrono::steady_clock::now();
+        double l_seconds = std::chrono::duration<double>(l_now - f_last).count();
+
+        f_last = l_now;
+
+        return l_seconds;
+    }
+
+};
@@ -1,30 +1,31 @@
 
 #include"SudokuBoard.h"
 
+#include"BoardWriter.h"
+#include"PuzzleReader.h"
+
+#include<thread>
+
 
 SudokuBoard::SudokuBoard()
-    : f_grid(S_SIZE_GRID_DEFAULT, S_SIZE_GRID_DEFAULT), f_width_box(S_WIDTH_BOX_DEFAULT),
-      f_height_box(S_HEIGHT_BOX_DEFAULT), f_size_grid(S_SIZE_GRID_DEFAULT)
+    : f_grid(S_SIZE_GRID_DEFAULT), f_width_box(S_WIDTH_BOX_DEFAULT),
+      f_height_box(S_HEIGHT_BOX_DEFAULT), f_size_grid(S_SIZE_GRID_DEFAULT),
+      f_engine(Engine::BackTracking), f_stats(), f_is_timing(false), f_is_tracking(false)
 {
     EmptyBoard();
 }
 
 SudokuBoard::SudokuBoard(const char* p_file)
-    : f_grid(S_SIZE_GRID_DEFAULT, S_SIZE_GRID_DEFAULT), f_width_box(S_WIDTH_BOX_DEFAULT),
-      f_height_box(S_HEIGHT_BOX_DEFAULT), f_size_grid(S_SIZE_GRID_DEFAULT)
+    : f_grid(S_SIZE_GRID_DEFAULT), f_width_box(S_WIDTH_BOX_DEFAULT),
+      f_height_box(S_HEIGHT_BOX_DEFAULT), f_size_grid(S_SIZE_GRID_DEFAULT),
+      f_engine(Engine::BackTracking), f_stats(), f_is_timing(false), f_is_tracking(false)
 {
-    std::ifstream l_file_input(p_file);
-
-    if (!l_file_input.good())
-        return;
-
-    l_file_input >> *this;
-
-    l_file_input.close();
+    ReadFile(p_file);
 }
 
 SudokuBoard::SudokuBoard(unsigned int p_width_box, unsigned int p_height_box)
-    : f_width_box(p_width_box), f_height_box(p_height_box)
+    : f_width_box(p_width_box), f_height_box(p_height_box), f_engine(Engine::BackTracking), f_stats(),
+      f_is_timing(false), f_is_tracking(false)
 {
     if (f_width_box > S_WIDTH_BOX_MAX || f_height_box > S_HEIGHT_BOX_MAX)
     {
@@ -34,11 +35,12 @@ SudokuBoard::SudokuBoard(unsigned int p_width_box, unsigned int p_height_box)
 
     f_size_grid = f_width_box * f_height_box;
 
-    f_grid.ChangeDimensions(f_size_grid, f_size_grid);
+    f_grid.Resize(f_size_grid);
 }
 
 SudokuBoard::SudokuBoard(unsigned int p_width_box, unsigned int p_height_box, const char* p_file)
-    : f_width_box(p_width_box), f_height_box(p_height_box)
+    : f_width_box(p_width_box), f_height_box(p_height_box), f_engine(Engine::BackTracking), f_stats(),
+      f_is_timing(false), f_is_tracking(false)
 {
     if (f_width_box > S_WIDTH_BOX_MAX || f_height_box > S_HEIGHT_BOX_MAX)
     {
@@ -53,315 +55,630 @@ SudokuBoard::SudokuBoard(unsigned int p_width_box, unsigned int p_height_box, co
 
     int l_size_grid = f_width_box * f_height_box;
 
-    f_grid.ChangeDimensions(l_size_grid, l_size_grid);
+    f_grid.Resize(l_size_grid);
 
-    std::ifstream l_file_input(p_file);
+    ReadFile(p_file);
+}
 
-    l_file_input >> *this;
 
-    l_file_input.close();
+bool SudokuBoard::Solve()
+{
+    return TrySolve() == Result::Solved;
 }
 
+/*
+* Notes:
+    (a). Loading the grid into an engine also checks that none of the pre-filled cells violate the rules of sudoku,
+         so a separate call to IsValid isn't needed; the load is timed as the validate phase.
+    (b). The engine's counters are only taken if the grid was loaded, as they're otherwise those of a previous grid.
+    (c). The engines are only given the budget if it has limits, so that an unlimited search isn't metered. The
+         parallel search's threads take the budget from their copies of the solver.
+    (d). The strategies of the portfolio load (and so check) the grid on their own threads, so the validate phase is
+         timed as part of the solve phase. Each strategy has a budget of its own, with the limits of f_budget, so the
+         search ran out of budget if no strategy finished it.
+    (e). A grid with more digits than f_solver can hold is searched (on one thread or in parallel) by f_solver_wide,
+         with f_solver's settings.
+*/
+SudokuBoard::Result SudokuBoard::TrySolve()
+{
+    PhaseTimer l_timer(f_is_timing);
 
-bool SudokuBoard::Solve()
+    bool l_is_valid;
+    bool l_is_solved = false;
+
+    f_stats.ClearSearch();
+
+    // (c).
+    SearchBudget* l_budget = f_budget.IsLimited() ? &f_budget : nullptr;
+
+    if (l_budget != nullptr)
+    { l_budget->Start(); }
+
+    // Solves the grid with p_solver, an instantiation of the BackTracking engine, on the threads of the parallel
+    // search if there are several.
+    auto l_solve = [&](auto& p_solver)
+    {
+        // (a).
+        l_is_valid = p_solver.Load(f_grid, f_width_box, f_height_box);
+        f_stats.seconds_validate = l_timer.Lap();
+
+        // (b).
+        if (l_is_valid)
+        {
+            p_solver.SetBudget(l_budget);
+            l_is_solved = f_solver_parallel ? f_solver_parallel->Solve(p_solver) : p_solver.Solve();
+            f_stats.AddSearch(f_solver_parallel ? f_solver_parallel->GetStats() : p_solver.GetStats());
+        }
+
+        if (l_is_solved)
+        { f_solver_parallel ? f_solver_parallel->Store(f_grid) : p_solver.Store(f_grid); }
+    };
+
+    if (f_solver_portfolio)
+    {
+        // (d).
+        f_stats.seconds_validate = l_timer.Lap();
+
+        l_is_solved = f_solver_portfolio->Solve(f_grid, f_width_box, f_height_box, f_budget);
+        f_stats.AddSearch(f_solver_portfolio->GetStats());
+        f_stats.strategy = f_solver_portfolio->GetStats().strategy;
+
+        if (l_is_solved)
+        { f_solver_portfolio->Store(f_grid); }
+    }
+    else if (!f_solver_parallel && UseFixedSizeSolver())
+    {
+        // (a).
+        l_is_valid = f_solver_fixed->Load(f_grid);
+        f_stats.seconds_validate = l_timer.Lap();
+
+        // (b).
+        if (l_is_valid)
+        {
+            f_solver_fixed->SetBudget(l_budget);
+            l_is_solved = f_solver_fixed->Solve();
+            f_stats.AddSearch(f_solver_fixed->GetStats());
+        }
+
+        if (l_is_solved)
+        { f_solver_fixed->Store(f_grid); }
+    }
+    else if (f_engine == Engine::DancingLinks)
+    {
+        // (a).
+        l_is_valid = f_solver_dlx.Load(f_grid, f_width_box, f_height_box);
+        f_stats.seconds_validate = l_timer.Lap();
+
+        // (b).
+        if (l_is_valid)
+        {
+            f_solver_dlx.SetBudget(l_budget);
+            l_is_solved = f_solver_dlx.Solve();
+            f_stats.AddSearch(f_solver_dlx.GetStats());
+        }
+
+        if (l_is_solved)
+        { f_solver_dlx.Store(f_grid); }
+    }
+    else if (f_size_grid > SudokuSolver::S_NUM_DIGITS_MAX)
+    {
+        // (e).
+        f_solver_wide.CopySettings(f_solver);
+        l_solve(f_solver_wide);
+    }
+    else
+    {
+        l_solve(f_solver);
+    }
+
+    if (l_is_solved)
+    { f_conflicts.Invalidate(); }
+
+    f_stats.seconds_solve = l_timer.Lap();
+
+    if (l_is_solved)
+    { return Result::Solved; }
+
+    // (d).
+    if (f_solver_portfolio)
+    { return f_solver_portfolio->GetWinner() == nullptr ? Result::OutOfBudget : Result::Unsolvable; }
+
+    return l_budget != nullptr && l_budget->GetLimitReached() != SearchBudget::Limit::None ? Result::OutOfBudget
+                                                                                            : Result::Unsolvable;
+}
+
+unsigned long long SudokuBoard::CountSolutions(unsigned long long p_max_solutions /*= 0*/)
 {
-    if (!IsValid())
-    { return false; }
+    unsigned long long l_num_solutions = 0;
 
-    return Solve_BackTracking();
+    return VisitSolutions(1, [&]() { return ++l_num_solutions != p_max_solutions; });
 }
 
-void SudokuBoard::EmptyBoard()
+bool SudokuBoard::HasUniqueSolution()
+{
+    return CountSolutions(2) == 1;
+}
+
+unsigned long long SudokuBoard::EnumerateSolutions(const std::function<bool(const SudokuBoard&)>& p_visit)
+{
+    return VisitSolutions(~0ULL, [&]() { return p_visit(*this); });
+}
+
+void SudokuBoard::SetEngine(Engine p_engine)
+{
+    f_engine = p_engine;
+}
+
+void SudokuBoard::SetBranching(SudokuSolver::Branching p_branching, 
+                               SudokuSolver::TieBreak p_tie_break /*= SudokuSolver::TieBreak::LowestIndex*/)
 {
-    f_grid.SetAllTo(S_VALUE_EMPTY_CELL);
+    f_solver.SetBranching(p_branching, p_tie_break);
+}
+
+void SudokuBoard::SetPropagation(unsigned int p_techniques, bool p_at_every_node /*= true*/)
+{
+    f_solver.SetPropagation(p_techniques, p_at_every_node);
+}
+
+void SudokuBoard::SetRandomization(bool p_is_random, unsigned long long p_seed /*= 0*/)
+{
+    f_solver.SetRandomization(p_is_random, p_seed);
+}
+
+void SudokuBoard::SetRestarts(SudokuSolver::Restarts p_restarts,
+                              unsigned long long p_nodes_first_run /*= SudokuSolver::S_NODES_FIRST_RUN*/)
+{
+    f_solver.SetRestarts(p_restarts, p_nodes_first_run);
 }
 
 /*
-* Returns whether or not the board adheres to the rules of sudoku.
+* Notes:
+    (a). A single thread (including one per hardware thread on a single core) searches without the ParallelSolver,
+         whose hand-overs would only slow it down, and so that the specialisations of the engine can be used.
 */
-bool SudokuBoard::IsValid()
+void SudokuBoard::SetNumThreads(unsigned int p_num_threads)
+{
+    if (p_num_threads == 0)
+    { p_num_threads = std::thread::hardware_concurrency(); }
+
+    // (a).
+    if (p_num_threads <= 1)
+    { f_solver_parallel.reset(); }
+    else
+    { f_solver_parallel.reset(new ParallelSolver(p_num_threads)); }
+}
+
+void SudokuBoard::SetPortfolio(const std::vector<PortfolioSolver::Strategy>& p_strategies)
+{
+    if (p_strategies.empty())
+    { f_solver_portfolio.reset(); }
+    else
+    { f_solver_portfolio.reset(new PortfolioSolver(p_strategies)); }
+}
+
+void SudokuBoard::SetTiming(bool p_is_timing)
+{
+    f_is_timing = p_is_timing;
+}
+
+void SudokuBoard::SetTracking(bool p_is_tracking)
+{
+    f_is_tracking = p_is_tracking;
+    f_conflicts.Invalidate();
+}
+
+void SudokuBoard::CopySettings(const SudokuBoard& p_other)
+{
+    f_engine = p_other.f_engine;
+    f_solver.CopySettings(p_other.f_solver);
+    f_is_timing = p_other.f_is_timing;
+    f_budget.CopyLimits(p_other.f_budget);
+
+    SetPortfolio(p_other.f_solver_portfolio ? p_other.f_solver_portfolio->GetStrategies()
+                                            : std::vector<PortfolioSolver::Strategy>());
+}
+
+SearchBudget& SudokuBoard::GetBudget()
+{
+    return f_budget;
+}
+
+SolverStats& SudokuBoard::GetStats()
 {
-    for (int row = 0; row < f_size_grid; ++row)
+    return f_stats;
+}
+
+const SolverStats& SudokuBoard::GetStats() const
+{
+    return f_stats;
+}
+
+void SudokuBoard::EmptyBoard()
+{
+    f_grid.Fill(S_VALUE_EMPTY_CELL);
+    f_conflicts.Invalidate();
+}
+
+bool SudokuBoard::SetDimensions(unsigned int p_width_box, unsigned int p_height_box)
+{
+    if (!AreDimensionsSupported(p_width_box, p_height_box))
+    { return false; }
+
+    if (p_width_box != f_width_box || p_height_box != f_height_box)
     {
-        for (int col = 0; col < f_size_grid; ++col)
-        {
-            if (!IsCellValid(row, col))
-            { return false; }
-        }
+        f_width_box = p_width_box;
+        f_height_box = p_height_box;
 
+        f_size_grid = f_width_box * f_height_box;
+        f_grid.Resize(f_size_grid);
+        f_conflicts.Invalidate();
     }
 
     return true;
 }
 
+bool SudokuBoard::AreDimensionsSupported(unsigned int p_width_box, unsigned int p_height_box)
+{
+    return p_width_box != 0 && p_height_box != 0 && p_width_box <= S_WIDTH_BOX_MAX && p_height_box <= S_HEIGHT_BOX_MAX;
+}
+
+unsigned int SudokuBoard::GetWidthBox() const
+{
+    return f_width_box;
+}
+
+unsigned int SudokuBoard::GetHeightBox() const
+{
+    return f_height_box;
+}
+
+unsigned int SudokuBoard::GetSizeGrid() const
+{
+    return f_size_grid;
+}
+
+const CompactGrid& SudokuBoard::GetGrid() const
+{
+    return f_grid;
+}
+
+void SudokuBoard::TakeSnapshot(Snapshot& p_snapshot) const
+{
+    p_snapshot.grid = f_grid;
+    p_snapshot.width_box = f_width_box;
+    p_snapshot.height_box = f_height_box;
+}
+
+void SudokuBoard::RestoreSnapshot(const Snapshot& p_snapshot)
+{
+    f_grid = p_snapshot.grid;
+    f_width_box = p_snapshot.width_box;
+    f_height_box = p_snapshot.height_box;
+    f_size_grid = f_width_box * f_height_box;
+    f_conflicts.Invalidate();
+}
+
+unsigned int SudokuBoard::GetValue(unsigned int p_row, unsigned int p_col) const
+{
+    return f_grid.GetChecked(p_row, p_col);
+}
+
+/*
+* Notes:
+    (a). If the conflicts aren't current, they're rebuilt by the next check anyway, so only the grid is changed.
+*/
+void SudokuBoard::SetValue(unsigned int p_row, unsigned int p_col, unsigned int p_value)
+{
+    // (a).
+    if (!f_is_tracking || !f_conflicts.IsCurrent())
+    {
+        f_grid.SetChecked(p_row, p_col, p_value);
+        return;
+    }
+
+    unsigned int l_value_old = f_grid.GetChecked(p_row, p_col);
+
+    f_grid.SetChecked(p_row, p_col, p_value);
+    f_conflicts.Update(f_grid, p_row * f_size_grid + p_col, l_value_old);
+}
+
+/*
+* Returns whether or not the board adheres to the rules of sudoku.
+*/
+bool SudokuBoard::IsValid()
+{
+    return GetTracker().GetConflicts().empty();
+}
+
 /*
 * Returns whether or not the board has been solved.
 */
 bool SudokuBoard::IsSolved()
 {
-    for (int row = 0; row < f_size_grid; ++row)
-    {
-        for (int col = 0; col < f_size_grid; ++col)
-        {
-            if (f_grid.ValueRowCol(row, col) == S_VALUE_EMPTY_CELL || !IsCellValid(row, col))
-            { return false; }
-        }
+    ConflictTracker& l_tracker = GetTracker();
 
-    }
+    return l_tracker.GetNumEmpty() == 0 && l_tracker.GetConflicts().empty();
+}
 
-    return true;
+const std::vector<unsigned int>& SudokuBoard::GetConflicts()
+{
+    return GetTracker().GetConflicts();
 }
 
 
+/*
+* Notes:
+    (a). The stream is read one line at a time, so that it isn't read past the puzzle's last line, and the next
+         puzzle can be read from it.
+    (b). The puzzle is read into a separate board, so that p_board is only changed once the whole puzzle is known to
+         be well-formed.
+*/
 std::istream& operator>>(std::istream& p_istream, SudokuBoard& p_board)
 {
-    // The width and height of each box.
-    int l_width_box;
-    int l_height_box;
+    // (a).
+    PuzzleReader l_reader(p_istream, true);
 
-    // Get the width and height.
-    p_istream >> l_width_box >> l_height_box;
+    // (b).
+    SudokuBoard l_board;
 
-    // If the current board isn't compatible with the given dimensions, change it's dimensions.
-    if (l_width_box != p_board.f_width_box || l_height_box != p_board.f_height_box)
+    if (!l_reader.Read(l_board))
     {
-        p_board.f_width_box = l_width_box;
-        p_board.f_height_box = l_height_box;
-
-        p_board.f_size_grid = p_board.f_width_box * p_board.f_height_box;
-        p_board.f_grid.ChangeDimensions(p_board.f_size_grid, p_board.f_size_grid);
+        p_istream.setstate(std::ios::failbit);
+        return p_istream;
     }
 
-    p_istream >> p_board.f_grid;
+    p_board.SetDimensions(l_board.f_width_box, l_board.f_height_box);
+
+    for (unsigned int row = 0; row < p_board.f_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < p_board.f_size_grid; ++col)
+        {
+            p_board.SetValue(row, col, l_board.GetValue(row, col));
+        }
+
+    }
 
     return p_istream;
 }
 
 /*
 * Notes:
-    (a). When all of the values are single digits (max value is at most 9), each value occupies one character and each
-            box is horizontally separated by one character from the others in its row.
-            '(p_board.f_size_grid / p_board.f_width_box)' is the number of boxes per row; therefore, this value minus 1
-            is the number of box divider characters per row.
-    (b). When the maximum value is more than one digit (is equal to at least 10), each value must occupy two characters
-            in order for the sudoku to be easily read; in addition, rather than each value being placed right next to
-            each other, a space separates them, as otherwise two or more two-digit numbers placed right next to each other
-            would appear as one long number. Because of the extra spacing within the boxes, they must be horizontally 
-            separated by more than one space.
-
+    (a). The board is rendered into a string and written in one call; nothing is flushed (see BoardWriter).
 */
-std::ostream& operator<<(std::ostream& p_ostream, SudokuBoard& p_board)
+std::ostream& operator<<(std::ostream& p_ostream, const SudokuBoard& p_board)
 {
-    // The number of boxes per row.
-    int l_num_boxes_in_row = p_board.f_height_box;
+    // (a).
+    std::string l_text;
+    BoardWriter::Render(l_text, p_board, BoardWriter::Format::Pretty);
+
+    return p_ostream.write(l_text.data(), l_text.size());
+}
 
-    // The width of each row (not incl. the borders).
-    int l_width_output;
-    if (p_board.f_size_grid < 10)
+
+
+/*
+* Notes:
+    (a). The conflicts are brought up to date before the cell is changed, so that the change can then be applied to
+         them alone.
+*/
+bool SudokuBoard::PlaceValue(int p_value, int p_row, int p_col, bool l_if_wrong_remove /*= false*/)
+{
+    if (!f_is_tracking)
     {
-        // (a).
-        l_width_output = p_board.f_size_grid + 4 * (l_num_boxes_in_row - 1) + 2;
+        f_grid.SetChecked(p_row, p_col, p_value);
+
+        if (IsCellValid(p_row, p_col))
+        { return true; }
+
+        if (l_if_wrong_remove)
+        { f_grid.Set(p_row, p_col, S_VALUE_EMPTY_CELL); }
+
+        return false;
     }
-    else
-    {
-        // The number of boxes per row.
-        int l_num_boxes_in_row = p_board.f_height_box;
 
-        // (b).
-        l_width_output = l_num_boxes_in_row * ( 2 + 3 * (p_board.f_width_box - 1) ) + 4 * (l_num_boxes_in_row - 1) + 2;
+    // (a).
+    ConflictTracker& l_tracker = GetTracker();
+
+    unsigned int l_value_old = f_grid.GetChecked(p_row, p_col);
+    f_grid.SetChecked(p_row, p_col, p_value);
+
+    unsigned int l_cell = p_row * f_size_grid + p_col;
+    l_tracker.Update(f_grid, l_cell, l_value_old);
+
+    if (!l_tracker.IsConflicting(l_cell))
+    { return true; }
+
+    if (l_if_wrong_remove)
+    {
+        f_grid.Set(p_row, p_col, S_VALUE_EMPTY_CELL);
+        l_tracker.Update(f_grid, l_cell, p_value);
     }
 
-    for (int row = 0; row < p_board.f_size_grid; ++row)
+    return false;
+}
+
+
+/* Auxiliary of Solve, VisitSolutions
+
+* Notes:
+    (a). The specialisations only implement the default settings; otherwise (or if the dimensions have none), the
+         generic solver is used.
+    (b). A specialisation is only used if its shape is the board's; one of another shape would reject, or fail to
+         solve, a puzzle that has a solution.
+*/
+bool SudokuBoard::UseFixedSizeSolver()
+{
+    // (a).
+    if (f_engine != Engine::BackTracking || !f_solver.HasDefaultSettings())
+    { return false; }
+
+    if (!f_solver_fixed || f_solver_fixed->GetWidthBox() != f_width_box ||
+        f_solver_fixed->GetHeightBox() != f_height_box)
+    { f_solver_fixed = FixedSizeSolverBase::Create(f_width_box, f_height_box); }
+
+    // (b).
+    return f_solver_fixed && f_solver_fixed->GetWidthBox() == f_width_box &&
+           f_solver_fixed->GetHeightBox() == f_height_box;
+}
+
+/* Auxiliary of CountSolutions, EnumerateSolutions
+
+* Notes:
+    (a). Each engine searches from the grid as it was when the search began, so f_grid can be overwritten as the
+         solutions are visited.
+    (b). The parallel search stops at the first solution, so the sequential one (or its specialisation) is used even
+         when there are several threads.
+    (c). As in Solve, the load is timed as the validate phase, and the engine's counters are only taken if the grid was
+         loaded.
+    (d). As in Solve, the engines are only given the budget if it has limits.
+    (e). As in Solve, a grid with more digits than f_solver can hold is searched by f_solver_wide.
+*/
+unsigned long long SudokuBoard::VisitSolutions(unsigned long long p_num_stored, const std::function<bool()>& p_visit)
+{
+    PhaseTimer l_timer(f_is_timing);
+
+    unsigned long long l_num_visited = 0;
+
+    f_stats.ClearSearch();
+
+    // (d).
+    SearchBudget* l_budget = f_budget.IsLimited() ? &f_budget : nullptr;
+
+    if (l_budget != nullptr)
+    { l_budget->Start(); }
+
+    // Copies the engine's current solution into f_grid (a), if it's one of the first p_num_stored, and visits it.
+    auto l_visit = [&](auto& p_solver)
     {
-        // If on the first row, output the top border.
-        if (row == 0)
+        if (l_num_visited++ < p_num_stored)
         {
-            p_ostream << '|';
-            for (int i = 0; i < l_width_output; ++i)
-            { p_ostream << '='; }
-            p_ostream << '|';
-            p_ostream << std::endl;
+            p_solver.Store(f_grid);
+            f_conflicts.Invalidate();
         }
 
-        // A flag that, when true, indicates that a row of boxes was just finished.
-        bool l_is_new_box_row = row % p_board.f_height_box == 0;
-
-        // Separate the boxes vertically.
-        if (row != 0 && l_is_new_box_row)
-        { 
-            p_ostream << '|';
-            for (int i = 0; i < l_width_output; ++i)
-            { p_ostream << '='; }
-            p_ostream << '|';
-            p_ostream << std::endl; 
-        }
+        return p_visit();
+    };
 
-        for (int col = 0; col < p_board.f_size_grid; ++col)
-        {
-            // The value associated with the coordinates.
-            int l_value = p_board.f_grid.ValueRowCol(row, col);
-
-            // A flag that, when true, indicates that l_value is the first value of a box for this row.
-            bool l_is_new_box = col % p_board.f_width_box == 0;
-
-            // Separate the boxes horizontally.
-            if (col != 0 && l_is_new_box)
-            {  p_ostream << " || "; }
-
-            // Left border.
-            if (col == 0)
-            { p_ostream << '|'; }
-
-            // Padding from the left border.
-            if (col == 0)
-            { p_ostream << ' '; }
-
-            // The value.
-            if (p_board.f_size_grid < 10) // If there are no two-digit values.
-            {
-                p_ostream << l_value;
-            }
-            else
-            {
-                if (l_is_new_box)
-                {
-                    if (l_value >= 10) // If the value is a two-digit number.
-                    {
-                        p_ostream << l_value;
-                    }
-                    else
-                    {
-                        p_ostream << ' ' << l_value;
-                    }
-                }
-                else
-                {
-                    if (l_value >= 10) // If the value is a two-digit number.
-                    {
-                        p_ostream << ' ' << l_value;
-                    }
-                    else
-                    {
-                        p_ostream << "  " << l_value;
-                    }
-                }
-
-            }
-
-            // Padding from the right border.
-            if (col == p_board.f_size_grid - 1)
-            { p_ostream << ' '; }
-
-            // Right border.
-            if (col == p_board.f_size_grid - 1)
-            { p_ostream << '|'; }
+    // Enumerates the solutions with p_solver, an instantiation of the BackTracking engine.
+    auto l_enumerate = [&](auto& p_solver)
+    {
+        // (c).
+        bool l_is_valid = p_solver.Load(f_grid, f_width_box, f_height_box);
+        f_stats.seconds_validate = l_timer.Lap();
 
+        if (l_is_valid)
+        {
+            p_solver.SetBudget(l_budget);
+            p_solver.Enumerate([&]() { return l_visit(p_solver); });
+            f_stats.AddSearch(p_solver.GetStats());
         }
+    };
+
+    // (b).
+    if (UseFixedSizeSolver())
+    {
+        // (c).
+        bool l_is_valid = f_solver_fixed->Load(f_grid);
+        f_stats.seconds_validate = l_timer.Lap();
 
-        // If on the last row, output the bottom border.
-        if (row == p_board.f_size_grid - 1)
+        if (l_is_valid)
         {
-            p_ostream << std::endl;
-            p_ostream << '|';
-            for (int i = 0; i < l_width_output; ++i)
-            { p_ostream << '='; }
-            p_ostream << '|';
-            p_ostream << std::endl;
+            f_solver_fixed->SetBudget(l_budget);
+            f_solver_fixed->Enumerate([&]() { return l_visit(*f_solver_fixed); });
+            f_stats.AddSearch(f_solver_fixed->GetStats());
         }
-        else
+    }
+    else if (f_engine == Engine::DancingLinks)
+    {
+        // (c).
+        bool l_is_valid = f_solver_dlx.Load(f_grid, f_width_box, f_height_box);
+        f_stats.seconds_validate = l_timer.Lap();
+
+        if (l_is_valid)
         {
-            // Go to a new line for each row.
-            p_ostream << std::endl;
+            f_solver_dlx.SetBudget(l_budget);
+            f_solver_dlx.Enumerate([&]() { return l_visit(f_solver_dlx); });
+            f_stats.AddSearch(f_solver_dlx.GetStats());
         }
-
+    }
+    else if (f_size_grid > SudokuSolver::S_NUM_DIGITS_MAX)
+    {
+        // (e).
+        f_solver_wide.CopySettings(f_solver);
+        l_enumerate(f_solver_wide);
+    }
+    else
+    {
+        l_enumerate(f_solver);
     }
 
-    return p_ostream;
-}
-
-
+    f_stats.seconds_solve = l_timer.Lap();
 
-/* Auxiliary of Solve
+    return l_num_visited;
+}
 
-* Notes: 
-    (a). All possible values may not need to be iterated over; it could even be the case that only value is
-         considered for this cell. In other words, iterate over at most all values.
-    (b). Note that it's not necessarily the case that the sudoku cannot be solved with the current value at the cell
-         (l_row, l_col), rather that this cannot occur on the current 'branch' of the recursive program.
-    (c). If the current Solve_BackTracking call is the top/first one, this means that the sudoku cannot be
-         solved: i.e. it's an impossible puzzle.
+/* Auxiliary of SudokuBoard(const char*), SudokuBoard(unsigned int, unsigned int, const char*)
 */
-bool SudokuBoard::Solve_BackTracking()
+void SudokuBoard::ReadFile(const char* p_file)
 {
-    // Variables to store the (empty) cell being considered by this Solve_BackTracking call.
-    int l_row;
-    int l_col;
+    PuzzleReader l_reader;
 
-    // Get the next empty cell; if a cell cannot be assigned, this means all cells are filled, which would imply that the sudoku is solved.
-    if (!AssignNextEmptyCell(l_row, l_col))
-    { return true; }
+    bool l_is_open = l_reader.Open(p_file);
 
-    // (a). Iterate over (at most) all possible values.
-    for (int value = 1; value <= f_size_grid; ++value)
-    {
-        // Try to place the value; if it cannot be placed, continue to the next value.
-        if (!PlaceValue(value, l_row, l_col, true))
-        { continue; }
+    if (!l_is_open && l_reader.GetError().empty())
+    { throw std::runtime_error(std::string("The file '") + p_file + "' could not be opened."); }
 
-        // Execute a recursive call; if this call returns true, then the sudoku must be solved; therefore, return true.
-        if (Solve_BackTracking())
-        { return true; }
+    if (!l_is_open || !l_reader.Read(*this))
+    {
+        const std::string& l_error = l_reader.GetError();
 
-        // (b). If this line is reached, this means the sudoku cannot be solved with the current value. 
-        f_grid.ValueRowCol(l_row, l_col) = S_VALUE_EMPTY_CELL;
+        throw std::runtime_error(std::string("The file '") + p_file + "' is malformed (" +
+                                 (l_error.empty() ? "it holds no puzzle" : l_error) + ").");
     }
 
-    // (c). Return false so that the previous Solve_BackTracking call knows to try a different value.
-    return false;
 }
 
-/* Auxiliary of Solve_BackTracking
+/* Auxiliary of IsValid, IsSolved, GetConflicts
 */
-bool SudokuBoard::PlaceValue(int p_value, int p_row, int p_col, bool l_if_wrong_remove /*= false*/)
+ConflictTracker& SudokuBoard::GetTracker()
 {
-    f_grid.ValueRowCol(p_row, p_col) = p_value;
-
-    if (IsCellValid(p_row, p_col))
-    { return true; }
+    if (!f_is_tracking || !f_conflicts.IsCurrent())
+    { f_conflicts.Reset(f_grid, f_width_box, f_height_box); }
 
-    if (l_if_wrong_remove)
-    { f_grid.ValueRowCol(p_row, p_col) = S_VALUE_EMPTY_CELL; }
-
-    return false;
+    return f_conflicts;
 }
 
-/* Auxiliary of Solve, IsBoardValid
+/* Auxiliary of PlaceValue
 */
-bool SudokuBoard::IsCellValid(int p_row, int p_col)
+bool SudokuBoard::IsCellValid(unsigned int p_row, unsigned int p_col)
 {
-    int l_value = f_grid.ValueRowCol(p_row, p_col);
+    unsigned int l_value = f_grid.Get(p_row, p_col);
 
     // A cell can always be empty.
     if (l_value == S_VALUE_EMPTY_CELL)
     { return true; }
 
+    // A value can't exceed the size of the grid.
+    if (l_value > f_size_grid)
+    { return false; }
+
     // Check if the value is equal to any within its row.
-    for (int col = 0; col < f_size_grid; ++col)
+    for (unsigned int col = 0; col < f_size_grid; ++col)
     {
         if (col == p_col)
         { continue; }
 
-        if (l_value == f_grid.ValueRowCol(p_row, col))
+        if (l_value == f_grid.Get(p_row, col))
         { return false; }
     }
 
     // Check if the value is equal to any within its column.
-    for (int row = 0; row < f_size_grid; ++row)
+    for (unsigned int row = 0; row < f_size_grid; ++row)
     {
         if (row == p_row)
         { continue; }
 
-        if (l_value == f_grid.ValueRowCol(row, p_col))
+        if (l_value == f_grid.Get(row, p_col))
         { return false; }
     }
 
@@ -369,22 +686,22 @@ bool SudokuBoard::IsCellValid(int p_row, int p_col)
     // Each box can be define by four values: a pair of min/max values for the rows and columns.
 
     // Get the min and max row for the box at (p_col, p_row).
-    int l_index_row_min = p_row - p_row % f_height_box;
-    int l_index_row_max = l_index_row_min + (f_height_box - 1);
+    unsigned int l_index_row_min = p_row - p_row % f_height_box;
+    unsigned int l_index_row_max = l_index_row_min + (f_height_box - 1);
 
     // Get the min and max column for the box at (p_col, p_row).
-    int l_index_col_min = p_col - p_col % f_width_box;
-    int l_index_col_max = l_index_col_min + (f_width_box - 1);
+    unsigned int l_index_col_min = p_col - p_col % f_width_box;
+    unsigned int l_index_col_max = l_index_col_min + (f_width_box - 1);
 
     // Check if the value is equal to any within its box.
-    for (int row = l_index_row_min; row < l_index_row_max; ++row)
+    for (unsigned int row = l_index_row_min; row <= l_index_row_max; ++row)
     {
-        for (int col = l_index_col_min; col < l_index_col_max; ++col)
+        for (unsigned int col = l_index_col_min; col <= l_index_col_max; ++col)
         {
             if (row == p_row && col == p_col)
             { continue; }
 
-            if (l_value == f_grid.ValueRowCol(row, col))
+            if (l_value == f_grid.Get(row, col))
             { return false; }
         }
 
@@ -393,26 +710,3 @@ bool SudokuBoard::IsCellValid(int p_row, int p_col)
     // If this point is reached, all of the conditions/rules have been satisfied; thus, return true.
     return true;
 }
-
-/* Auxiliary of Solve_BackTracking
-*/
-bool SudokuBoard::AssignNextEmptyCell(int& p_row, int& p_col)
-{
-    for (int row = 0; row < f_size_grid; ++row)
-    {
-        for (int col = 0; col < f_size_grid; ++col)
-        {
-            if (f_grid.ValueRowCol(row, col) == S_VALUE_EMPTY_CELL)
-            {
-                p_row = row;
-                p_col = col;
-
-                return true;
-            }
-
-        }
-
-    }
-
-    return false;
-}
\ No newline at end of file
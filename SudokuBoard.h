@@ -2,9 +2,20 @@
 
 #include<iostream>
 #include<fstream>
+#include<functional>
+#include<memory>
 #include<stdexcept>
+#include<vector>
 
-#include"Array2D.h"
+#include"CompactGrid.h"
+#include"ConflictTracker.h"
+#include"SudokuSolver.h"
+#include"DancingLinksSolver.h"
+#include"FixedSizeSolver.h"
+#include"ParallelSolver.h"
+#include"PortfolioSolver.h"
+#include"SearchBudget.h"
+#include"SolverStats.h"
 
 
 /*
@@ -13,10 +24,45 @@
 class SudokuBoard
 {
 
+public:
+
+    // The engines that can be used to solve the board.
+    enum class Engine
+    {
+        // Recursive backtracking over the cells of the grid (SudokuSolver).
+        BackTracking,
+
+        // Algorithm X over the exact-cover encoding of the grid (DancingLinksSolver).
+        DancingLinks
+    };
+
+    // The result of TrySolve.
+    enum class Result
+    {
+        Solved,
+
+        // The board has no solution, or its pre-filled cells violate the rules of sudoku (see IsValid).
+        Unsolvable,
+
+        // The search was stopped by its budget (see GetBudget) before it could tell.
+        OutOfBudget
+    };
+
+    // A copy of a board's grid and the dimensions of its boxes (see TakeSnapshot).
+    struct Snapshot
+    {
+        CompactGrid grid;
+        unsigned int width_box;
+        unsigned int height_box;
+    };
+
+
 private:
 
     // The grid that defines the numbers that comprise the sudoku puzzle.
-    Array2D<unsigned int> f_grid;
+    // Its dimensions are always f_size_grid by f_size_grid, so the engines and the checks of the rules of sudoku use
+    // its unchecked accessors.
+    CompactGrid f_grid;
 
     // The width of a box in the grid.
     unsigned int f_width_box;
@@ -29,6 +75,42 @@ private:
     // Having the value as a field removes the need to calculate it or use the GetWidth/GetHeight methods of f_grid.
     unsigned int f_size_grid;
 
+    // The engines used to solve the grid; kept as fields so that their storage is reused across calls to Solve.
+    SudokuSolver f_solver;
+    DancingLinksSolver f_solver_dlx;
+
+    // The BackTracking engine for grids with more digits than f_solver can hold (see SudokuSolver::S_NUM_DIGITS_MAX),
+    // which takes f_solver's settings before each search.
+    WideSudokuSolver f_solver_wide;
+
+    // The BackTracking engine's specialisation for the current box dimensions, if there is one; used in place of
+    // f_solver when the engine has its default settings. Created by Solve when the dimensions change.
+    std::unique_ptr<FixedSizeSolverBase> f_solver_fixed;
+
+    // The engine used by Solve.
+    Engine f_engine;
+
+    // The parallel search used by the BackTracking engine when more than one thread is requested; otherwise nullptr.
+    std::unique_ptr<ParallelSolver> f_solver_parallel;
+
+    // The strategies raced by Solve, if a portfolio has been set (see SetPortfolio); otherwise nullptr.
+    std::unique_ptr<PortfolioSolver> f_solver_portfolio;
+
+    // The statistics of the last call to Solve, CountSolutions or EnumerateSolutions.
+    SolverStats f_stats;
+
+    // Whether or not the phases of those calls are timed (see SetTiming).
+    bool f_is_timing;
+
+    // The limits of the searches of Solve, CountSolutions and EnumerateSolutions (see GetBudget).
+    SearchBudget f_budget;
+
+    // The cells of f_grid that conflict with the rules of sudoku. When tracking is on (see SetTracking), it follows
+    // every change of a single cell, and is rebuilt on demand after the grid has been changed as a whole; otherwise
+    // it's rebuilt by every call to IsValid, IsSolved and GetConflicts.
+    ConflictTracker f_conflicts;
+    bool f_is_tracking;
+
 
     // The default value of f_size_grid.
     static const unsigned int S_SIZE_GRID_DEFAULT = 9;
@@ -40,10 +122,10 @@ private:
     static const unsigned int S_HEIGHT_BOX_DEFAULT = 3;
 
     // The maximum value of f_width_box.
-    static const unsigned int S_WIDTH_BOX_MAX = 7;
+    static const unsigned int S_WIDTH_BOX_MAX = 11;
 
     // The maximum value of f_height_box.
-    static const unsigned int S_HEIGHT_BOX_MAX = 7;
+    static const unsigned int S_HEIGHT_BOX_MAX = 11;
 
     // The value used for empty cells in the grid.
     static const unsigned int S_VALUE_EMPTY_CELL = 0;
@@ -53,6 +135,12 @@ public:
 
     SudokuBoard();
 
+    /*
+    * Creates the board from the first puzzle of the file p_file (in either of the formats of PuzzleReader); the
+      dimensions of the boxes are those of the puzzle.
+    * Throws std::runtime_error, whose message names the file and describes the problem (with its line and column),
+      if the file can't be opened or doesn't begin with a well-formed puzzle.
+    */
     SudokuBoard(const char* p_file);
 
     SudokuBoard(unsigned int p_width_box, unsigned int p_height_box);
@@ -60,12 +148,172 @@ public:
     SudokuBoard(unsigned int p_width_box, unsigned int p_height_box, const char* p_file);
 
 
+    /*
+    * Tries to fill all of the empty cells of the board; returns whether or not this was possible. Equivalent to
+      TrySolve() == Result::Solved.
+    */
     bool Solve();
 
+    /*
+    * Solves the board within its budget (see GetBudget), returning whether it was solved, found to have no solution,
+      or stopped by the budget; in the latter two cases the grid is unchanged.
+    */
+    Result TrySolve();
+
+    /*
+    * Counts the solutions of the board, stopping once p_max_solutions have been found (0 for no limit); e.g. a limit
+      of 2 is enough to tell whether the solution is unique. If there's a solution, the board is left holding the
+      first one (the one Solve would find); otherwise it's unchanged.
+    * Returns 0 if the board has no solution or its pre-filled cells violate the rules of sudoku.
+    * The search uses the engine and settings of Solve, but always runs on one thread.
+    */
+    unsigned long long CountSolutions(unsigned long long p_max_solutions = 0);
+
+    /*
+    * Returns whether or not the board has exactly one solution, which it's then left holding.
+    */
+    bool HasUniqueSolution();
+
+    /*
+    * Calls p_visit with the board holding each of its solutions in turn (in the order of CountSolutions), until
+      p_visit returns false or there are no more; the solutions aren't stored, so there can be any number of them.
+    * Returns the number of solutions visited. The board is left holding the last of them (or unchanged if there were
+      none).
+    */
+    unsigned long long EnumerateSolutions(const std::function<bool(const SudokuBoard&)>& p_visit);
+
+    /*
+    * Sets the engine used by Solve; the default is BackTracking.
+    */
+    void SetEngine(Engine p_engine);
+
+    /*
+    * Sets the rule used by the BackTracking engine to choose which empty cell to branch on, and how ties between cells are broken.
+    */
+    void SetBranching(SudokuSolver::Branching p_branching, 
+                      SudokuSolver::TieBreak p_tie_break = SudokuSolver::TieBreak::LowestIndex);
+
+    /*
+    * Sets the logical techniques (a combination of SudokuSolver's S_ flags) that the BackTracking engine applies
+      before its search and, if p_at_every_node is true, at every step of it.
+    */
+    void SetPropagation(unsigned int p_techniques, bool p_at_every_node = true);
+
+    /*
+    * Sets whether or not the BackTracking engine makes its choices (of the cell among ties, and of the order of the
+      values) at random, from a generator seeded with p_seed at the start of each search (see
+      SudokuSolver::SetRandomization), and the rule by which it restarts its search with a growing node limit (see
+      SudokuSolver::SetRestarts). Restarts apply to Solve on one thread.
+    */
+    void SetRandomization(bool p_is_random, unsigned long long p_seed = 0);
+    void SetRestarts(SudokuSolver::Restarts p_restarts,
+                     unsigned long long p_nodes_first_run = SudokuSolver::S_NODES_FIRST_RUN);
+
+    /*
+    * Sets the number of threads used by the BackTracking engine to search for a solution (0 for one per hardware
+      thread); the default is 1. The threads are created here and reused by every call to Solve; there are none if
+      the number comes to 1.
+    */
+    void SetNumThreads(unsigned int p_num_threads);
+
+    /*
+    * Sets the strategies that Solve races against each other, each on its own thread, taking the answer of whichever
+      finishes first (see PortfolioSolver); an empty vector, the default, turns the portfolio off. The portfolio
+      takes the place of the engine and of the threads set by SetNumThreads; its threads are created by the first
+      call to Solve. The strategy that answered is named by GetStats. CountSolutions and EnumerateSolutions still use
+      the engine.
+    */
+    void SetPortfolio(const std::vector<PortfolioSolver::Strategy>& p_strategies);
+
+    /*
+    * Sets whether or not Solve, CountSolutions and EnumerateSolutions time their validate and solve phases (see
+      GetStats); off by default, as it reads the clock a few times per call.
+    */
+    void SetTiming(bool p_is_timing);
+
+    /*
+    * Sets whether or not the conflicts of the grid are tracked incrementally; off by default.
+    * With tracking on, SetValue and PlaceValue (including clearing a cell by setting it to 0) update the conflicts in
+      O(1), or O(N) for an N by N grid when a value starts or stops being duplicated in a unit, and IsValid, IsSolved
+      and GetConflicts answer in O(1). Without it, each of the latter checks the whole grid, in O(N^2). Tracking suits
+      interactive use, where one cell changes between checks; it only slows down bulk loads such as reading puzzles.
+    */
+    void SetTracking(bool p_is_tracking);
+
+    /*
+    * Returns the budget of the searches of Solve, TrySolve, CountSolutions and EnumerateSolutions, so that its limits
+      can be set: a time limit, a greatest number of nodes and a flag that cancels the search (see SearchBudget). It's
+      started by each search, and afterwards tells which limit (if any) stopped it.
+    * A search that's stopped by the budget gives up: Solve returns false and TrySolve Result::OutOfBudget, while
+      CountSolutions and EnumerateSolutions return the solutions visited before it ran out. Without limits (the
+      default), the searches aren't metered at all.
+    */
+    SearchBudget& GetBudget();
+
+    /*
+    * Copies the settings used by Solve (the engine, branching, propagation, randomization, restarts, portfolio, timing
+      and the limits of the budget) from p_other, but not its grid or its number of threads.
+    */
+    void CopySettings(const SudokuBoard& p_other);
+
+    /*
+    * Returns the statistics of the last call to Solve, CountSolutions or EnumerateSolutions: the counters of the
+      engine's search and, if timing is on, the times of the validate and solve phases (the latter including the time
+      spent in EnumerateSolutions' p_visit). Each call clears the counters and sets both times.
+    * The parse and print phases happen outside the board, so they're left for the caller to record; the board never
+      changes them.
+    */
+    SolverStats& GetStats();
+    const SolverStats& GetStats() const;
+
     void EmptyBoard();
 
     /*
-    * Returns whether or not the board adheres to the rules of sudoku.
+    * Changes the dimensions of the boxes (and therefore of the grid). If they differ from the current dimensions, the
+      grid is resized and emptied.
+    * Returns false, leaving the board unchanged, if either dimension is 0 or exceeds its maximum.
+    */
+    bool SetDimensions(unsigned int p_width_box, unsigned int p_height_box);
+
+    /*
+    * Returns whether or not boxes of p_width_box by p_height_box cells are supported, i.e. neither dimension is 0 or
+      exceeds its maximum.
+    */
+    static bool AreDimensionsSupported(unsigned int p_width_box, unsigned int p_height_box);
+
+    unsigned int GetWidthBox() const;
+
+    unsigned int GetHeightBox() const;
+
+    unsigned int GetSizeGrid() const;
+
+    /*
+    * Returns the cells of the grid, e.g. to read them in bulk without the checks of GetValue.
+    */
+    const CompactGrid& GetGrid() const;
+
+    /*
+    * Copies the grid and the dimensions of the boxes into p_snapshot, reusing its storage. Copying the grid is a single
+      memcpy, so a snapshot is a cheap way to hand a puzzle to another board or to keep it for undoing later changes.
+    */
+    void TakeSnapshot(Snapshot& p_snapshot) const;
+
+    /*
+    * Replaces the grid and the dimensions of the boxes with those of p_snapshot (see TakeSnapshot).
+    */
+    void RestoreSnapshot(const Snapshot& p_snapshot);
+
+    /*
+    * Returns/sets the value at row p_row and column p_col (S_VALUE_EMPTY_CELL, i.e. 0, if the cell is empty).
+    * Unlike PlaceValue, SetValue doesn't check the value against the rules of sudoku.
+    * Both throw std::range_error if the cell is outside of the grid (see CompactGrid).
+    */
+    unsigned int GetValue(unsigned int p_row, unsigned int p_col) const;
+    void SetValue(unsigned int p_row, unsigned int p_col, unsigned int p_value);
+
+    /*
+    * Returns whether or not the board adheres to the rules of sudoku, i.e. no value is repeated within a row, column
+      or box, and none is greater than the size of the grid.
     */
     bool IsValid();
 
@@ -74,6 +322,13 @@ public:
     */
     bool IsSolved();
 
+    /*
+    * Returns the indices (row * size of the grid + column) of the cells that break the rules of sudoku, in no
+      particular order; every cell holding a repeated value is included, not just the later ones. The vector is valid
+      until the board is next changed.
+    */
+    const std::vector<unsigned int>& GetConflicts();
+
     /*
     * Places the value p_value at the position defined by p_row and p_col and returns whether or not it's a valid 
       placement.
@@ -81,30 +336,44 @@ public:
     bool PlaceValue(int p_value, int p_row, int p_col, bool l_if_wrong_remove = false);
 
 
+    /*
+    * Reads one puzzle (in either of the formats of PuzzleReader) into p_board. The stream is read one line at a time,
+      up to the last line of the puzzle, so several puzzles can be read from it in turn; a PuzzleReader of the stream
+      reads them faster.
+    * If the input is malformed, the failbit of p_istream is set and p_board is left unchanged.
+    */
     friend std::istream& operator>>(std::istream& p_istream, SudokuBoard& p_board);
 
-    friend std::ostream& operator<<(std::ostream& p_ostream, SudokuBoard& p_board);
+    friend std::ostream& operator<<(std::ostream& p_ostream, const SudokuBoard& p_board);
 
 
 private:
 
-    /* Auxiliary of Solve
-    * This method tries to solve the sudoku using the backtracking technique.
-    * An assumption is that the sudoku is valid to begin with: i.e. the method assumes that none of the pre-filled 
-      cells violate the rules of sudoku.
+    /* Auxiliary of Solve, VisitSolutions
+    * Returns whether or not the BackTracking engine's specialisation for the current box dimensions can be used in
+      place of f_solver (on one thread), (re)creating f_solver_fixed if the dimensions have changed.
     */
-    bool Solve_BackTracking();
+    bool UseFixedSizeSolver();
 
-    /* Auxiliary of IsValid, IsSolved, PlaceValue
-    * This method returns whether or not the cell adheres to the rules of sudoku. 
+    /* Auxiliary of CountSolutions, EnumerateSolutions
+    * Searches for every solution of the grid with the engine used by Solve (on one thread), calling p_visit at each
+      one after copying it into f_grid if it's one of the first p_num_stored; stops early if p_visit returns false.
+    * Returns the number of solutions visited.
+    */
+    unsigned long long VisitSolutions(unsigned long long p_num_stored, const std::function<bool()>& p_visit);
+
+    /* Auxiliary of SudokuBoard(const char*), SudokuBoard(unsigned int, unsigned int, const char*)
+    * Reads the first puzzle of the file p_file into the board, throwing std::runtime_error if it can't.
     */
-    bool IsCellValid(int p_row, int p_col);
+    void ReadFile(const char* p_file);
 
-    /* Auxiliary of Solve_BackTracking
-    * Assigns to p_row and p_col the values which correspond to the location of the 'earliest' empty cell of f_grid. In 
-      this context, the 'earliest' empty cell is the one at the lowest column/vertical position of the lowest row.
-    * If an empty cell is assigned, true is returned; if an empty cell isn't assigned, meaning one couldn't be found,
-      false is returned.
+    /* Auxiliary of IsValid, IsSolved, GetConflicts
+    * Returns f_conflicts, rebuilding it first unless tracking is on and it's current.
+    */
+    ConflictTracker& GetTracker();
+
+    /* Auxiliary of PlaceValue
+    * This method returns whether or not the cell adheres to the rules of sudoku. 
     */
-    bool AssignNextEmptyCell(int& p_row, int& p_col);
+    bool IsCellValid(unsigned int p_row, unsigned int p_col);
 };
@@ -0,0 +1,1330 @@
+#include"SudokuSolver.h"
+
+#include<algorithm>
+
+
+SudokuSolverBase::SudokuSolverBase()
+    : f_branching(Branching::MostConstrained), f_tie_break(TieBreak::LowestIndex),
+      f_techniques(S_NAKED_SINGLES | S_HIDDEN_SINGLES), f_propagate_at_nodes(true), f_is_random(false), f_seed(0),
+      f_restarts(Restarts::None), f_nodes_first_run(S_NODES_FIRST_RUN)
+{
+}
+
+void SudokuSolverBase::SetBranching(Branching p_branching, TieBreak p_tie_break /*= TieBreak::LowestIndex*/)
+{
+    f_branching = p_branching;
+    f_tie_break = p_tie_break;
+}
+
+void SudokuSolverBase::SetPropagation(unsigned int p_techniques, bool p_at_every_node /*= true*/)
+{
+    f_techniques = p_techniques & S_PROPAGATE_ALL;
+    f_propagate_at_nodes = p_at_every_node;
+}
+
+void SudokuSolverBase::SetRandomization(bool p_is_random, unsigned long long p_seed /*= 0*/)
+{
+    f_is_random = p_is_random;
+    f_seed = p_seed;
+}
+
+void SudokuSolverBase::SetRestarts(Restarts p_restarts, unsigned long long p_nodes_first_run /*= S_NODES_FIRST_RUN*/)
+{
+    f_restarts = p_restarts;
+    f_nodes_first_run = std::max<unsigned long long>(p_nodes_first_run, 1);
+}
+
+void SudokuSolverBase::CopySettings(const SudokuSolverBase& p_other)
+{
+    SetBranching(p_other.f_branching, p_other.f_tie_break);
+    SetPropagation(p_other.f_techniques, p_other.f_propagate_at_nodes);
+    SetRandomization(p_other.f_is_random, p_other.f_seed);
+    SetRestarts(p_other.f_restarts, p_other.f_nodes_first_run);
+}
+
+bool SudokuSolverBase::HasDefaultSettings() const
+{
+    return f_branching == Branching::MostConstrained && f_tie_break == TieBreak::LowestIndex &&
+           f_techniques == (S_NAKED_SINGLES | S_HIDDEN_SINGLES) && f_propagate_at_nodes && !f_is_random &&
+           f_restarts == Restarts::None;
+}
+
+
+/* Auxiliary of BasicSudokuSolver::Solve
+
+* Notes:
+    (a). The sequence is made of blocks that each end with a new largest term: the block ending at index 2^k - 2
+         repeats the sequence up to the previous block's end twice, followed by 2^(k - 1). So the index is reduced to
+         the smallest complete block containing it, and then, while it's not that block's last term, to its position
+         in the repeated part.
+*/
+unsigned long long SudokuSolverBase::GetLuby(unsigned long long p_index)
+{
+    // (a).
+    unsigned long long l_size = 1;
+    unsigned int l_power = 0;
+
+    while (l_size < p_index + 1)
+    {
+        l_size = 2 * l_size + 1;
+        ++l_power;
+    }
+
+    while (l_size - 1 != p_index)
+    {
+        l_size = (l_size - 1) / 2;
+        --l_power;
+        p_index %= l_size;
+    }
+
+    return 1ULL << l_power;
+}
+
+
+template <typename M>
+BasicSudokuSolver<M>::BasicSudokuSolver()
+    : f_width_box(0), f_height_box(0), f_size_grid(0), f_num_cells(0), f_mask_all(0), f_num_peers(0),
+      f_splitter(nullptr), f_cancel(nullptr), f_visit(nullptr), f_num_empty(0), f_stats(), f_random(0),
+      f_num_nodes_left_run(~0ULL), f_track_buckets(false)
+{
+}
+
+/*
+* Notes:
+    (a). The vectors are only resized when the dimensions change, so loading a grid of the same size as the previous
+         one doesn't allocate.
+    (b). The boxes of each row of boxes are numbered left to right; there are f_height_box boxes per row of boxes
+         (f_size_grid / f_width_box), and f_width_box rows of boxes.
+    (c). A pre-filled value conflicts with another if its digit is already used in its row, column or box.
+    (d). The placements of the pre-filled cells aren't counted as the search's.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::Load(const CompactGrid& p_grid, unsigned int p_width_box, unsigned int p_height_box)
+{
+    // (a).
+    if (p_width_box != f_width_box || p_height_box != f_height_box)
+    {
+        f_width_box = p_width_box;
+        f_height_box = p_height_box;
+        f_size_grid = f_width_box * f_height_box;
+        f_num_cells = f_size_grid * f_size_grid;
+
+        f_cells.resize(f_num_cells);
+        f_box_of_cell.resize(f_num_cells);
+        f_used_rows.resize(f_size_grid);
+        f_used_cols.resize(f_size_grid);
+        f_used_boxes.resize(f_size_grid);
+        f_num_candidates.resize(f_num_cells);
+        f_num_empty_peers.resize(f_num_cells);
+        f_bucket_next.resize(f_num_cells + f_size_grid + 1);
+        f_bucket_prev.resize(f_num_cells + f_size_grid + 1);
+        f_eliminated.resize(f_num_cells);
+        f_segments_row.resize(f_size_grid * f_height_box);
+        f_segments_col.resize(f_size_grid * f_width_box);
+
+        f_mask_all = ~Mask(0) >> (S_NUM_DIGITS_MAX - f_size_grid);
+
+        // (b).
+        for (unsigned int row = 0; row < f_size_grid; ++row)
+        {
+            for (unsigned int col = 0; col < f_size_grid; ++col)
+            {
+                f_box_of_cell[row * f_size_grid + col] = (row / f_height_box) * f_height_box + col / f_width_box;
+            }
+
+        }
+
+        BuildPeers();
+    }
+
+    for (unsigned int i = 0; i < f_size_grid; ++i)
+    {
+        f_used_rows[i] = f_used_cols[i] = f_used_boxes[i] = 0;
+    }
+
+    // The buckets are built by Solve, once all of the pre-filled cells have been placed.
+    f_track_buckets = false;
+    f_num_empty = f_num_cells;
+
+    for (unsigned int row = 0; row < f_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < f_size_grid; ++col)
+        {
+            unsigned int l_cell = row * f_size_grid + col;
+            unsigned int l_value = p_grid[l_cell];
+
+            f_cells[l_cell] = S_VALUE_EMPTY_CELL;
+            f_eliminated[l_cell] = 0;
+
+            if (l_value == S_VALUE_EMPTY_CELL)
+            { continue; }
+
+            if (l_value > f_size_grid)
+            { return false; }
+
+            // (c).
+            if (GetCandidates(l_cell) & (Mask(1) << (l_value - 1)))
+            { Assign(l_cell, l_value); }
+            else
+            { return false; }
+        }
+
+    }
+
+    // The pre-filled cells are never undone.
+    f_trail.clear();
+
+    // (d).
+    ClearStats();
+
+    return true;
+}
+
+template <typename M>
+void BasicSudokuSolver<M>::Store(CompactGrid& p_grid) const
+{
+    for (unsigned int row = 0; row < f_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < f_size_grid; ++col)
+        {
+            p_grid.Set(row, col, f_cells[row * f_size_grid + col]);
+        }
+
+    }
+
+}
+
+/*
+* Notes:
+    (a). Each run searches from the state after BeginSearch, to which SearchFrom returns the solver if the run fails.
+    (b). A run that fails before reaching its limit has searched the whole tree (or run out of budget), so there's no
+         point in another.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::Solve()
+{
+    if (!BeginSearch())
+    { return false; }
+
+    if (f_restarts == Restarts::None)
+    { return SearchFrom(std::vector<Decision>()); }
+
+    unsigned long long l_nodes_run = f_nodes_first_run;
+
+    for (unsigned long long l_run = 0; ; ++l_run)
+    {
+        // (a).
+        f_num_nodes_left_run = f_restarts == Restarts::Luby ? f_nodes_first_run * GetLuby(l_run) : l_nodes_run;
+
+        if (SearchFrom(std::vector<Decision>()))
+        { return true; }
+
+        // (b).
+        if (f_num_nodes_left_run != 0)
+        { return false; }
+
+        SUDOKU_STAT(++f_stats.restarts);
+
+        l_nodes_run += (l_nodes_run + 1) / 2;
+    }
+
+}
+
+/*
+* Notes:
+    (a). If propagation is applied at every step of the search, Solve_BackTracking applies it before choosing its
+         first cell.
+    (b). The generator is reseeded so that each search makes the same choices for the same grid; the seed is mixed
+         first by the generator itself, so nearby seeds give unrelated choices.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::BeginSearch()
+{
+    // (b).
+    f_random = f_seed;
+    f_random = NextRandom();
+
+    f_num_nodes_left_run = ~0ULL;
+
+    if (f_branching == Branching::MostConstrained)
+    { BuildBuckets(); }
+    else
+    { f_track_buckets = false; }
+
+    // (a).
+    return f_propagate_at_nodes || Propagate();
+}
+
+/*
+* Notes:
+    (a). The vectors that grow during the search are reserved at their maximum sizes, so that the search never
+         allocates: there's at most a frame and a decision per cell and, on the trail, an assignment per cell plus an
+         elimination per candidate of each cell (as each elimination removes at least one candidate, which is only
+         returned when the entry is undone). This is done here rather than in Load as a copy of the solver (see
+         ParallelSolver) doesn't inherit the capacity of the original's vectors; once reserved, it's a no-op.
+    (b). Each decision is replayed as Solve_BackTracking would have made it: propagating (if it's done at every step)
+         and then placing the value.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::SearchFrom(const std::vector<Decision>& p_path)
+{
+    // (a).
+    f_trail.reserve(f_num_cells * (f_size_grid + 1));
+    f_stack.reserve(f_num_cells);
+    f_path.reserve(f_num_cells);
+
+    std::size_t l_size_trail = f_trail.size();
+
+    if (f_splitter != nullptr)
+    { f_path = p_path; }
+
+    // (b).
+    bool l_is_consistent = true;
+
+    for (std::size_t i = 0; i < p_path.size() && l_is_consistent; ++i)
+    {
+        const Decision& l_decision = p_path[i];
+
+        l_is_consistent = (!f_propagate_at_nodes || Propagate()) &&
+                          (GetCandidates(l_decision.cell) & (Mask(1) << (l_decision.value - 1))) != 0;
+
+        if (l_is_consistent)
+        { Assign(l_decision.cell, l_decision.value); }
+    }
+
+    if (l_is_consistent && Solve_BackTracking())
+    { return true; }
+
+    UndoTo(l_size_trail);
+
+    return false;
+}
+
+/*
+* Notes:
+    (a). Solve_BackTracking calls f_visit at each solution; the solutions are counted here, on the way through.
+*/
+template <typename M>
+unsigned long long BasicSudokuSolver<M>::Enumerate(const std::function<bool()>& p_visit)
+{
+    unsigned long long l_num_solutions = 0;
+
+    // (a).
+    std::function<bool()> l_visit = [&]()
+    {
+        ++l_num_solutions;
+        return p_visit();
+    };
+
+    f_visit = &l_visit;
+
+    if (BeginSearch())
+    { SearchFrom(std::vector<Decision>()); }
+
+    f_visit = nullptr;
+
+    return l_num_solutions;
+}
+
+template <typename M>
+void BasicSudokuSolver<M>::SetSplitter(Splitter* p_splitter)
+{
+    f_splitter = p_splitter;
+}
+
+template <typename M>
+void BasicSudokuSolver<M>::SetCancelFlag(const std::atomic<bool>* p_cancel)
+{
+    f_cancel = p_cancel;
+}
+
+template <typename M>
+void BasicSudokuSolver<M>::SetBudget(SearchBudget* p_budget)
+{
+    f_meter.Start(p_budget);
+}
+
+template <typename M>
+typename BasicSudokuSolver<M>::Mask BasicSudokuSolver<M>::GetCandidates(unsigned int p_cell) const
+{
+    unsigned int l_row = p_cell / f_size_grid;
+    unsigned int l_col = p_cell % f_size_grid;
+
+    return f_mask_all & ~(f_used_rows[l_row] | f_used_cols[l_col] | f_used_boxes[f_box_of_cell[p_cell]] |
+                          f_eliminated[p_cell]);
+}
+
+template <typename M>
+const SolverStats& BasicSudokuSolver<M>::GetStats() const
+{
+    return f_stats;
+}
+
+template <typename M>
+void BasicSudokuSolver<M>::ClearStats()
+{
+    f_stats.ClearSearch();
+}
+
+
+/* Auxiliary of Solve
+
+* Notes:
+    (a). Each frame of f_stack is a node of the search tree whose cell is being branched on; the frame's candidates
+         are those that are yet to be tried. A node is 'entered' after a value is placed (or, for the root, at the
+         start); if it's not a dead end, a frame is pushed for it. The frames' trail sizes bound the stack's changes,
+         so no further state is needed to backtrack.
+    (b). Any values placed (or candidates eliminated) by propagation are undone when the search backtracks past the
+         node, as they're on the trail above the parent frame's trail size.
+    (c). The next empty cell in row-major order is searched for from the cell after the parent's; all of the cells
+         before it are filled.
+    (d). If the splitter wants work at this depth, all of the cell's candidates except the first are handed to it
+         rather than being explored here.
+    (e). Undo the value that was placed at the top frame's cell (along with everything that followed from it) before
+         trying the next one. Note that it's not necessarily the case that the sudoku cannot be solved with that value
+         at the cell, rather that this cannot occur on the current 'branch' of the search.
+    (f). Only the values that don't conflict with the cell's row, column or box (and haven't been eliminated) are
+         tried, in ascending order (or, if the search is randomized, in a random order). Taking the lowest set bit of
+         the candidate mask and then clearing it iterates over them.
+    (g). The decisions of the frames follow those that SearchFrom replayed; f_path is only shortened here, and it has
+         room for a decision per cell, so it's never reallocated.
+    (h). If the root frame has run out of candidates, the (replayed) grid cannot be solved (or, when enumerating, has
+         no more solutions).
+    (i). When enumerating, the search carries on past a solution (unless told to stop) by backtracking from it as if
+         it were a dead end.
+    (j). The depth of a node is the number of decisions on its path: those that SearchFrom replayed, and one per frame.
+         A branching cell without any candidates (which propagation would have caught) is also a dead end.
+    (k). A run of a search with restarts gives up once it has used up its nodes (see Solve); the count is left at 0 to
+         tell Solve so.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::Solve_BackTracking()
+{
+    std::size_t l_size_path = f_path.size();
+
+    // (a).
+    f_stack.clear();
+
+    bool l_is_entering = true;
+
+    for (;;)
+    {
+        if (l_is_entering)
+        {
+            l_is_entering = false;
+
+            // Give up if the search has been cancelled or has run out of budget (k).
+            if (f_num_nodes_left_run == 0 || (f_cancel != nullptr && f_cancel->load(std::memory_order_relaxed)) ||
+                !f_meter.Tick())
+            { return false; }
+
+            --f_num_nodes_left_run;
+
+            // (j).
+            SUDOKU_STAT(++f_stats.nodes);
+            SUDOKU_STAT(f_stats.max_depth = std::max<unsigned long long>(f_stats.max_depth,
+                                                                          l_size_path + f_stack.size()));
+
+            // (b).
+            if (f_propagate_at_nodes && !Propagate())
+            {
+                SUDOKU_STAT(++f_stats.backtracks);
+            }
+            else
+            {
+                // (c).
+                unsigned int l_cell = f_stack.empty() ? 0 : f_stack.back().cell + 1;
+
+                // Get the cell to branch on; if a cell cannot be assigned, this means all cells are filled, which would imply that the sudoku is solved.
+                if (f_track_buckets ? !AssignMostConstrainedCell(l_cell) : !AssignNextEmptyCell(l_cell))
+                {
+                    // (i).
+                    if (f_visit == nullptr || !(*f_visit)())
+                    { return true; }
+
+                    continue;
+                }
+
+                Mask l_candidates = GetCandidates(l_cell);
+
+                SUDOKU_STAT(f_stats.backtracks += l_candidates == 0);
+
+                // (d).
+                if (f_splitter != nullptr && CountBits(l_candidates) > 1 && f_splitter->IsWanted(f_path.size()))
+                {
+                    for (Mask l_others = l_candidates & (l_candidates - 1); l_others != 0; l_others &= l_others - 1)
+                    {
+                        f_path.push_back(Decision{ l_cell, IndexLowestBit(l_others) + 1 });
+                        f_splitter->Donate(f_path);
+                        f_path.pop_back();
+                    }
+
+                    l_candidates &= ~(l_candidates & (l_candidates - 1));
+                }
+
+                f_stack.push_back(Frame{ l_cell, l_candidates, f_trail.size() });
+            }
+
+        }
+
+        // (h).
+        if (f_stack.empty())
+        { return false; }
+
+        Frame& l_frame = f_stack.back();
+
+        // (e).
+        UndoTo(l_frame.size_trail);
+
+        if (l_frame.candidates == 0)
+        {
+            f_stack.pop_back();
+            continue;
+        }
+
+        // (f).
+        Mask l_bit = f_is_random ? PickRandomBit(l_frame.candidates) : l_frame.candidates & (~l_frame.candidates + 1);
+        unsigned int l_value = IndexLowestBit(l_bit) + 1;
+        l_frame.candidates &= ~l_bit;
+
+        Assign(l_frame.cell, l_value);
+
+        // (g).
+        if (f_splitter != nullptr)
+        {
+            f_path.resize(l_size_path + f_stack.size() - 1);
+            f_path.push_back(Decision{ l_frame.cell, l_value });
+        }
+
+        l_is_entering = true;
+    }
+
+}
+
+/*
+* Notes:
+    (a). When the buckets are being maintained, the candidate counts of the cell's empty peers must be updated. A peer
+         loses a candidate only if p_value was one of its candidates, so this is checked before the masks are updated.
+    (b). The number of empty peers is updated for every peer (not just the empty ones) so that it's still correct for
+         a cell that's later emptied again.
+*/
+template <typename M>
+void BasicSudokuSolver<M>::Assign(unsigned int p_cell, unsigned int p_value)
+{
+    Mask l_bit = Mask(1) << (p_value - 1);
+
+    // (a).
+    if (f_track_buckets)
+    {
+        RemoveFromBucket(p_cell);
+
+        const unsigned int* l_peers = &f_peers[p_cell * f_num_peers];
+
+        for (unsigned int i = 0; i < f_num_peers; ++i)
+        {
+            unsigned int l_peer = l_peers[i];
+
+            // (b).
+            --f_num_empty_peers[l_peer];
+
+            if (f_cells[l_peer] != S_VALUE_EMPTY_CELL || !(GetCandidates(l_peer) & l_bit))
+            { continue; }
+
+            RemoveFromBucket(l_peer);
+            --f_num_candidates[l_peer];
+            InsertIntoBucket(l_peer);
+        }
+
+    }
+
+    f_cells[p_cell] = p_value;
+    --f_num_empty;
+
+    SUDOKU_STAT(++f_stats.placements);
+
+    f_trail.push_back(TrailEntry{ p_cell, 0 });
+
+    f_used_rows[p_cell / f_size_grid] |= l_bit;
+    f_used_cols[p_cell % f_size_grid] |= l_bit;
+    f_used_boxes[f_box_of_cell[p_cell]] |= l_bit;
+}
+
+/*
+* Notes:
+    (a). This is the reverse of Assign (a) and (b): as the masks have already been updated, a peer regains a
+         candidate if p_value is now one of its candidates.
+*/
+template <typename M>
+void BasicSudokuSolver<M>::Unassign(unsigned int p_cell)
+{
+    Mask l_bit = Mask(1) << (f_cells[p_cell] - 1);
+
+    f_cells[p_cell] = S_VALUE_EMPTY_CELL;
+    ++f_num_empty;
+
+    f_used_rows[p_cell / f_size_grid] &= ~l_bit;
+    f_used_cols[p_cell % f_size_grid] &= ~l_bit;
+    f_used_boxes[f_box_of_cell[p_cell]] &= ~l_bit;
+
+    // (a).
+    if (f_track_buckets)
+    {
+        const unsigned int* l_peers = &f_peers[p_cell * f_num_peers];
+
+        for (unsigned int i = 0; i < f_num_peers; ++i)
+        {
+            unsigned int l_peer = l_peers[i];
+
+            ++f_num_empty_peers[l_peer];
+
+            if (f_cells[l_peer] != S_VALUE_EMPTY_CELL || !(GetCandidates(l_peer) & l_bit))
+            { continue; }
+
+            RemoveFromBucket(l_peer);
+            ++f_num_candidates[l_peer];
+            InsertIntoBucket(l_peer);
+        }
+
+        f_num_candidates[p_cell] = CountBits(GetCandidates(p_cell));
+        InsertIntoBucket(p_cell);
+    }
+
+}
+
+/*
+* Notes:
+    (a). Only the digits that are currently candidates are eliminated, so that Restore returns exactly those digits.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::Eliminate(unsigned int p_cell, Mask p_mask, unsigned int p_technique)
+{
+    Mask l_candidates = GetCandidates(p_cell);
+
+    // (a).
+    p_mask &= l_candidates;
+
+    if (p_mask == 0)
+    { return true; }
+
+    SUDOKU_STAT(f_stats.deductions[IndexLowestBit(p_technique)] += CountBits(p_mask));
+
+    f_eliminated[p_cell] |= p_mask;
+
+    if (f_track_buckets)
+    {
+        RemoveFromBucket(p_cell);
+        f_num_candidates[p_cell] -= CountBits(p_mask);
+        InsertIntoBucket(p_cell);
+    }
+
+    f_trail.push_back(TrailEntry{ p_cell, p_mask });
+
+    return l_candidates != p_mask;
+}
+
+template <typename M>
+void BasicSudokuSolver<M>::Restore(unsigned int p_cell, Mask p_mask)
+{
+    f_eliminated[p_cell] &= ~p_mask;
+
+    if (f_track_buckets)
+    {
+        RemoveFromBucket(p_cell);
+        f_num_candidates[p_cell] += CountBits(p_mask);
+        InsertIntoBucket(p_cell);
+    }
+
+}
+
+template <typename M>
+void BasicSudokuSolver<M>::UndoTo(std::size_t p_size)
+{
+    while (f_trail.size() > p_size)
+    {
+        const TrailEntry& l_entry = f_trail.back();
+
+        if (l_entry.eliminated == 0)
+        { Unassign(l_entry.cell); }
+        else
+        { Restore(l_entry.cell, l_entry.eliminated); }
+
+        f_trail.pop_back();
+    }
+
+}
+
+/*
+* Notes:
+    (a). The techniques are ordered from the cheapest to the most expensive; after any progress, the cheaper ones are
+         applied again before an expensive one is tried.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::Propagate()
+{
+    bool l_changed;
+
+    do
+    {
+        l_changed = false;
+
+        // (a).
+        if ((f_techniques & S_NAKED_SINGLES) && !ApplyNakedSingles(l_changed))
+        { return false; }
+
+        if (!l_changed && (f_techniques & S_HIDDEN_SINGLES) && !ApplyHiddenSingles(l_changed))
+        { return false; }
+
+        if (!l_changed && (f_techniques & S_LOCKED_CANDIDATES) && !ApplyLockedCandidates(l_changed))
+        { return false; }
+
+        if (!l_changed && (f_techniques & S_NAKED_PAIRS) && !ApplyNakedPairs(l_changed))
+        { return false; }
+
+        if (!l_changed && (f_techniques & S_HIDDEN_PAIRS) && !ApplyHiddenPairs(l_changed))
+        { return false; }
+    }
+    while (l_changed);
+
+    return true;
+}
+
+/*
+* Notes:
+    (a). When the buckets are maintained, the cells with zero or one candidates are exactly those in the first two
+         buckets, so the grid doesn't need to be scanned.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::ApplyNakedSingles(bool& p_changed)
+{
+    // (a).
+    if (f_track_buckets)
+    {
+        unsigned int l_head_0 = f_num_cells;
+        unsigned int l_head_1 = f_num_cells + 1;
+
+        while (f_bucket_next[l_head_0] == l_head_0 && f_bucket_next[l_head_1] != l_head_1)
+        {
+            unsigned int l_cell = f_bucket_next[l_head_1];
+
+            Assign(l_cell, IndexLowestBit(GetCandidates(l_cell)) + 1);
+            p_changed = true;
+
+            SUDOKU_STAT(++f_stats.deductions[IndexLowestBit(S_NAKED_SINGLES)]);
+        }
+
+        return f_bucket_next[l_head_0] == l_head_0;
+    }
+
+    for (unsigned int cell = 0; cell < f_num_cells; ++cell)
+    {
+        if (f_cells[cell] != S_VALUE_EMPTY_CELL)
+        { continue; }
+
+        Mask l_candidates = GetCandidates(cell);
+
+        if (l_candidates == 0)
+        { return false; }
+
+        if ((l_candidates & (l_candidates - 1)) == 0)
+        {
+            Assign(cell, IndexLowestBit(l_candidates) + 1);
+            p_changed = true;
+
+            SUDOKU_STAT(++f_stats.deductions[IndexLowestBit(S_NAKED_SINGLES)]);
+        }
+
+    }
+
+    return true;
+}
+
+/*
+* Notes:
+    (a). l_once is the set of digits that are candidates of at least one of the unit's empty cells, and l_twice those
+         that are candidates of at least two. The hidden singles are therefore in l_once but not l_twice.
+    (b). If a digit that isn't yet used in the unit isn't a candidate of any of its cells, it cannot be placed.
+    (c). If the digit's cell was filled by a previous hidden single of this unit, the digit can no longer be placed
+         in the unit.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::ApplyHiddenSingles(bool& p_changed)
+{
+    for (unsigned int unit = 0; unit < 3 * f_size_grid; ++unit)
+    {
+        const unsigned int* l_cells = &f_unit_cells[unit * f_size_grid];
+
+        // (a).
+        Mask l_once = 0;
+        Mask l_twice = 0;
+
+        for (unsigned int i = 0; i < f_size_grid; ++i)
+        {
+            if (f_cells[l_cells[i]] != S_VALUE_EMPTY_CELL)
+            { continue; }
+
+            Mask l_candidates = GetCandidates(l_cells[i]);
+
+            l_twice |= l_once & l_candidates;
+            l_once |= l_candidates;
+        }
+
+        Mask l_used = GetUsedInUnit(unit);
+
+        // (b).
+        if ((l_once | l_used) != f_mask_all)
+        { return false; }
+
+        for (Mask l_singles = l_once & ~l_twice; l_singles != 0; l_singles &= l_singles - 1)
+        {
+            Mask l_bit = l_singles & ~(l_singles - 1);
+
+            for (unsigned int i = 0; i < f_size_grid; ++i)
+            {
+                if (f_cells[l_cells[i]] != S_VALUE_EMPTY_CELL || !(GetCandidates(l_cells[i]) & l_bit))
+                { continue; }
+
+                Assign(l_cells[i], IndexLowestBit(l_bit) + 1);
+                p_changed = true;
+
+                SUDOKU_STAT(++f_stats.deductions[IndexLowestBit(S_HIDDEN_SINGLES)]);
+
+                l_bit = 0;
+                break;
+            }
+
+            // (c).
+            if (l_bit != 0)
+            { return false; }
+        }
+
+    }
+
+    return true;
+}
+
+/*
+* Notes:
+    (a). Calculate the segments: the segment of row r and box-column bc is at index r * f_height_box + bc (there are
+         f_height_box boxes across each row); the segment of column c and box-row br is at index c * f_width_box + br
+         (there are f_width_box boxes down each column).
+    (b). For the segment of row r in box b: l_rest_line is the union of the candidates of the rest of row r, and
+         l_rest_box that of the rest of box b. A digit in the segment that's not in l_rest_box must be placed in row r
+         (pointing); one that's not in l_rest_line must be placed in box b (claiming).
+    (c). The same as (b), but for the segment of column c in box b.
+    (d). The segments aren't updated as candidates are eliminated; as eliminating candidates can only make the
+         deductions stronger, using the (possibly outdated) unions is still sound.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::ApplyLockedCandidates(bool& p_changed)
+{
+    // (a).
+    for (unsigned int row = 0; row < f_size_grid; ++row)
+    {
+        for (unsigned int bc = 0; bc < f_height_box; ++bc)
+        {
+            Mask l_union = 0;
+
+            for (unsigned int col = bc * f_width_box; col < (bc + 1) * f_width_box; ++col)
+            {
+                unsigned int l_cell = row * f_size_grid + col;
+
+                if (f_cells[l_cell] == S_VALUE_EMPTY_CELL)
+                { l_union |= GetCandidates(l_cell); }
+            }
+
+            f_segments_row[row * f_height_box + bc] = l_union;
+        }
+
+    }
+
+    for (unsigned int col = 0; col < f_size_grid; ++col)
+    {
+        for (unsigned int br = 0; br < f_width_box; ++br)
+        {
+            Mask l_union = 0;
+
+            for (unsigned int row = br * f_height_box; row < (br + 1) * f_height_box; ++row)
+            {
+                unsigned int l_cell = row * f_size_grid + col;
+
+                if (f_cells[l_cell] == S_VALUE_EMPTY_CELL)
+                { l_union |= GetCandidates(l_cell); }
+            }
+
+            f_segments_col[col * f_width_box + br] = l_union;
+        }
+
+    }
+
+    // (b).
+    for (unsigned int row = 0; row < f_size_grid; ++row)
+    {
+        unsigned int l_row_min_band = row - row % f_height_box;
+
+        for (unsigned int bc = 0; bc < f_height_box; ++bc)
+        {
+            Mask l_segment = f_segments_row[row * f_height_box + bc];
+
+            if (l_segment == 0)
+            { continue; }
+
+            Mask l_rest_line = 0;
+            for (unsigned int i = 0; i < f_height_box; ++i)
+            {
+                if (i != bc)
+                { l_rest_line |= f_segments_row[row * f_height_box + i]; }
+            }
+
+            Mask l_rest_box = 0;
+            for (unsigned int r = l_row_min_band; r < l_row_min_band + f_height_box; ++r)
+            {
+                if (r != row)
+                { l_rest_box |= f_segments_row[r * f_height_box + bc]; }
+            }
+
+            Mask l_pointing = l_segment & ~l_rest_box & l_rest_line;
+            Mask l_claiming = l_segment & ~l_rest_line & l_rest_box;
+
+            for (unsigned int col = 0; col < f_size_grid && l_pointing != 0; ++col)
+            {
+                unsigned int l_cell = row * f_size_grid + col;
+
+                if (col / f_width_box == bc || f_cells[l_cell] != S_VALUE_EMPTY_CELL)
+                { continue; }
+
+                if (GetCandidates(l_cell) & l_pointing)
+                {
+                    p_changed = true;
+
+                    if (!Eliminate(l_cell, l_pointing, S_LOCKED_CANDIDATES))
+                    { return false; }
+                }
+
+            }
+
+            for (unsigned int r = l_row_min_band; r < l_row_min_band + f_height_box && l_claiming != 0; ++r)
+            {
+                if (r == row)
+                { continue; }
+
+                for (unsigned int col = bc * f_width_box; col < (bc + 1) * f_width_box; ++col)
+                {
+                    unsigned int l_cell = r * f_size_grid + col;
+
+                    if (f_cells[l_cell] != S_VALUE_EMPTY_CELL || !(GetCandidates(l_cell) & l_claiming))
+                    { continue; }
+
+                    p_changed = true;
+
+                    if (!Eliminate(l_cell, l_claiming, S_LOCKED_CANDIDATES))
+                    { return false; }
+                }
+
+            }
+
+        }
+
+    }
+
+    // (c).
+    for (unsigned int col = 0; col < f_size_grid; ++col)
+    {
+        unsigned int l_col_min_stack = col - col % f_width_box;
+
+        for (unsigned int br = 0; br < f_width_box; ++br)
+        {
+            Mask l_segment = f_segments_col[col * f_width_box + br];
+
+            if (l_segment == 0)
+            { continue; }
+
+            Mask l_rest_line = 0;
+            for (unsigned int i = 0; i < f_width_box; ++i)
+            {
+                if (i != br)
+                { l_rest_line |= f_segments_col[col * f_width_box + i]; }
+            }
+
+            Mask l_rest_box = 0;
+            for (unsigned int c = l_col_min_stack; c < l_col_min_stack + f_width_box; ++c)
+            {
+                if (c != col)
+                { l_rest_box |= f_segments_col[c * f_width_box + br]; }
+            }
+
+            Mask l_pointing = l_segment & ~l_rest_box & l_rest_line;
+            Mask l_claiming = l_segment & ~l_rest_line & l_rest_box;
+
+            for (unsigned int row = 0; row < f_size_grid && l_pointing != 0; ++row)
+            {
+                unsigned int l_cell = row * f_size_grid + col;
+
+                if (row / f_height_box == br || f_cells[l_cell] != S_VALUE_EMPTY_CELL)
+                { continue; }
+
+                if (GetCandidates(l_cell) & l_pointing)
+                {
+                    p_changed = true;
+
+                    if (!Eliminate(l_cell, l_pointing, S_LOCKED_CANDIDATES))
+                    { return false; }
+                }
+
+            }
+
+            for (unsigned int c = l_col_min_stack; c < l_col_min_stack + f_width_box && l_claiming != 0; ++c)
+            {
+                if (c == col)
+                { continue; }
+
+                for (unsigned int row = br * f_height_box; row < (br + 1) * f_height_box; ++row)
+                {
+                    unsigned int l_cell = row * f_size_grid + c;
+
+                    if (f_cells[l_cell] != S_VALUE_EMPTY_CELL || !(GetCandidates(l_cell) & l_claiming))
+                    { continue; }
+
+                    p_changed = true;
+
+                    if (!Eliminate(l_cell, l_claiming, S_LOCKED_CANDIDATES))
+                    { return false; }
+                }
+
+            }
+
+        }
+
+    }
+
+    return true;
+}
+
+template <typename M>
+bool BasicSudokuSolver<M>::ApplyNakedPairs(bool& p_changed)
+{
+    for (unsigned int unit = 0; unit < 3 * f_size_grid; ++unit)
+    {
+        const unsigned int* l_cells = &f_unit_cells[unit * f_size_grid];
+
+        for (unsigned int i = 0; i < f_size_grid; ++i)
+        {
+            if (f_cells[l_cells[i]] != S_VALUE_EMPTY_CELL)
+            { continue; }
+
+            Mask l_pair = GetCandidates(l_cells[i]);
+
+            if (CountBits(l_pair) != 2)
+            { continue; }
+
+            // Find another cell of the unit with the same two candidates.
+            unsigned int j = i + 1;
+            while (j < f_size_grid && (f_cells[l_cells[j]] != S_VALUE_EMPTY_CELL || GetCandidates(l_cells[j]) != l_pair))
+            { ++j; }
+
+            if (j == f_size_grid)
+            { continue; }
+
+            for (unsigned int k = 0; k < f_size_grid; ++k)
+            {
+                if (k == i || k == j || f_cells[l_cells[k]] != S_VALUE_EMPTY_CELL || !(GetCandidates(l_cells[k]) & l_pair))
+                { continue; }
+
+                p_changed = true;
+
+                if (!Eliminate(l_cells[k], l_pair, S_NAKED_PAIRS))
+                { return false; }
+            }
+
+        }
+
+    }
+
+    return true;
+}
+
+/*
+* Notes:
+    (a). l_positions[d] is the set of the unit's cells (bit i for the unit's i-th cell) that have the digit d + 1 as a
+         candidate. As f_size_grid is at most S_NUM_DIGITS_MAX, a Mask can hold these sets.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::ApplyHiddenPairs(bool& p_changed)
+{
+    Mask l_positions[S_NUM_DIGITS_MAX];
+
+    for (unsigned int unit = 0; unit < 3 * f_size_grid; ++unit)
+    {
+        const unsigned int* l_cells = &f_unit_cells[unit * f_size_grid];
+
+        // (a).
+        for (unsigned int d = 0; d < f_size_grid; ++d)
+        {
+            l_positions[d] = 0;
+        }
+
+        for (unsigned int i = 0; i < f_size_grid; ++i)
+        {
+            if (f_cells[l_cells[i]] != S_VALUE_EMPTY_CELL)
+            { continue; }
+
+            for (Mask l_candidates = GetCandidates(l_cells[i]); l_candidates != 0; l_candidates &= l_candidates - 1)
+            {
+                l_positions[IndexLowestBit(l_candidates)] |= Mask(1) << i;
+            }
+
+        }
+
+        for (unsigned int d1 = 0; d1 < f_size_grid; ++d1)
+        {
+            if (CountBits(l_positions[d1]) != 2)
+            { continue; }
+
+            for (unsigned int d2 = d1 + 1; d2 < f_size_grid; ++d2)
+            {
+                if (l_positions[d2] != l_positions[d1])
+                { continue; }
+
+                // The two cells may hold only the digits d1 + 1 and d2 + 1.
+                Mask l_others = f_mask_all & ~((Mask(1) << d1) | (Mask(1) << d2));
+
+                for (Mask l_cells_pair = l_positions[d1]; l_cells_pair != 0; l_cells_pair &= l_cells_pair - 1)
+                {
+                    unsigned int l_cell = l_cells[IndexLowestBit(l_cells_pair)];
+
+                    if (GetCandidates(l_cell) & l_others)
+                    {
+                        p_changed = true;
+
+                        if (!Eliminate(l_cell, l_others, S_HIDDEN_PAIRS))
+                        { return false; }
+                    }
+
+                }
+
+                break;
+            }
+
+        }
+
+    }
+
+    return true;
+}
+
+template <typename M>
+typename BasicSudokuSolver<M>::Mask BasicSudokuSolver<M>::GetUsedInUnit(unsigned int p_unit) const
+{
+    if (p_unit < f_size_grid)
+    { return f_used_rows[p_unit]; }
+
+    if (p_unit < 2 * f_size_grid)
+    { return f_used_cols[p_unit - f_size_grid]; }
+
+    return f_used_boxes[p_unit - 2 * f_size_grid];
+}
+
+template <typename M>
+bool BasicSudokuSolver<M>::AssignNextEmptyCell(unsigned int& p_cell) const
+{
+    for (; p_cell < f_num_cells; ++p_cell)
+    {
+        if (f_cells[p_cell] == S_VALUE_EMPTY_CELL)
+        { return true; }
+    }
+
+    return false;
+}
+
+/*
+* Notes:
+    (a). A cell with no candidates is returned straight away, as the current branch of the search is a dead end.
+    (b). Only the cells in the first non-empty bucket are considered, so the cost depends on the number of ties rather
+         than the size of the grid.
+    (c). A random tie-break keeps each of the tied cells with equal probability (reservoir sampling): the n-th cell
+         replaces the choice so far with a probability of 1/n.
+*/
+template <typename M>
+bool BasicSudokuSolver<M>::AssignMostConstrainedCell(unsigned int& p_cell)
+{
+    if (f_num_empty == 0)
+    { return false; }
+
+    for (unsigned int count = 0; count <= f_size_grid; ++count)
+    {
+        unsigned int l_head = f_num_cells + count;
+
+        p_cell = f_bucket_next[l_head];
+
+        if (p_cell == l_head)
+        { continue; }
+
+        // (a).
+        if (count == 0 || (f_tie_break == TieBreak::First && !f_is_random))
+        { return true; }
+
+        // (b).
+        unsigned int l_num_ties = 1;
+
+        for (unsigned int l_node = f_bucket_next[p_cell]; l_node != l_head; l_node = f_bucket_next[l_node])
+        {
+            // (c).
+            bool l_is_preferred = f_is_random ? NextRandom() % ++l_num_ties == 0 :
+                                  f_tie_break == TieBreak::LowestIndex ? l_node < p_cell :
+                                  f_num_empty_peers[l_node] > f_num_empty_peers[p_cell];
+
+            if (l_is_preferred)
+            { p_cell = l_node; }
+        }
+
+        return true;
+    }
+
+    // Every empty cell is in a bucket, so this point should never be reached.
+    return false;
+}
+
+/* Auxiliary of Solve_BackTracking, AssignMostConstrainedCell
+
+* Notes:
+    (a). SplitMix64: the state advances by a constant, and is then scrambled into the output; it's fast, and any
+         state (including 0) is a valid seed.
+*/
+template <typename M>
+unsigned long long BasicSudokuSolver<M>::NextRandom()
+{
+    // (a).
+    unsigned long long l_z = (f_random += 0x9E3779B97F4A7C15ULL);
+
+    l_z = (l_z ^ (l_z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    l_z = (l_z ^ (l_z >> 27)) * 0x94D049BB133111EBULL;
+
+    return l_z ^ (l_z >> 31);
+}
+
+/* Auxiliary of Solve_BackTracking
+*/
+template <typename M>
+typename BasicSudokuSolver<M>::Mask BasicSudokuSolver<M>::PickRandomBit(Mask p_mask)
+{
+    for (unsigned long long l_skip = NextRandom() % CountBits(p_mask); l_skip != 0; --l_skip)
+    {
+        p_mask &= p_mask - 1;
+    }
+
+    return p_mask & (~p_mask + 1);
+}
+
+/*
+* Notes:
+    (a). The peers in the cell's box that aren't in its row or column; the others were added by the previous loops.
+*/
+template <typename M>
+void BasicSudokuSolver<M>::BuildPeers()
+{
+    f_num_peers = 3 * f_size_grid - f_width_box - f_height_box - 1;
+    f_peers.resize(f_num_cells * f_num_peers);
+    f_unit_cells.resize(3 * f_num_cells);
+
+    for (unsigned int cell = 0; cell < f_num_cells; ++cell)
+    {
+        unsigned int l_row = cell / f_size_grid;
+        unsigned int l_col = cell % f_size_grid;
+        unsigned int l_box = f_box_of_cell[cell];
+
+        // The position of the cell within its box.
+        unsigned int l_index_in_box = (l_row % f_height_box) * f_width_box + l_col % f_width_box;
+
+        f_unit_cells[l_row * f_size_grid + l_col] = cell;
+        f_unit_cells[(f_size_grid + l_col) * f_size_grid + l_row] = cell;
+        f_unit_cells[(2 * f_size_grid + l_box) * f_size_grid + l_index_in_box] = cell;
+    }
+
+    for (unsigned int row = 0; row < f_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < f_size_grid; ++col)
+        {
+            unsigned int* l_peers = &f_peers[(row * f_size_grid + col) * f_num_peers];
+
+            for (unsigned int c = 0; c < f_size_grid; ++c)
+            {
+                if (c != col)
+                { *l_peers++ = row * f_size_grid + c; }
+            }
+
+            for (unsigned int r = 0; r < f_size_grid; ++r)
+            {
+                if (r != row)
+                { *l_peers++ = r * f_size_grid + col; }
+            }
+
+            unsigned int l_index_row_min = row - row % f_height_box;
+            unsigned int l_index_col_min = col - col % f_width_box;
+
+            // (a).
+            for (unsigned int r = l_index_row_min; r < l_index_row_min + f_height_box; ++r)
+            {
+                for (unsigned int c = l_index_col_min; c < l_index_col_min + f_width_box; ++c)
+                {
+                    if (r != row && c != col)
+                    { *l_peers++ = r * f_size_grid + c; }
+                }
+
+            }
+
+        }
+
+    }
+
+}
+
+template <typename M>
+void BasicSudokuSolver<M>::BuildBuckets()
+{
+    for (unsigned int l_head = f_num_cells; l_head <= f_num_cells + f_size_grid; ++l_head)
+    {
+        f_bucket_next[l_head] = f_bucket_prev[l_head] = l_head;
+    }
+
+    for (unsigned int cell = 0; cell < f_num_cells; ++cell)
+    {
+        const unsigned int* l_peers = &f_peers[cell * f_num_peers];
+
+        f_num_empty_peers[cell] = 0;
+
+        for (unsigned int i = 0; i < f_num_peers; ++i)
+        {
+            if (f_cells[l_peers[i]] == S_VALUE_EMPTY_CELL)
+            { ++f_num_empty_peers[cell]; }
+        }
+
+        if (f_cells[cell] != S_VALUE_EMPTY_CELL)
+        { continue; }
+
+        f_num_candidates[cell] = CountBits(GetCandidates(cell));
+        InsertIntoBucket(cell);
+    }
+
+    f_track_buckets = true;
+}
+
+template <typename M>
+void BasicSudokuSolver<M>::InsertIntoBucket(unsigned int p_cell)
+{
+    unsigned int l_head = f_num_cells + f_num_candidates[p_cell];
+
+    f_bucket_next[p_cell] = f_bucket_next[l_head];
+    f_bucket_prev[p_cell] = l_head;
+    f_bucket_prev[f_bucket_next[l_head]] = p_cell;
+    f_bucket_next[l_head] = p_cell;
+}
+
+template <typename M>
+void BasicSudokuSolver<M>::RemoveFromBucket(unsigned int p_cell)
+{
+    f_bucket_next[f_bucket_prev[p_cell]] = f_bucket_next[p_cell];
+    f_bucket_prev[f_bucket_next[p_cell]] = f_bucket_prev[p_cell];
+}
+
+
+template class BasicSudokuSolver<unsigned long long>;
+template class BasicSudokuSolver<WideMask<2>>;
@@ -0,0 +1,526 @@
+#pragma once
+
+#include<atomic>
+#include<functional>
+#include<vector>
+
+#include"CompactGrid.h"
+#include"BitUtils.h"
+#include"SearchBudget.h"
+#include"SolverStats.h"
+
+
+/*
+* The settings of the search of BasicSudokuSolver, and the types that don't depend on its masks; shared by every
+  instantiation, so that e.g. SudokuSolver::Branching and WideSudokuSolver::Branching are the same type, and the
+  settings can be copied from one to another.
+*/
+class SudokuSolverBase
+{
+
+public:
+
+    // The rule used to choose the empty cell that's branched on at each step of the search.
+    enum class Branching
+    {
+        // The first empty cell in row-major order.
+        RowMajor,
+
+        // The empty cell with the fewest candidates (the 'minimum remaining values' heuristic).
+        MostConstrained
+    };
+
+    // The rule used to choose between cells that have the same (fewest) number of candidates.
+    enum class TieBreak
+    {
+        // Whichever of the cells is found first; the cheapest rule, though the choice depends on the search history.
+        First,
+
+        // The cell that's earliest in row-major order.
+        LowestIndex,
+
+        // The cell with the most empty peers, as filling it constrains the most other cells.
+        MostEmptyPeers
+    };
+
+    // The rule by which Solve abandons its search and starts again from the root (see SetRestarts).
+    enum class Restarts
+    {
+        // The search runs until it finishes.
+        None,
+
+        // The node limits of the runs are the first run's times the Luby sequence (1, 1, 2, 1, 1, 2, 4, 1, 1, ...).
+        Luby,
+
+        // Each run's node limit is half as large again as the previous run's (rounded up).
+        Geometric
+    };
+
+    /*
+    * The logical techniques that can be applied to the grid before and during the search (see SetPropagation).
+    * These are bit flags, so any combination of them can be enabled.
+    */
+
+    // A cell with only one candidate must hold that candidate.
+    static const unsigned int S_NAKED_SINGLES = 1 << 0;
+
+    // A digit that's a candidate of only one cell of a row, column or box must be placed in that cell.
+    static const unsigned int S_HIDDEN_SINGLES = 1 << 1;
+
+    // If, within a box, a digit's candidates all lie in one row/column, the digit can be eliminated from the rest of
+    // that row/column ('pointing'); likewise, if within a row/column they all lie in one box, the digit can be
+    // eliminated from the rest of that box ('claiming').
+    static const unsigned int S_LOCKED_CANDIDATES = 1 << 2;
+
+    // If two cells of a row, column or box have the same two candidates, those digits can be eliminated from the
+    // unit's other cells.
+    static const unsigned int S_NAKED_PAIRS = 1 << 3;
+
+    // If two digits are candidates of the same two cells of a row, column or box (and of no other cell of that
+    // unit), all other candidates can be eliminated from those cells.
+    static const unsigned int S_HIDDEN_PAIRS = 1 << 4;
+
+    // No techniques, and all of the techniques.
+    static const unsigned int S_PROPAGATE_NONE = 0;
+    static const unsigned int S_PROPAGATE_ALL = (1 << 5) - 1;
+
+    // A choice made by the search: the placement of a value in a cell (as opposed to one forced by propagation).
+    struct Decision
+    {
+        unsigned int cell;
+        unsigned int value;
+    };
+
+    /*
+    * An object that the search can hand some of its unexplored branches to, so that they can be explored by another
+      solver (see SetSplitter and SearchFrom); used for parallel search.
+    */
+    class Splitter
+    {
+    public:
+
+        virtual ~Splitter() {}
+
+        /*
+        * Returns whether or not branches should be handed over at the given depth (the number of decisions made).
+        */
+        virtual bool IsWanted(unsigned int p_depth) = 0;
+
+        /*
+        * Takes the branch reached by the given sequence of decisions, starting from the state after BeginSearch.
+        */
+        virtual void Donate(const std::vector<Decision>& p_path) = 0;
+    };
+
+
+protected:
+
+    // The branching rule and its tie-breaking rule.
+    Branching f_branching;
+    TieBreak f_tie_break;
+
+    // The techniques applied by Propagate, and whether they're applied at every step of the search (rather than only
+    // before it).
+    unsigned int f_techniques;
+    bool f_propagate_at_nodes;
+
+    // Whether or not the search's choices are made at random (see SetRandomization), and the seed.
+    bool f_is_random;
+    unsigned long long f_seed;
+
+    // The restart rule and the node limit of the first run (see SetRestarts).
+    Restarts f_restarts;
+    unsigned long long f_nodes_first_run;
+
+
+public:
+
+    // The default node limit of the first run of a search with restarts.
+    static const unsigned long long S_NODES_FIRST_RUN = 100;
+
+
+    SudokuSolverBase();
+
+    /*
+    * Sets the rule used to choose the cell to branch on (and how ties are broken) for subsequent calls to Solve.
+    * The default is MostConstrained with ties broken by LowestIndex.
+    */
+    void SetBranching(Branching p_branching, TieBreak p_tie_break = TieBreak::LowestIndex);
+
+    /*
+    * Sets the techniques (a combination of the S_ flags above) that are applied, until none of them make progress,
+      before the search and, if p_at_every_node is true, at every step of the search.
+    * The default is S_NAKED_SINGLES | S_HIDDEN_SINGLES at every step.
+    */
+    void SetPropagation(unsigned int p_techniques, bool p_at_every_node = true);
+
+    /*
+    * Sets whether or not the search makes its choices at random: ties between the cells with the fewest candidates are
+      broken at random (in place of the TieBreak rule), and the candidates of each cell are tried in a random order.
+      The choices are drawn from a generator that's seeded with p_seed at the start of each search, so a search is
+      reproducible: the same grid, settings and seed give the same search (on one thread). Off by default.
+    */
+    void SetRandomization(bool p_is_random, unsigned long long p_seed = 0);
+
+    /*
+    * Sets the rule by which Solve restarts its search: each run gives up once it has visited its limit of nodes, and
+      the next one starts again from the root with a greater limit, until a run finishes. The limits grow from
+      p_nodes_first_run (see Restarts), so the search stays complete. Restarts only make sense with randomization
+      (see SetRandomization), as the runs would otherwise repeat each other; the generator isn't reseeded between
+      runs. They don't apply to Enumerate or to a parallel search (see SearchFrom). The default is Restarts::None.
+    */
+    void SetRestarts(Restarts p_restarts, unsigned long long p_nodes_first_run = S_NODES_FIRST_RUN);
+
+    /*
+    * Copies the settings (branching, propagation, randomization and restarts) of p_other, but not its grid.
+    */
+    void CopySettings(const SudokuSolverBase& p_other);
+
+    /*
+    * Returns whether or not the settings are the defaults (see SetBranching, SetPropagation, SetRandomization and
+      SetRestarts).
+    */
+    bool HasDefaultSettings() const;
+
+
+protected:
+
+    /* Auxiliary of BasicSudokuSolver::Solve
+    * Returns the p_index-th term (from 0) of the Luby sequence: 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ...
+    */
+    static unsigned long long GetLuby(unsigned long long p_index);
+
+};
+
+
+/*
+* The engine that SudokuBoard uses to solve its grid.
+* Rather than rescanning a cell's row, column and box whenever a value is tried, the solver keeps, for each row,
+  column and box, a bitmask of the digits that are already used within it. These masks are updated incrementally as
+  values are placed and removed, meaning that the candidates of a cell can be calculated with a few bitwise operations.
+* The masks are of type M, which limits the number of digits of the grid to its number of bits (S_NUM_DIGITS_MAX):
+  SudokuSolver's are unsigned long long, for grids of up to 64 digits, and WideSudokuSolver's are WideMask<2>, for
+  grids of up to 128 digits (e.g. 100x100, with 10x10 boxes). Wider masks take longer to operate on, so each grid is
+  best solved by the narrowest instantiation that can hold its digits.
+*/
+template <typename M>
+class BasicSudokuSolver : public SudokuSolverBase
+{
+
+public:
+
+    // A set of digits: bit (d - 1) is set if the digit d is in the set.
+    typedef M Mask;
+
+    // The greatest number of digits of a grid, i.e. the number of bits of a Mask.
+    static const unsigned int S_NUM_DIGITS_MAX = 8 * sizeof(Mask);
+
+
+private:
+
+    // The width of a box in the grid.
+    unsigned int f_width_box;
+
+    // The height of a box in the grid.
+    unsigned int f_height_box;
+
+    // The dimension (width/height) of the grid.
+    unsigned int f_size_grid;
+
+    // The number of cells in the grid (f_size_grid * f_size_grid).
+    unsigned int f_num_cells;
+
+    // The value of each cell, indexed by row * f_size_grid + col.
+    std::vector<unsigned int> f_cells;
+
+    // The box that each cell belongs to, indexed in the same way as f_cells.
+    std::vector<unsigned int> f_box_of_cell;
+
+    // The digits that are used in each row.
+    std::vector<Mask> f_used_rows;
+
+    // The digits that are used in each column.
+    std::vector<Mask> f_used_cols;
+
+    // The digits that are used in each box.
+    std::vector<Mask> f_used_boxes;
+
+    // The set of all digits that can be placed in the grid (1 to f_size_grid).
+    Mask f_mask_all;
+
+    // The number of peers of each cell: the other cells that share its row, column or box.
+    unsigned int f_num_peers;
+
+    // The peers of each cell; the peers of cell c are at indexes c * f_num_peers to (c + 1) * f_num_peers - 1.
+    std::vector<unsigned int> f_peers;
+
+    // The cells of each unit: rows are units 0 to f_size_grid - 1, columns are the next f_size_grid units, and boxes
+    // the f_size_grid after that. The cells of unit u are at indexes u * f_size_grid to (u + 1) * f_size_grid - 1.
+    std::vector<unsigned int> f_unit_cells;
+
+    // The candidates that have been eliminated from each cell by propagation (over and above those which are used in
+    // the cell's row, column or box).
+    std::vector<Mask> f_eliminated;
+
+    // The union of the candidates of the empty cells of each row segment (the cells a row shares with a box) and of
+    // each column segment (the cells a column shares with a box); used by the locked candidates technique.
+    std::vector<Mask> f_segments_row;
+    std::vector<Mask> f_segments_col;
+
+    /*
+    * A record of each change made to the grid since Solve was called, so that the changes can be undone in reverse
+      order when the search backtracks. An entry with an empty mask records the placement of a value in the cell;
+      otherwise it records the elimination of the mask's digits from the cell.
+    */
+    struct TrailEntry
+    {
+        unsigned int cell;
+        Mask eliminated;
+    };
+    std::vector<TrailEntry> f_trail;
+
+    /*
+    * The nodes of the search tree between the root and the current node (see Solve_BackTracking): the cell that's
+      branched on, the candidates that are yet to be tried there, and the size of the trail before any of them was
+      placed.
+    */
+    struct Frame
+    {
+        unsigned int cell;
+        Mask candidates;
+        std::size_t size_trail;
+    };
+    std::vector<Frame> f_stack;
+
+    // The decisions that led to the current state of the search; only maintained when f_splitter isn't nullptr.
+    std::vector<Decision> f_path;
+
+    // The object that unexplored branches are handed to, or nullptr.
+    Splitter* f_splitter;
+
+    // A flag that, when set (by another thread), makes the search stop as soon as possible; or nullptr.
+    const std::atomic<bool>* f_cancel;
+
+    // The meter of the search's budget (see SetBudget).
+    SearchBudget::Meter f_meter;
+
+    // The function that Enumerate calls at each solution, or nullptr when the search stops at the first one.
+    const std::function<bool()>* f_visit;
+
+    // The number of cells that are empty.
+    unsigned int f_num_empty;
+
+    // The statistics of the search since the grid was loaded (see SolverStats; only the counters are used).
+    SolverStats f_stats;
+
+    // The state of the generator that the random choices are drawn from (SplitMix64), which BeginSearch reseeds.
+    unsigned long long f_random;
+
+    // The number of nodes that the current run of the search may still visit before it gives up, so that Solve can
+    // restart it; BeginSearch sets it to ~0, i.e. no limit.
+    unsigned long long f_num_nodes_left_run;
+
+    /*
+    * The following fields are only maintained when f_branching is MostConstrained.
+    * Each empty cell is kept in a 'bucket' according to its number of candidates, so that the most constrained cell
+      can be found without scanning the grid. A bucket is a circular doubly-linked list: nodes 0 to f_num_cells - 1
+      are the cells, while node f_num_cells + k is the head of the bucket of cells with k candidates.
+    */
+
+    // Whether or not the buckets (and the counts below) are currently being maintained.
+    bool f_track_buckets;
+
+    // The number of candidates of each empty cell.
+    std::vector<unsigned int> f_num_candidates;
+
+    // The number of empty peers of each cell.
+    std::vector<unsigned int> f_num_empty_peers;
+
+    // The next and previous node of each node in its bucket.
+    std::vector<unsigned int> f_bucket_next;
+    std::vector<unsigned int> f_bucket_prev;
+
+
+    // The value used for empty cells in the grid.
+    static const unsigned int S_VALUE_EMPTY_CELL = 0;
+
+
+public:
+
+    BasicSudokuSolver();
+
+    /*
+    * Copies the given grid into the solver and builds the row, column and box masks from its pre-filled cells.
+    * Returns false if any of the pre-filled cells violate the rules of sudoku (or hold a value that's out of range),
+      in which case the solver is left in an unspecified state and Solve mustn't be called. The grid mustn't have
+      more than S_NUM_DIGITS_MAX digits.
+    */
+    bool Load(const CompactGrid& p_grid, unsigned int p_width_box, unsigned int p_height_box);
+
+    /*
+    * Copies the solver's cells into the given grid, which must have the same dimensions as the loaded one.
+    */
+    void Store(CompactGrid& p_grid) const;
+
+    /*
+    * Tries to fill all of the empty cells of the loaded grid; returns whether or not this was possible.
+    */
+    bool Solve();
+
+    /*
+    * Solve is equivalent to BeginSearch followed by SearchFrom with an empty path (repeated for each run, if it
+      restarts); they're exposed separately so that a parallel search can give a copy of the solver (taken after
+      BeginSearch) to each of its threads.
+    * BeginSearch prepares the loaded grid for the search and returns false if it's found to be unsolvable.
+    * SearchFrom replays the given decisions and then searches the branch they lead to, returning whether or not it
+      contains a solution. If it doesn't, the solver is returned to its state before the call.
+    */
+    bool BeginSearch();
+    bool SearchFrom(const std::vector<Decision>& p_path);
+
+    /*
+    * Searches the whole tree of the loaded grid (as Solve does, but carrying on past each solution), calling p_visit
+      at each solution while the solver holds it (so that it can be copied with Store). The search stops early if
+      p_visit returns false.
+    * Returns the number of solutions visited. The solver is left holding the last of them if p_visit stopped the
+      search; otherwise it's returned to its state before the search began.
+    * The search is sequential: it mustn't be called with a splitter set.
+    */
+    unsigned long long Enumerate(const std::function<bool()>& p_visit);
+
+    /*
+    * Sets the object that the search hands unexplored branches to (nullptr, the default, for none).
+    */
+    void SetSplitter(Splitter* p_splitter);
+
+    /*
+    * Sets the flag which, once set, makes the search give up (nullptr, the default, for none).
+    */
+    void SetCancelFlag(const std::atomic<bool>* p_cancel);
+
+    /*
+    * Sets the budget (already started; see SearchBudget::Start) that the next search spends a node of at each node
+      of its tree, giving up once it runs out (nullptr for none). The copies of the solver spend the same budget.
+    */
+    void SetBudget(SearchBudget* p_budget);
+
+    /*
+    * Returns the set of values that can be placed at the given cell without violating the rules of sudoku.
+    */
+    Mask GetCandidates(unsigned int p_cell) const;
+
+    /*
+    * Returns the counters of the searches (and propagation) since the grid was loaded.
+    */
+    const SolverStats& GetStats() const;
+
+    /*
+    * Sets the counters to 0; used by a parallel search for the copies of the solver that share another's work.
+    */
+    void ClearStats();
+
+
+private:
+
+    /* Auxiliary of Solve
+    * This method tries to solve the sudoku using the backtracking technique.
+    * The search is iterative, keeping its nodes on f_stack rather than on the call stack, so its use of the call
+      stack doesn't depend on the size of the grid.
+    */
+    bool Solve_BackTracking();
+
+    /* Auxiliary of Load, Solve_BackTracking, the Apply methods
+    * Places p_value at the (empty) cell p_cell, marks it as used in the cell's row, column and box, and records the
+      placement on the trail.
+    */
+    void Assign(unsigned int p_cell, unsigned int p_value);
+
+    /* Auxiliary of UndoTo
+    * Empties the cell p_cell, reversing the corresponding call to Assign.
+    */
+    void Unassign(unsigned int p_cell);
+
+    /* Auxiliary of the Apply methods
+    * Removes the digits of p_mask from the candidates of the (empty) cell p_cell, recording the change on the trail;
+      p_technique is the flag of the technique that made the deduction, for the statistics.
+    * Returns false if this leaves the cell without any candidates.
+    */
+    bool Eliminate(unsigned int p_cell, Mask p_mask, unsigned int p_technique);
+
+    /* Auxiliary of UndoTo
+    * Returns the digits of p_mask to the candidates of p_cell, reversing the corresponding call to Eliminate.
+    */
+    void Restore(unsigned int p_cell, Mask p_mask);
+
+    /* Auxiliary of SearchFrom, Solve_BackTracking
+    * Undoes the changes recorded on the trail until it's of size p_size.
+    */
+    void UndoTo(std::size_t p_size);
+
+    /* Auxiliary of Solve, Solve_BackTracking
+    * Applies the enabled techniques until none of them make progress. Returns false if a contradiction is found,
+      meaning that the grid (in its current state) cannot be solved.
+    */
+    bool Propagate();
+
+    /* Auxiliary of Propagate
+    * Each of these applies one of the techniques to the whole grid, setting p_changed to true if they placed a value
+      or eliminated a candidate, and returns false if a contradiction was found.
+    */
+    bool ApplyNakedSingles(bool& p_changed);
+    bool ApplyHiddenSingles(bool& p_changed);
+    bool ApplyLockedCandidates(bool& p_changed);
+    bool ApplyNakedPairs(bool& p_changed);
+    bool ApplyHiddenPairs(bool& p_changed);
+
+    /*
+    * Returns the digits used in the unit (row, column or box) p_unit.
+    */
+    Mask GetUsedInUnit(unsigned int p_unit) const;
+
+    /* Auxiliary of Solve_BackTracking
+    * Assigns to p_cell the index of the 'earliest' empty cell (in row-major order), starting the search from p_cell.
+    * If an empty cell is assigned, true is returned; if an empty cell isn't assigned, meaning one couldn't be found,
+      false is returned.
+    */
+    bool AssignNextEmptyCell(unsigned int& p_cell) const;
+
+    /* Auxiliary of Solve_BackTracking
+    * Assigns to p_cell the index of the empty cell with the fewest candidates, with ties broken by f_tie_break (or at
+      random).
+    * Returns false if there are no empty cells.
+    */
+    bool AssignMostConstrainedCell(unsigned int& p_cell);
+
+    /* Auxiliary of Solve_BackTracking, AssignMostConstrainedCell
+    * Returns the next number of the generator of the random choices.
+    */
+    unsigned long long NextRandom();
+
+    /* Auxiliary of Solve_BackTracking
+    * Returns one of the bits of p_mask (which mustn't be 0), chosen at random, as a mask.
+    */
+    Mask PickRandomBit(Mask p_mask);
+
+    /* Auxiliary of Load
+    * Calculates the peers of each cell and the cells of each unit.
+    */
+    void BuildPeers();
+
+    /* Auxiliary of Solve
+    * Calculates the candidate counts of the empty cells and places each of them in the corresponding bucket.
+    */
+    void BuildBuckets();
+
+    /* Auxiliary of Assign, Unassign, BuildBuckets
+    * Inserts the cell into, or removes it from, the bucket that corresponds to its number of candidates.
+    */
+    void InsertIntoBucket(unsigned int p_cell);
+    void RemoveFromBucket(unsigned int p_cell);
+
+};
+
+
+// The instantiations of BasicSudokuSolver, for grids of up to 64 and 128 digits respectively.
+typedef BasicSudokuSolver<unsigned long long> SudokuSolver;
+typedef BasicSudokuSolver<WideMask<2>> WideSudokuSolver;
@@ -0,0 +1,154 @@
+#include"WorkStealingPool.h"
+
+
+WorkStealingPool::WorkStealingPool(unsigned int p_num_threads)
+    : f_num_queued(0), f_num_unfinished(0), f_next_queue(0), f_is_stopping(false)
+{
+    if (p_num_threads == 0)
+    { p_num_threads = std::thread::hardware_concurrency(); }
+
+    if (p_num_threads == 0)
+    { p_num_threads = 1; }
+
+    for (unsigned int i = 0; i < p_num_threads; ++i)
+    {
+        f_queues.emplace_back(new Queue());
+    }
+
+    for (unsigned int i = 0; i < p_num_threads; ++i)
+    {
+        f_threads.emplace_back(&WorkStealingPool::RunWorker, this, i);
+    }
+
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    WaitIdle();
+
+    {
+        std::lock_guard<std::mutex> l_lock(f_mutex);
+        f_is_stopping = true;
+    }
+
+    f_cv_work.notify_all();
+
+    for (std::thread& l_thread : f_threads)
+    {
+        l_thread.join();
+    }
+
+}
+
+unsigned int WorkStealingPool::GetNumThreads() const
+{
+    return static_cast<unsigned int>(f_threads.size());
+}
+
+void WorkStealingPool::Submit(Task p_task)
+{
+    Submit(std::move(p_task), f_next_queue++ % f_queues.size());
+}
+
+/*
+* Notes:
+    (a). f_num_queued is incremented under f_mutex so that a worker can't check it, find it to be 0, and then miss the
+         notification by starting to wait just after it's sent.
+*/
+void WorkStealingPool::Submit(Task p_task, unsigned int p_index)
+{
+    ++f_num_unfinished;
+
+    Queue& l_queue = *f_queues[p_index];
+
+    {
+        std::lock_guard<std::mutex> l_lock(l_queue.mutex);
+        l_queue.tasks.push_back(std::move(p_task));
+    }
+
+    // (a).
+    {
+        std::lock_guard<std::mutex> l_lock(f_mutex);
+        ++f_num_queued;
+    }
+
+    f_cv_work.notify_one();
+}
+
+void WorkStealingPool::WaitIdle()
+{
+    std::unique_lock<std::mutex> l_lock(f_mutex);
+
+    f_cv_idle.wait(l_lock, [this]() { return f_num_unfinished == 0; });
+}
+
+
+/* Auxiliary of WorkStealingPool
+
+* Notes:
+    (a). The last task to finish wakes WaitIdle; the lock ensures that the notification isn't sent between WaitIdle
+         checking f_num_unfinished and starting to wait.
+*/
+void WorkStealingPool::RunWorker(unsigned int p_index)
+{
+    Task l_task;
+
+    for (;;)
+    {
+        if (TryTake(p_index, l_task))
+        {
+            --f_num_queued;
+
+            l_task(p_index);
+            l_task = nullptr;
+
+            // (a).
+            if (--f_num_unfinished == 0)
+            {
+                std::lock_guard<std::mutex> l_lock(f_mutex);
+                f_cv_idle.notify_all();
+            }
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> l_lock(f_mutex);
+
+        f_cv_work.wait(l_lock, [this]() { return f_num_queued > 0 || f_is_stopping; });
+
+        if (f_is_stopping && f_num_queued <= 0)
+        { return; }
+    }
+
+}
+
+bool WorkStealingPool::TryTake(unsigned int p_index, Task& p_task)
+{
+    unsigned int l_num_queues = static_cast<unsigned int>(f_queues.size());
+
+    for (unsigned int i = 0; i < l_num_queues; ++i)
+    {
+        Queue& l_queue = *f_queues[(p_index + i) % l_num_queues];
+
+        std::lock_guard<std::mutex> l_lock(l_queue.mutex);
+
+        if (l_queue.tasks.empty())
+        { continue; }
+
+        // A worker takes the most recently added task of its own queue, but the oldest of another's.
+        if (i == 0)
+        {
+            p_task = std::move(l_queue.tasks.back());
+            l_queue.tasks.pop_back();
+        }
+        else
+        {
+            p_task = std::move(l_queue.tasks.front());
+            l_queue.tasks.pop_front();
+        }
+
+        return true;
+    }
+
+    return false;
+}
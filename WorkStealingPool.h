@@ -0,0 +1,107 @@
+#pragma once
+
+#include<atomic>
+#include<condition_variable>
+#include<deque>
+#include<functional>
+#include<memory>
+#include<mutex>
+#include<thread>
+#include<vector>
+
+
+/*
+* A fixed-size pool of worker threads that run submitted tasks.
+* Each worker has its own queue of tasks: it takes tasks from the back of its own queue and, when that's empty,
+  'steals' tasks from the front of the other workers' queues. This means that a worker that's stuck on a slow task
+  doesn't hold up the tasks queued behind it, as the other workers take them instead.
+*/
+class WorkStealingPool
+{
+
+public:
+
+    // A task; its parameter is the index of the worker that runs it (0 to GetNumThreads() - 1), which allows each
+    // worker to use its own state.
+    typedef std::function<void(unsigned int)> Task;
+
+
+private:
+
+    // The queue of a worker, and the mutex that guards it.
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // The queue of each worker.
+    std::vector<std::unique_ptr<Queue>> f_queues;
+
+    // The worker threads.
+    std::vector<std::thread> f_threads;
+
+    // The number of tasks that are in the queues, and the number that have been submitted but not yet finished.
+    std::atomic<int> f_num_queued;
+    std::atomic<int> f_num_unfinished;
+
+    // The queue that the next task is submitted to by Submit; tasks are distributed among the queues in turn.
+    std::atomic<unsigned int> f_next_queue;
+
+    // Whether or not the workers should exit once the queues are empty.
+    bool f_is_stopping;
+
+    // Guards the waiting of the workers (for tasks) and of WaitIdle (for the tasks to finish).
+    std::mutex f_mutex;
+    std::condition_variable f_cv_work;
+    std::condition_variable f_cv_idle;
+
+
+public:
+
+    /*
+    * Creates the pool with p_num_threads workers; if p_num_threads is 0, one worker per hardware thread is created.
+    */
+    WorkStealingPool(unsigned int p_num_threads);
+
+    /*
+    * Waits for all of the submitted tasks to finish and then joins the workers.
+    */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned int GetNumThreads() const;
+
+    /*
+    * Adds the task to the back of one of the workers' queues.
+    */
+    void Submit(Task p_task);
+
+    /*
+    * Adds the task to the back of the queue of the worker p_index; intended for a task that's spawned by a task that
+      the worker is running, so that the worker continues with it unless another worker steals it first.
+    */
+    void Submit(Task p_task, unsigned int p_index);
+
+    /*
+    * Blocks until all of the submitted tasks have finished.
+    */
+    void WaitIdle();
+
+
+private:
+
+    /* Auxiliary of WorkStealingPool
+    * The loop run by each worker thread.
+    */
+    void RunWorker(unsigned int p_index);
+
+    /* Auxiliary of RunWorker
+    * Takes a task from the back of the worker's own queue or, failing that, from the front of another's.
+    * Returns false if every queue is empty.
+    */
+    bool TryTake(unsigned int p_index, Task& p_task);
+
+};
@@ -0,0 +1,547 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+
+#include"../SudokuBoard.h"
+#include"../PuzzleReader.h"
+
+
+/*
+* The benchmark harness: solves every puzzle of each corpus with each configuration of the engines, and reports the
+  throughput and the latency per puzzle.
+* It's built from this file and the sources of the solver (every .cpp file of the parent directory except Main.cpp).
+*/
+
+
+// A configuration of the engines that's benchmarked.
+struct Config
+{
+    const char* name;
+    SudokuBoard::Engine engine;
+    unsigned int techniques;
+    bool propagate_at_nodes;
+
+    // The number of threads that search each puzzle (see SudokuBoard::SetNumThreads; 0 for one per hardware thread).
+    unsigned int num_threads;
+
+    // The largest grid on which the configuration is run (0 for any), for those that are too slow on larger ones.
+    unsigned int max_size_grid;
+
+    // The strategies raced by a portfolio in place of the engine (see PortfolioSolver::ParseStrategies), or nullptr.
+    const char* strategies;
+
+    // The restart rule of the BackTracking engine, whose choices are then random (see SudokuSolver::SetRestarts).
+    SudokuSolver::Restarts restarts;
+};
+
+// The configurations that can be benchmarked; all of them by default.
+static const Config S_CONFIGS[] =
+{
+    { "backtracking", SudokuBoard::Engine::BackTracking, SudokuSolver::S_NAKED_SINGLES | SudokuSolver::S_HIDDEN_SINGLES,
+      true, 1, 0, nullptr, SudokuSolver::Restarts::None },
+    { "backtracking-all", SudokuBoard::Engine::BackTracking, SudokuSolver::S_PROPAGATE_ALL, true, 1, 0, nullptr,
+      SudokuSolver::Restarts::None },
+    { "backtracking-root-only", SudokuBoard::Engine::BackTracking,
+      SudokuSolver::S_NAKED_SINGLES | SudokuSolver::S_HIDDEN_SINGLES, false, 1, 9, nullptr,
+      SudokuSolver::Restarts::None },
+    { "backtracking-parallel", SudokuBoard::Engine::BackTracking,
+      SudokuSolver::S_NAKED_SINGLES | SudokuSolver::S_HIDDEN_SINGLES, true, 0, 0, nullptr,
+      SudokuSolver::Restarts::None },
+    { "backtracking-restarts", SudokuBoard::Engine::BackTracking,
+      SudokuSolver::S_NAKED_SINGLES | SudokuSolver::S_HIDDEN_SINGLES, true, 1, 0, nullptr,
+      SudokuSolver::Restarts::Luby },
+    { "dlx", SudokuBoard::Engine::DancingLinks, SudokuSolver::S_PROPAGATE_NONE, true, 1, 0, nullptr,
+      SudokuSolver::Restarts::None },
+    { "portfolio", SudokuBoard::Engine::BackTracking, SudokuSolver::S_NAKED_SINGLES | SudokuSolver::S_HIDDEN_SINGLES,
+      true, 1, 0, PortfolioSolver::S_STRATEGIES_DEFAULT, SudokuSolver::Restarts::None }
+};
+
+// A corpus: the puzzles of one file, named after the file (e.g. '9x9_hard' for 'corpus/9x9_hard.txt').
+struct Corpus
+{
+    std::string name;
+
+    // The dimensions of the grids, e.g. "9x9" (or "mixed" if they differ), and the largest of them.
+    std::string size;
+    unsigned int max_size_grid;
+
+    // The puzzles, as snapshots of the board that they were read into.
+    std::vector<SudokuBoard::Snapshot> puzzles;
+};
+
+// The measurements of one configuration on one corpus.
+struct Result
+{
+    std::string corpus;
+    std::string size;
+    std::string config;
+    unsigned long long num_puzzles;
+
+    // The number of puzzles that weren't solved (which is always 0 for a corpus of valid puzzles).
+    unsigned long long num_failures;
+
+    double puzzles_per_second;
+    double median_us;
+    double p99_us;
+
+    // The mean number of search nodes per puzzle, and the number visited per second of solving (see SolverStats; 0 if
+    // the statistics are compiled out).
+    double nodes_per_puzzle;
+    double nodes_per_second;
+};
+
+
+/*
+* Returns the value of the command line option p_name if it's in the form '<p_name>=<value>'; otherwise nullptr.
+*/
+const char* GetOptionValue(const char* p_arg, const char* p_name)
+{
+    std::size_t l_length_name = std::strlen(p_name);
+
+    if (std::strncmp(p_arg, p_name, l_length_name) != 0 || p_arg[l_length_name] != '=')
+    { return nullptr; }
+
+    return p_arg + l_length_name + 1;
+}
+
+/*
+* Reads the puzzles of the file p_path into p_corpus. Returns false, with a message written to stderr, if the file
+  can't be opened or is malformed.
+*/
+bool LoadCorpus(const std::string& p_path, Corpus& p_corpus)
+{
+    PuzzleReader l_reader;
+
+    if (!l_reader.Open(p_path.c_str()))
+    {
+        if (l_reader.GetError().empty())
+        { std::cerr << "The file '" << p_path << "' could not be opened.\n"; }
+        else
+        { std::cerr << "The file '" << p_path << "' is malformed (" << l_reader.GetError() << ").\n"; }
+
+        return false;
+    }
+
+    // The name is the file name without its directory or extension.
+    std::size_t l_begin = p_path.find_last_of("/\\");
+    l_begin = l_begin == std::string::npos ? 0 : l_begin + 1;
+    p_corpus.name = p_path.substr(l_begin, p_path.find_last_of('.') - l_begin);
+
+    SudokuBoard l_board;
+
+    while (l_reader.Read(l_board))
+    {
+        unsigned int l_size_grid = l_board.GetSizeGrid();
+        std::string l_size = std::to_string(l_size_grid) + 'x' + std::to_string(l_size_grid);
+
+        p_corpus.size = p_corpus.puzzles.empty() || p_corpus.size == l_size ? l_size : "mixed";
+        p_corpus.max_size_grid = p_corpus.puzzles.empty() ? l_size_grid : std::max(p_corpus.max_size_grid, l_size_grid);
+        p_corpus.puzzles.emplace_back();
+        l_board.TakeSnapshot(p_corpus.puzzles.back());
+    }
+
+    if (!l_reader.GetError().empty())
+    {
+        std::cerr << "The file '" << p_path << "' is malformed (" << l_reader.GetError() << ").\n";
+        return false;
+    }
+
+    return true;
+}
+
+/*
+* Solves every puzzle of p_corpus with p_config, p_num_warmup times without measuring and then p_num_repetitions
+  times, and returns the measurements.
+
+* Notes:
+    (a). Only the call to Solve is timed, not the copying of the puzzle into the board.
+    (b). The throughput is the number of puzzles solved per second of solving; the latencies are taken over every
+         repetition of every puzzle, the 99th percentile being the nearest-rank one.
+    (c). The nodes tell apart a change to the speed of each node from a change to the size of the search.
+*/
+Result RunConfig(const Config& p_config, const Corpus& p_corpus, unsigned int p_num_warmup,
+                 unsigned int p_num_repetitions)
+{
+    SudokuBoard l_board;
+    l_board.SetEngine(p_config.engine);
+    l_board.SetPropagation(p_config.techniques, p_config.propagate_at_nodes);
+    l_board.SetNumThreads(p_config.num_threads);
+    l_board.SetRandomization(p_config.restarts != SudokuSolver::Restarts::None);
+    l_board.SetRestarts(p_config.restarts);
+
+    std::vector<PortfolioSolver::Strategy> l_strategies;
+
+    if (p_config.strategies != nullptr)
+    { PortfolioSolver::ParseStrategies(p_config.strategies, l_strategies); }
+
+    l_board.SetPortfolio(l_strategies);
+
+    Result l_result{ p_corpus.name, p_corpus.size, p_config.name, p_corpus.puzzles.size(), 0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+    std::vector<double> l_latencies;
+    l_latencies.reserve(p_corpus.puzzles.size() * p_num_repetitions);
+
+    double l_seconds = 0.0;
+    unsigned long long l_num_nodes = 0;
+
+    for (unsigned int l_pass = 0; l_pass < p_num_warmup + p_num_repetitions; ++l_pass)
+    {
+        bool l_is_measured = l_pass >= p_num_warmup;
+
+        for (std::size_t i = 0; i < p_corpus.puzzles.size(); ++i)
+        {
+            l_board.RestoreSnapshot(p_corpus.puzzles[i]);
+
+            // (a).
+            std::chrono::steady_clock::time_point l_start = std::chrono::steady_clock::now();
+            bool l_is_solved = l_board.Solve();
+            double l_latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - l_start).count();
+
+            if (!l_is_measured)
+            { continue; }
+
+            l_seconds += l_latency;
+            l_latencies.push_back(l_latency);
+
+            if (!l_is_solved)
+            { ++l_result.num_failures; }
+
+            // (c).
+            l_num_nodes += l_board.GetStats().nodes;
+        }
+
+    }
+
+    // (b).
+    if (!l_latencies.empty())
+    {
+        std::sort(l_latencies.begin(), l_latencies.end());
+
+        l_result.puzzles_per_second = l_seconds > 0 ? l_latencies.size() / l_seconds : 0.0;
+        l_result.median_us = l_latencies[(l_latencies.size() - 1) / 2] * 1e6;
+        l_result.p99_us = l_latencies[(l_latencies.size() * 99 + 99) / 100 - 1] * 1e6;
+        l_result.nodes_per_puzzle = double(l_num_nodes) / l_latencies.size();
+        l_result.nodes_per_second = l_seconds > 0 ? l_num_nodes / l_seconds : 0.0;
+    }
+
+    l_result.num_failures /= p_num_repetitions;
+
+    return l_result;
+}
+
+/*
+* Writes the results as a table.
+*/
+void WriteTable(std::ostream& p_output, const std::vector<Result>& p_results)
+{
+    char l_line[256];
+
+    std::snprintf(l_line, sizeof(l_line), "%-16s %-7s %-24s %8s %14s %12s %12s %12s %14s\n", "corpus", "size",
+                  "config", "puzzles", "puzzles/s", "median us", "p99 us", "nodes/puzzle", "nodes/s");
+    p_output << l_line;
+
+    for (const Result& l_result : p_results)
+    {
+        std::snprintf(l_line, sizeof(l_line), "%-16s %-7s %-24s %8llu %14.1f %12.2f %12.2f %12.1f %14.0f%s\n",
+                      l_result.corpus.c_str(), l_result.size.c_str(), l_result.config.c_str(), l_result.num_puzzles,
+                      l_result.puzzles_per_second, l_result.median_us, l_result.p99_us, l_result.nodes_per_puzzle,
+                      l_result.nodes_per_second, l_result.num_failures != 0 ? "  (unsolved puzzles!)" : "");
+        p_output << l_line;
+    }
+
+}
+
+/*
+* Writes the results as JSON: an object whose 'results' member is an array of one object per result, each on its
+  own line (which ReadBaseline relies on).
+*/
+void WriteJson(std::ostream& p_output, const std::vector<Result>& p_results, unsigned int p_num_warmup,
+               unsigned int p_num_repetitions)
+{
+    p_output << "{\n  \"warmup\": " << p_num_warmup << ",\n  \"repetitions\": " << p_num_repetitions
+             << ",\n  \"results\": [\n";
+
+    for (std::size_t i = 0; i < p_results.size(); ++i)
+    {
+        const Result& l_result = p_results[i];
+
+        p_output << "    { \"corpus\": \"" << l_result.corpus << "\", \"size\": \"" << l_result.size
+                 << "\", \"config\": \"" << l_result.config << "\", \"puzzles\": " << l_result.num_puzzles
+                 << ", \"failures\": " << l_result.num_failures
+                 << ", \"puzzles_per_second\": " << l_result.puzzles_per_second
+                 << ", \"median_us\": " << l_result.median_us << ", \"p99_us\": " << l_result.p99_us
+                 << ", \"nodes_per_puzzle\": " << l_result.nodes_per_puzzle
+                 << ", \"nodes_per_second\": " << l_result.nodes_per_second << " }"
+                 << (i + 1 < p_results.size() ? ",\n" : "\n");
+    }
+
+    p_output << "  ]\n}\n";
+}
+
+/*
+* Assigns to p_value the value of the member p_key of the JSON object written on the line p_line by WriteJson,
+  as a string or a number respectively. Returns false if the line has no such member.
+*/
+bool FindJsonString(const std::string& p_line, const char* p_key, std::string& p_value)
+{
+    std::string l_pattern = std::string("\"") + p_key + "\": \"";
+    std::size_t l_begin = p_line.find(l_pattern);
+
+    if (l_begin == std::string::npos)
+    { return false; }
+
+    l_begin += l_pattern.size();
+    p_value = p_line.substr(l_begin, p_line.find('"', l_begin) - l_begin);
+
+    return true;
+}
+
+bool FindJsonNumber(const std::string& p_line, const char* p_key, double& p_value)
+{
+    std::string l_pattern = std::string("\"") + p_key + "\": ";
+    std::size_t l_begin = p_line.find(l_pattern);
+
+    if (l_begin == std::string::npos)
+    { return false; }
+
+    p_value = std::strtod(p_line.c_str() + l_begin + l_pattern.size(), nullptr);
+
+    return true;
+}
+
+/*
+* Reads the results of a file written by WriteJson into p_results (only the members that are compared are read).
+  Returns false, with a message written to stderr, if the file can't be opened or holds no results.
+*/
+bool ReadBaseline(const char* p_path, std::vector<Result>& p_results)
+{
+    std::ifstream l_file(p_path);
+
+    if (!l_file.good())
+    {
+        std::cerr << "The baseline '" << p_path << "' could not be opened.\n";
+        return false;
+    }
+
+    std::string l_line;
+
+    while (std::getline(l_file, l_line))
+    {
+        Result l_result{};
+
+        if (FindJsonString(l_line, "corpus", l_result.corpus) && FindJsonString(l_line, "config", l_result.config) &&
+            FindJsonNumber(l_line, "puzzles_per_second", l_result.puzzles_per_second))
+        {
+            FindJsonNumber(l_line, "median_us", l_result.median_us);
+            FindJsonNumber(l_line, "p99_us", l_result.p99_us);
+            p_results.push_back(l_result);
+        }
+    }
+
+    if (p_results.empty())
+    {
+        std::cerr << "The baseline '" << p_path << "' holds no results.\n";
+        return false;
+    }
+
+    return true;
+}
+
+/*
+* Writes the change in the throughput of each result from the baseline's result for the same corpus and
+  configuration, flagging changes beyond p_tolerance (a fraction, e.g. 0.05). Returns the number of regressions.
+*/
+unsigned int CompareWithBaseline(std::ostream& p_output, const std::vector<Result>& p_results,
+                                 const std::vector<Result>& p_baseline, double p_tolerance)
+{
+    unsigned int l_num_regressions = 0;
+    char l_line[256];
+
+    std::snprintf(l_line, sizeof(l_line), "\n%-16s %-24s %14s %14s %9s\n", "corpus", "config", "baseline/s",
+                  "current/s", "change");
+    p_output << l_line;
+
+    for (const Result& l_result : p_results)
+    {
+        auto l_match = std::find_if(p_baseline.begin(), p_baseline.end(), [&](const Result& p_other)
+        {
+            return p_other.corpus == l_result.corpus && p_other.config == l_result.config;
+        });
+
+        if (l_match == p_baseline.end() || l_match->puzzles_per_second <= 0)
+        {
+            std::snprintf(l_line, sizeof(l_line), "%-16s %-24s %14s %14.1f %9s\n", l_result.corpus.c_str(),
+                          l_result.config.c_str(), "-", l_result.puzzles_per_second, "new");
+            p_output << l_line;
+            continue;
+        }
+
+        double l_change = l_result.puzzles_per_second / l_match->puzzles_per_second - 1.0;
+        const char* l_verdict = "";
+
+        if (l_change < -p_tolerance)
+        {
+            l_verdict = "  REGRESSION";
+            ++l_num_regressions;
+        }
+        else if (l_change > p_tolerance)
+        {
+            l_verdict = "  improvement";
+        }
+
+        std::snprintf(l_line, sizeof(l_line), "%-16s %-24s %14.1f %14.1f %+8.1f%%%s\n", l_result.corpus.c_str(),
+                      l_result.config.c_str(), l_match->puzzles_per_second, l_result.puzzles_per_second,
+                      l_change * 100, l_verdict);
+        p_output << l_line;
+    }
+
+    return l_num_regressions;
+}
+
+
+/*
+* The entry-point function.
+* Usage: benchmark <corpus file>... [--configs=<name>,...] [--warmup=<passes>] [--repetitions=<passes>]
+*                  [--json=<file>] [--baseline=<file>] [--tolerance=<percent>]
+* The table is written to stdout, and the results are also written as JSON to the given file ('-' for stdout). With
+  --baseline, the throughput is compared with that of a previous run's JSON, and the exit code is 2 if any result is
+  slower by more than the tolerance (5% by default).
+*/
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> l_files;
+    std::vector<const Config*> l_configs;
+
+    unsigned int l_num_warmup = 1;
+    unsigned int l_num_repetitions = 5;
+    const char* l_file_json = nullptr;
+    const char* l_file_baseline = nullptr;
+    double l_tolerance = 0.05;
+
+    // Parse the files and the options.
+    for (int i = 1; i < argc; ++i)
+    {
+        if (argv[i][0] != '-')
+        {
+            l_files.push_back(argv[i]);
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--configs"))
+        {
+            std::stringstream l_list(l_value);
+            std::string l_name;
+
+            while (std::getline(l_list, l_name, ','))
+            {
+                auto l_config = std::find_if(std::begin(S_CONFIGS), std::end(S_CONFIGS), [&](const Config& p_config)
+                {
+                    return l_name == p_config.name;
+                });
+
+                if (l_config == std::end(S_CONFIGS))
+                {
+                    std::cerr << "Unknown configuration '" << l_name << "'.\n";
+                    return EXIT_FAILURE;
+                }
+
+                l_configs.push_back(l_config);
+            }
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--warmup"))
+        {
+            l_num_warmup = static_cast<unsigned int>(std::strtoul(l_value, nullptr, 10));
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--repetitions"))
+        {
+            l_num_repetitions = std::max(1u, static_cast<unsigned int>(std::strtoul(l_value, nullptr, 10)));
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--json"))
+        {
+            l_file_json = l_value;
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--baseline"))
+        {
+            l_file_baseline = l_value;
+        }
+        else if (const char* l_value = GetOptionValue(argv[i], "--tolerance"))
+        {
+            l_tolerance = std::strtod(l_value, nullptr) / 100;
+        }
+        else
+        {
+            std::cerr << "Unknown option '" << argv[i] << "' (see README).\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (l_files.empty())
+    {
+        std::cerr << "No corpus files were specified (e.g. benchmark/corpus/*.txt).\n";
+        return EXIT_FAILURE;
+    }
+
+    if (l_configs.empty())
+    {
+        for (const Config& l_config : S_CONFIGS)
+        {
+            l_configs.push_back(&l_config);
+        }
+    }
+
+    std::vector<Result> l_baseline;
+
+    if (l_file_baseline != nullptr && !ReadBaseline(l_file_baseline, l_baseline))
+    { return EXIT_FAILURE; }
+
+    // Run every configuration on every corpus.
+    std::vector<Result> l_results;
+
+    for (const std::string& l_file : l_files)
+    {
+        Corpus l_corpus{};
+
+        if (!LoadCorpus(l_file, l_corpus))
+        { return EXIT_FAILURE; }
+
+        for (const Config* l_config : l_configs)
+        {
+            if (l_config->max_size_grid != 0 && l_corpus.max_size_grid > l_config->max_size_grid)
+            {
+                std::cerr << "Skipped " << l_config->name << " on " << l_corpus.name << " (grids too large).\n";
+                continue;
+            }
+
+            l_results.push_back(RunConfig(*l_config, l_corpus, l_num_warmup, l_num_repetitions));
+
+            std::cerr << "Ran " << l_config->name << " on " << l_corpus.name << ".\n";
+        }
+
+    }
+
+    WriteTable(std::cout, l_results);
+
+    if (l_file_json != nullptr)
+    {
+        if (std::strcmp(l_file_json, "-") == 0)
+        {
+            WriteJson(std::cout, l_results, l_num_warmup, l_num_repetitions);
+        }
+        else
+        {
+            std::ofstream l_output(l_file_json);
+            WriteJson(l_output, l_results, l_num_warmup, l_num_repetitions);
+        }
+
+    }
+
+    if (l_file_baseline != nullptr && CompareWithBaseline(std::cout, l_results, l_baseline, l_tolerance) != 0)
+    { return 2; }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include"../SudokuBoard.h"
+
+
+/*
+* The regression tests: each test returns whether it passed, and the program's exit code is the number that failed.
+* It's built from this file and the sources of the solver (every .cpp file of the parent directory except Main.cpp).
+*/
+
+
+/* Fills p_board with a solved grid, then empties every third cell.
+
+* Notes:
+    (a). The pattern of the solved grid depends on which dimension of the box spans the rows, so both are tried.
+*/
+static bool MakePuzzle(SudokuBoard& p_board)
+{
+    const unsigned int l_width_box = p_board.GetWidthBox();
+    const unsigned int l_height_box = p_board.GetHeightBox();
+    const unsigned int l_size_grid = p_board.GetSizeGrid();
+
+    // (a).
+    for (unsigned int l_band : { l_height_box, l_width_box })
+    {
+        const unsigned int l_stack = l_size_grid / l_band;
+
+        for (unsigned int row = 0; row < l_size_grid; ++row)
+        {
+            for (unsigned int col = 0; col < l_size_grid; ++col)
+            {
+                p_board.SetValue(row, col, (row * l_stack + row / l_band + col) % l_size_grid + 1);
+            }
+        }
+
+        if (p_board.IsSolved())
+        { break; }
+    }
+
+    if (!p_board.IsSolved())
+    { return false; }
+
+    for (unsigned int row = 0; row < l_size_grid; ++row)
+    {
+        for (unsigned int col = 0; col < l_size_grid; ++col)
+        {
+            if ((row + col) % 3 == 0)
+            { p_board.SetValue(row, col, 0); }
+        }
+    }
+
+    return true;
+}
+
+/*
+* Boxes whose dimensions once collided in the key of FixedSizeSolverBase::Create were given a specialisation of the
+  wrong shape, which reported their puzzles as having no solution.
+*/
+static bool TestUnspecialisedBoxes()
+{
+    const unsigned int l_boxes[][2] = { { 1, 10 }, { 2, 10 }, { 2, 11 }, { 3, 11 } };
+
+    bool l_passed = true;
+
+    for (const auto& l_box : l_boxes)
+    {
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+            SudokuBoard l_board(l_box[i], l_box[1 - i]);
+
+            if (!MakePuzzle(l_board) || !l_board.Solve() || !l_board.IsSolved())
+            {
+                std::cerr << "Failed to solve a puzzle with " << l_box[i] << "x" << l_box[1 - i] << " boxes.\n";
+                l_passed = false;
+            }
+        }
+    }
+
+    return l_passed;
+}
+
+/*
+* operator>> must leave the rest of the stream unread, so that boards can be read from it one after another, in
+  either format.
+*/
+static bool TestReadBoardsBackToBack()
+{
+    std::istringstream l_input(
+        "2 2\n"
+        "0 0  4 3\n"
+        "0 0  0 0\n"
+        "\n"
+        "0 0  0 0\n"
+        "2 3  0 0\n"
+        "2 2\n"
+        "1 0  0 0\n"
+        "0 0  0 2\n"
+        "0 3  0 0\n"
+        "0 0  4 0\n"
+        "..3.4.............1.......5.........................................6............\n");
+
+    SudokuBoard l_first, l_second, l_third;
+    l_input >> l_first >> l_second >> l_third;
+
+    return l_input && l_first.GetSizeGrid() == 4 && l_first.GetValue(0, 2) == 4 && l_first.GetValue(3, 1) == 3 &&
+           l_second.GetSizeGrid() == 4 && l_second.GetValue(0, 0) == 1 && l_second.GetValue(3, 2) == 4 &&
+           l_third.GetSizeGrid() == 9 && l_third.GetValue(0, 2) == 3 && l_third.GetValue(7, 5) == 6;
+}
+
+
+int main()
+{
+    struct Test
+    {
+        const char* name;
+        bool (*run)();
+    };
+
+    const Test l_tests[] =
+    {
+        { "unspecialised-boxes", TestUnspecialisedBoxes },
+        { "read-boards-back-to-back", TestReadBoardsBackToBack },
+    };
+
+    int l_num_failed = 0;
+
+    for (const Test& l_test : l_tests)
+    {
+        const bool l_passed = l_test.run();
+        std::cout << (l_passed ? "PASS " : "FAIL ") << l_test.name << "\n";
+
+        if (!l_passed)
+        { ++l_num_failed; }
+    }
+
+    return l_num_failed;
+}